@@ -52,6 +52,7 @@ Page {
                 anchors.centerIn: parent
                 width: 130
                 height: 130
+                sourceSize: Qt.size(130, 130)
                 source: eClass.callSignInsigniaImage
                 MouseArea {
                     anchors.fill: parent
@@ -206,7 +207,7 @@ Page {
 
     }
 
-    /* Contacts: 10 peer */
+    /* Contacts: one button per peer in eClass.peerModel */
     Frame {
         id: contactButtonFrame
         anchors.top: statusTextFrame.bottom
@@ -221,418 +222,71 @@ Page {
             radius: 2
         }
 
-        // --- First row ---
-        Button {
-            id: contactOneButton
+        // --- Contacts, three per row, scrolls when roster exceeds four rows ---
+        GridView {
+            id: contactGrid
             x: 0
             y: 0
-            width: 65
-            height: 20
-            text: eClass.peer_0_Name
-            font.pointSize: 8
-            checkable: false
-            enabled: eClass.button_0_active
-            onClicked: {
-                eClass.connectButton(0)
-                eClass.registerTouch()
-            }
-            contentItem: Text {
-                text: parent.text
-                font: parent.font
-                opacity: enabled ? 1.0 : 0.3
-                color: eClass.peer_0_NameColor
-                horizontalAlignment: Text.AlignHCenter
-                verticalAlignment: Text.AlignVCenter
-                elide: Text.ElideRight
-            }
-            background: Rectangle {
-                anchors.fill: parent
-                color: parent.down ? eClass.highColor : "#000" // "#141" : "#000"
-                opacity: enabled ? 1 : 0.3
-                border.color: eClass.mainColor // parent.down ? "#0F0" : "#0D0"
-                radius: 2
-            }
-        }
-        Label {
-            id: contactOneStatusLabel
-            x: 0
-            y: 22
-            width: 65
-            height: 5
-            visible: eClass.peer_0_label
-            background: Rectangle {
-                anchors.fill: parent
-                color: eClass.peer_0_label_color
-            }
-        }
-
-        Button {
-            id: contactTwoButton
-            x: 75
-            y: 0
-            width: 65
-            height: 20
-            text: eClass.peer_1_Name
-            font.pointSize: 8
-            checkable: false
-            enabled: eClass.button_1_active
-            onClicked: {
-                eClass.connectButton(1)
-                eClass.registerTouch()
-            }
-            contentItem: Text {
-                text: parent.text
-                font: parent.font
-                opacity: enabled ? 1.0 : 0.3
-                color: eClass.peer_1_NameColor
-                horizontalAlignment: Text.AlignHCenter
-                verticalAlignment: Text.AlignVCenter
-                elide: Text.ElideRight
-            }
-            background: Rectangle {
-                anchors.fill: parent
-                color: parent.down ? eClass.highColor : "#000"
-                opacity: enabled ? 1 : 0.3
-                border.color: eClass.mainColor
-                border.width: 1
-                radius: 2
-            }
-        }
-        Label {
-            id: contactTwoStatusLabel
-            x: 75
-            y: 22
-            width: 65
-            height: 5
-            visible: eClass.peer_1_label
-            background: Rectangle {
-                anchors.fill: parent
-                color: eClass.peer_1_label_color
-            }
-        }
-
-        Button {
-            id: contactThreeButton
-            x: 150
-            y: 0
-            width: 65
-            height: 20
-            text: eClass.peer_2_Name
-            font.pointSize: 8
-            checkable: false
-            enabled: eClass.button_2_active
-            onClicked: {
-                eClass.connectButton(2)
-                eClass.registerTouch()
-            }
-            contentItem: Text {
-                text: parent.text
-                font: parent.font
-                opacity: enabled ? 1.0 : 0.3
-                color: eClass.peer_2_NameColor
-                horizontalAlignment: Text.AlignHCenter
-                verticalAlignment: Text.AlignVCenter
-                elide: Text.ElideRight
-            }
-            background: Rectangle {
-                anchors.fill: parent
-                color: parent.down ? eClass.highColor : "#000"
-                opacity: enabled ? 1 : 0.3
-                border.color: eClass.mainColor
-                border.width: 1
-                radius: 2
-            }
-        }
-        Label {
-            id: contactThreeStatusLabel
-            x: 150
-            y: 22
-            width: 65
-            height: 5
-            visible: eClass.peer_2_label
-            background: Rectangle {
-                anchors.fill: parent
-                color: eClass.peer_2_label_color
-            }
-        }
-
-        // --- Second row ---
-        Button {
-            id: contactFourButton
-            x: 0
-            y: 35
-            width: 65
-            height: 20
-            text: eClass.peer_3_Name
-            font.pointSize: 8
-            checkable: false
-            enabled: eClass.button_3_active
-            onClicked: {
-                eClass.connectButton(3)
-                eClass.registerTouch()
-            }
-            contentItem: Text {
-                text: parent.text
-                font: parent.font
-                opacity: enabled ? 1.0 : 0.3
-                color: eClass.peer_3_NameColor
-                horizontalAlignment: Text.AlignHCenter
-                verticalAlignment: Text.AlignVCenter
-                elide: Text.ElideRight
-            }
-            background: Rectangle {
-                anchors.fill: parent
-                color: parent.down ? eClass.highColor : "#000"
-                opacity: enabled ? 1 : 0.3
-                border.color: eClass.mainColor
-                border.width: 1
-                radius: 2
-            }
-        }
-        Label {
-            id: contactFourStatusLabel
-            x: 0
-            y: 57
-            width: 65
-            height: 5
-            visible: eClass.peer_3_label
-            background: Rectangle {
-                anchors.fill: parent
-                color: eClass.peer_3_label_color
-            }
-        }
-
-        Button {
-            id: contactFiveButton
-            x: 75
-            y: 35
-            width: 65
-            height: 20
-            text: eClass.peer_4_Name
-            font.pointSize: 8
-            checkable: false
-            enabled: eClass.button_4_active
-            onClicked: {
-                eClass.connectButton(4)
-                eClass.registerTouch()
-            }
-            contentItem: Text {
-                text: parent.text
-                font: parent.font
-                opacity: enabled ? 1.0 : 0.3
-                color: eClass.peer_4_NameColor
-                horizontalAlignment: Text.AlignHCenter
-                verticalAlignment: Text.AlignVCenter
-                elide: Text.ElideRight
-            }
-            background: Rectangle {
-                anchors.fill: parent
-                color: parent.down ? eClass.highColor : "#000"
-                opacity: enabled ? 1 : 0.3
-                border.color: eClass.mainColor
-                border.width: 1
-                radius: 2
-            }
-        }
-        Label {
-            id: contactFiveStatusLabel
-            x: 75
-            y: 57
-            width: 65
-            height: 5
-            visible: eClass.peer_4_label
-            background: Rectangle {
-                anchors.fill: parent
-                color: eClass.peer_4_label_color
-            }
-        }
-
-        Button {
-            id: contactSixButton
-            x: 150
-            y: 35
-            width: 65
-            height: 20
-            text: eClass.peer_5_Name
-            font.pointSize: 8
-            checkable: false
-            enabled: eClass.button_5_active
-            onClicked: {
-                eClass.connectButton(5)
-                eClass.registerTouch()
-            }
-            contentItem: Text {
-                text: parent.text
-                font: parent.font
-                opacity: enabled ? 1.0 : 0.3
-                color: eClass.peer_5_NameColor
-                horizontalAlignment: Text.AlignHCenter
-                verticalAlignment: Text.AlignVCenter
-                elide: Text.ElideRight
-            }
-            background: Rectangle {
-                anchors.fill: parent
-                color: parent.down ? eClass.highColor : "#000"
-                opacity: enabled ? 1 : 0.3
-                border.color: eClass.mainColor
-                border.width: 1
-                radius: 2
-            }
-        }
-        Label {
-            id: contactSixStatusLabel
-            x: 150
-            y: 57
-            width: 65
-            height: 5
-            visible: eClass.peer_5_label
-            background: Rectangle {
-                anchors.fill: parent
-                color: eClass.peer_5_label_color
-            }
-        }
-
-        // --- Third row ---
-        Button {
-            id: contactSevenButton
-            x: 0
-            y: 70
-            width: 65
-            height: 20
-            text: eClass.peer_6_Name
-            font.pointSize: 8
-            checkable: false
-            enabled: eClass.button_6_active
-            onClicked: {
-                eClass.connectButton(6)
-                eClass.registerTouch()
-            }
-            contentItem: Text {
-                text: parent.text
-                font: parent.font
-                opacity: enabled ? 1.0 : 0.3
-                color: eClass.peer_6_NameColor
-                horizontalAlignment: Text.AlignHCenter
-                verticalAlignment: Text.AlignVCenter
-                elide: Text.ElideRight
-            }
-            background: Rectangle {
-                anchors.fill: parent
-                color: parent.down ? eClass.highColor : "#000"
-                opacity: enabled ? 1 : 0.3
-                border.color: eClass.mainColor
-                border.width: 1
-                radius: 2
-            }
-        }
-        Label {
-            id: contactSevenStatusLabel
-            x: 0
-            y: 92
-            width: 65
-            height: 5
-            visible: eClass.peer_6_label
-            background: Rectangle {
-                anchors.fill: parent
-                color: eClass.peer_6_label_color
-            }
-        }
-
-        Button {
-            id: contactEightButton
-            x: 75
-            y: 70
-            width: 65
-            height: 20
-            text: eClass.peer_7_Name
-            font.pointSize: 8
-            checkable: false
-            enabled: eClass.button_7_active
-            onClicked: {
-                eClass.connectButton(7)
-                eClass.registerTouch()
-            }
-            contentItem: Text {
-                text: parent.text
-                font: parent.font
-                opacity: enabled ? 1.0 : 0.3
-                color: eClass.peer_7_NameColor
-                horizontalAlignment: Text.AlignHCenter
-                verticalAlignment: Text.AlignVCenter
-                elide: Text.ElideRight
-            }
-            background: Rectangle {
-                anchors.fill: parent
-                color: parent.down ? eClass.highColor : "#000"
-                opacity: enabled ? 1 : 0.3
-                border.color: eClass.mainColor
-                border.width: 1
-                radius: 2
-            }
-        }
-        Label {
-            id: contactEightStatusLabel
-            x: 75
-            y: 92
-            width: 65
-            height: 5
-            visible: eClass.peer_7_label
-            background: Rectangle {
-                anchors.fill: parent
-                color: eClass.peer_7_label_color
-            }
-        }
-
-        Button {
-            id: contactNineButton
-            x: 150
-            y: 70
-            width: 65
-            height: 20
-            text: eClass.peer_8_Name
-            font.pointSize: 8
-            checkable: false
-            enabled: eClass.button_8_active
-            onClicked: {
-                eClass.connectButton(8)
-                eClass.registerTouch()
-            }
-            contentItem: Text {
-                text: parent.text
-                font: parent.font
-                opacity: enabled ? 1.0 : 0.3
-                color: eClass.peer_8_NameColor
-                horizontalAlignment: Text.AlignHCenter
-                verticalAlignment: Text.AlignVCenter
-                elide: Text.ElideRight
-            }
-            background: Rectangle {
-                anchors.fill: parent
-                color: parent.down ? eClass.highColor : "#000"
-                opacity: enabled ? 1 : 0.3
-                border.color: eClass.mainColor
-                border.width: 1
-                radius: 2
-            }
-        }
-        Label {
-            id: contactNineStatusLabel
-            x: 150
-            y: 92
-            width: 65
-            height: 5
-            visible: eClass.peer_8_label
-            background: Rectangle {
-                anchors.fill: parent
-                color: eClass.peer_8_label_color
+            width: 225
+            height: 140
+            cellWidth: 75
+            cellHeight: 35
+            clip: true
+            boundsBehavior: Flickable.StopAtBounds
+            model: eClass.peerModel
+            delegate: Item {
+                width: 65
+                height: 30
+                Button {
+                    id: contactButton
+                    x: 0
+                    y: 0
+                    width: 65
+                    height: 20
+                    text: model.name
+                    font.pointSize: 8
+                    checkable: false
+                    enabled: model.active
+                    onClicked: {
+                        eClass.connectButton(index)
+                        eClass.registerTouch()
+                    }
+                    contentItem: Text {
+                        text: parent.text
+                        font: parent.font
+                        opacity: enabled ? 1.0 : 0.3
+                        color: model.nameColor
+                        horizontalAlignment: Text.AlignHCenter
+                        verticalAlignment: Text.AlignVCenter
+                        elide: Text.ElideRight
+                    }
+                    background: Rectangle {
+                        anchors.fill: parent
+                        color: parent.down ? eClass.highColor : "#000"
+                        opacity: enabled ? 1 : 0.3
+                        border.color: eClass.mainColor
+                        radius: 2
+                    }
+                }
+                Label {
+                    x: 0
+                    y: 22
+                    width: 65
+                    height: 5
+                    visible: model.label
+                    background: Rectangle {
+                        anchors.fill: parent
+                        color: model.labelColor
+                    }
+                }
             }
         }
 
-        // --- Fourth row ---
+        // --- Command row ---
         Button {
             id: goSecureButton
             x: 0
-            y: 105
+            y: 140
             width: 65
             height: 25
             text: qsTr("Go Sec")
@@ -662,56 +316,10 @@ Page {
             }
         }
 
-        // --- Contact ten button ---
-        Button {
-            id: contactTenButton
-            x: 75
-            y: 105
-            width: 65
-            height: 20
-            text: eClass.peer_9_Name
-            font.pointSize: 8
-            checkable: false
-            enabled: eClass.button_9_active
-            onClicked: {
-                eClass.connectButton(9)
-                eClass.registerTouch()
-            }
-            contentItem: Text {
-                text: parent.text
-                font: parent.font
-                opacity: enabled ? 1.0 : 0.3
-                color: eClass.peer_9_NameColor
-                horizontalAlignment: Text.AlignHCenter
-                verticalAlignment: Text.AlignVCenter
-                elide: Text.ElideRight
-            }
-            background: Rectangle {
-                anchors.fill: parent
-                color: parent.down ? eClass.highColor : "#000"
-                opacity: enabled ? 1 : 0.3
-                border.color: eClass.mainColor
-                border.width: 1
-                radius: 2
-            }
-        }
-        Label {
-            id: contactTenStatusLabel
-            x: 75
-            y: 127
-            width: 65
-            height: 5
-            visible: eClass.peer_9_label
-            background: Rectangle {
-                anchors.fill: parent
-                color: eClass.peer_9_label_color
-            }
-        }
-
         Button {
             id: msgSecureButton
-            x: 150
-            y: 105
+            x: 75
+            y: 140
             width: 65
             height: 25
             text: qsTr("Message")
@@ -741,11 +349,9 @@ Page {
 
         Button {
             id: terminateButton
-            x: 0
+            x: 150
             y: 140
-            width: parent.width
-            Component.onCompleted: {
-            }
+            width: 65
 
             height: 25
             text: qsTr("Terminate")
@@ -753,7 +359,8 @@ Page {
             checkable: false
             onClicked: {
                 eClass.disconnectButton()
-                pageTwo.messageInput = ""
+                if ( pageTwoLoader.item )
+                    pageTwoLoader.item.messageInput = ""
                 eClass.registerTouch()
             }
             contentItem: Text {
@@ -856,7 +463,7 @@ Page {
         anchors.top: contactButtonFrame.top
         anchors.left: contactButtonFrame.left
         anchors.right: contactButtonFrame.right
-        height: 150
+        height: contactGrid.height + topPadding + bottomPadding
         visible: false
         background: Rectangle {
             color: "#000000"
@@ -866,157 +473,46 @@ Page {
             radius: 2
         }
 
-        Rectangle {
-            id: contactOnePersetangeLabel
-            x: 0
-            y: 0
-            width: 65
-            height: 20
-            color: "transparent"
-            Text {
-                anchors.centerIn: parent
-                horizontalAlignment: Text.AlignHCenter
-                text: eClass.peer_0_keyPercentage
-                font.pointSize: 10
-                color: eClass.mainColor
-            }
-        }
-
-        Rectangle {
-            id: contactTwoPersetangeLabel
-            x: 75
-            y: 0
-            width: 65
-            height: 20
-            color: "transparent"
-            Text {
-                anchors.centerIn: parent
-                horizontalAlignment: Text.AlignHCenter
-                text: eClass.peer_1_keyPercentage
-                font.pointSize: 8
-                color: eClass.mainColor
-            }
-        }
-
-        Rectangle {
-            id: contactThreePersetangeLabel
-            x: 150
-            y: 0
-            width: 65
-            height: 20
-            color: "transparent"
-            Text {
-                anchors.centerIn: parent
-                horizontalAlignment: Text.AlignHCenter
-                text: eClass.peer_2_keyPercentage
-                font.pointSize: 8
-                color: eClass.mainColor
-            }
-        }
-        Rectangle {
-            id: contactFourPersetangeLabel
-            x: 0
-            y: 35
-            width: 65
-            height: 20
-            color: "transparent"
-            Text {
-                anchors.centerIn: parent
-                horizontalAlignment: Text.AlignHCenter
-                text: eClass.peer_3_keyPercentage
-                font.pointSize: 8
-                color: eClass.mainColor
-            }
-        }
-        Rectangle {
-            id: contactFivePersetangeLabel
-            x: 75
-            y: 35
-            width: 65
-            height: 20
-            color: "transparent"
-            Text {
-                anchors.centerIn: parent
-                horizontalAlignment: Text.AlignHCenter
-                text: eClass.peer_4_keyPercentage
-                font.pointSize: 8
-                color: eClass.mainColor
-            }
-        }
-        Rectangle {
-            id: contactSixPersetangeLabel
-            x: 150
-            y: 35
-            width: 65
-            height: 20
-            color: "transparent"
-            Text {
-                anchors.centerIn: parent
-                horizontalAlignment: Text.AlignHCenter
-                text: eClass.peer_5_keyPercentage
-                font.pointSize: 8
-                color: eClass.mainColor
-            }
-        }
-        // ROW 3
-        Rectangle {
-            id: contactSevenPersetangeLabel
-            x: 0
-            y: 70
-            width: 65
-            height: 20
-            color: "transparent"
-            Text {
-                anchors.centerIn: parent
-                horizontalAlignment: Text.AlignHCenter
-                text: eClass.peer_6_keyPercentage
-                font.pointSize: 8
-                color: eClass.mainColor
-            }
-        }
-        Rectangle {
-            id: contactEightPersetangeLabel
-            x: 75
-            y: 70
-            width: 65
-            height: 20
-            color: "transparent"
-            Text {
-                anchors.centerIn: parent
-                horizontalAlignment: Text.AlignHCenter
-                text: eClass.peer_7_keyPercentage
-                font.pointSize: 8
-                color: eClass.mainColor
-            }
-        }
-        Rectangle {
-            id: contactNinePersetangeLabel
-            x: 150
-            y: 70
-            width: 65
-            height: 20
-            color: "transparent"
-            Text {
-                anchors.centerIn: parent
-                horizontalAlignment: Text.AlignHCenter
-                text: eClass.peer_8_keyPercentage
-                font.pointSize: 8
-                color: eClass.mainColor
-            }
-        }
-        Rectangle {
-            id: contactTenPersetangeLabel
-            x: 75
-            y: 105
-            width: 65
-            height: 20
-            color: "transparent"
-            Text {
-                anchors.centerIn: parent
-                horizontalAlignment: Text.AlignHCenter
-                text: eClass.peer_9_keyPercentage
-                font.pointSize: 8
-                color: eClass.mainColor
+        GridView {
+            x: contactGrid.x
+            y: contactGrid.y
+            width: contactGrid.width
+            height: contactGrid.height
+            cellWidth: contactGrid.cellWidth
+            cellHeight: contactGrid.cellHeight
+            clip: true
+            interactive: false
+            contentY: contactGrid.contentY
+            model: eClass.peerModel
+            delegate: Rectangle {
+                width: 65
+                height: 20
+                color: "transparent"
+                Text {
+                    anchors.centerIn: parent
+                    horizontalAlignment: Text.AlignHCenter
+                    text: model.keyPercentage
+                    font.pointSize: 8
+                    color: eClass.mainColor
+                }
+                // median/p95 latency and loss of last probes
+                Text {
+                    anchors.top: parent.bottom
+                    anchors.horizontalCenter: parent.horizontalCenter
+                    horizontalAlignment: Text.AlignHCenter
+                    text: model.linkQuality
+                    font.pointSize: 6
+                    color: model.loss > 0 ? "#FFFF00" : eClass.dimColor
+                }
+                // talk time and messages left on pad at observed rate
+                Text {
+                    anchors.bottom: parent.top
+                    anchors.horizontalCenter: parent.horizontalCenter
+                    horizontalAlignment: Text.AlignHCenter
+                    text: model.keyForecast
+                    font.pointSize: 6
+                    color: model.talkTimeLeft >= 0 && model.talkTimeLeft < 600 ? "#FFFF00" : eClass.dimColor
+                }
             }
         }
     }
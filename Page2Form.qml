@@ -4,7 +4,6 @@ import QtQuick.Controls.Styles 1.4
 import QtQuick.Layouts 1.3
 
 Page {
-    property alias messageHistory: msgHistory.text
     property alias messageInput: lineInput.text
     property alias msgHistory: msgHistory
 
@@ -92,31 +91,27 @@ Page {
                 }
             }
 
-            Flickable {
-                id: textScrollView
+            ListView {
+                id: msgHistory
                 anchors.fill: parent
-                width: 240
+                anchors.margins: 4
                 clip: true
-                flickableDirection: Flickable.VerticalFlick
+                spacing: 6
+                model: eClass.messageModel
+                boundsBehavior: Flickable.DragAndOvershootBounds
                 ScrollBar.vertical: ScrollBar {
                     id: flickScroll
                 }
-                boundsBehavior: Flickable.DragAndOvershootBounds
-
-                TextArea.flickable: TextArea {
-                    id: msgHistory
-                    textFormat: TextEdit.RichText
-                    width: 240
-                    text: eClass.textMsgDisplay
+                delegate: Text {
+                    width: msgHistory.width - flickScroll.width
+                    text: model.text
+                    textFormat: Text.PlainText
                     font.family: "DejaVu"
                     font.pointSize: 8
-                    color: eClass.mainColor
-                    readOnly: true
-                    wrapMode: Text.WordWrap
-                    onContentSizeChanged: {
-                        msgHistory.cursorPosition = msgHistory.length - 1
-                    }
+                    color: model.direction === "local" ? eClass.dimColor : eClass.mainColor
+                    wrapMode: Text.Wrap
                 }
+                onCountChanged: positionViewAtEnd()
             }
         } // rectangle
     }
@@ -1,5 +1,5 @@
 import QtQuick 2.15
-import QtQuick.Controls 2.5
+import QtQuick.Controls 2.15
 import QtQuick.Controls.Styles 1.4
 import QtQuick.Layouts 1.3
 
@@ -114,7 +114,9 @@ Page {
 
             ComboBox {
                 id: control
-                model: eClass.wifiNetworks
+                model: eClass.wifiNetworkModel
+                textRole: "ssid"
+                valueRole: "ssid"
                 font.pointSize: 8
                 anchors.top: wifiEraseAllButton.bottom // wifiNotesLabel.bottom
                 anchors.topMargin: 10
@@ -127,8 +129,9 @@ Page {
                 delegate: ItemDelegate {
                     width: control.width
                     contentItem: Text {
-                        text: modelData
-                        color: eClass.mainColor
+                        text: ssid + (strength >= 0 ? " " + strength + "%" : "")
+                              + (security === "" || security === "open" ? "" : " *")
+                        color: connected ? eClass.highColor : eClass.mainColor
                         font: control.font
                         elide: Text.ElideRight
                         verticalAlignment: Text.AlignVCenter
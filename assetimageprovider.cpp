@@ -0,0 +1,179 @@
+/*
+    small Pinephone QML interface for Out-Of-Band communication.
+
+    Copyright (C) 2023 Resilience Theatre
+
+    This program is free software; you can redistribute it and/or
+    modify it under the terms of the GNU General Public License
+    as published by the Free Software Foundation; either version 2
+    of the License, or (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "assetimageprovider.h"
+#include <QImageReader>
+#include <QDebug>
+
+AssetCache::AssetCache()
+{
+    m_pool.setMaxThreadCount(ASSET_DECODE_THREADS);
+}
+
+/* Responses and prewarms still running refer to this cache */
+AssetCache::~AssetCache()
+{
+    m_pool.waitForDone();
+}
+
+/* Cached image or decode now, blocks so call only off GUI thread */
+QImage AssetCache::image(const QString &name, const QSize &size)
+{
+    QString cacheKey = key(name, size);
+    QMutexLocker locker(&m_mutex);
+    while ( m_decoding.contains(cacheKey) )
+        m_decoded.wait(&m_mutex);
+    auto entry = m_entries.find(cacheKey);
+    if ( entry != m_entries.end() ) {
+        m_hits++;
+        entry->used = ++m_stamp;
+        return entry->image;
+    }
+    m_misses++;
+    m_decoding.insert(cacheKey);
+    locker.unlock();
+    QImage image = decode(name, size);
+    locker.relock();
+    m_decoding.remove(cacheKey);
+    if ( !image.isNull() )
+        insert(cacheKey, image);
+    m_decoded.wakeAll();
+    return image;
+}
+
+void AssetCache::prewarm(const QString &name, const QSize &size)
+{
+    {
+        QMutexLocker locker(&m_mutex);
+        if ( m_entries.contains(key(name, size)) )
+            return;
+    }
+    m_pool.start([this, name, size] { image(name, size); });
+}
+
+QThreadPool *AssetCache::pool()
+{
+    return &m_pool;
+}
+
+qint64 AssetCache::bytes() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_bytes;
+}
+
+quint64 AssetCache::hits() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_hits;
+}
+
+quint64 AssetCache::misses() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_misses;
+}
+
+QString AssetCache::key(const QString &name, const QSize &size)
+{
+    return name + "@" + QString::number(size.width()) + "x" + QString::number(size.height());
+}
+
+/* Decode at display size, an empty or partial size keeps aspect ratio */
+QImage AssetCache::decode(const QString &name, const QSize &size)
+{
+    QImageReader reader(ASSET_RESOURCE_ROOT + name);
+    QSize native = reader.size();
+    if ( native.isValid() && (size.width() > 0 || size.height() > 0) ) {
+        QSize scaled = size;
+        if ( scaled.width() <= 0 )
+            scaled.setWidth(native.width() * scaled.height() / native.height());
+        if ( scaled.height() <= 0 )
+            scaled.setHeight(native.height() * scaled.width() / native.width());
+        reader.setScaledSize(scaled);
+    }
+    QImage image = reader.read();
+    if ( image.isNull() )
+        qWarning() << "Cannot decode asset" << name << reader.errorString();
+    return image;
+}
+
+/* Called with mutex held, evicts least recently used over budget */
+void AssetCache::insert(const QString &key, const QImage &image)
+{
+    Entry entry;
+    entry.image = image;
+    entry.used = ++m_stamp;
+    m_entries.insert(key, entry);
+    m_bytes += image.sizeInBytes();
+    while ( m_bytes > ASSET_CACHE_BYTES && m_entries.size() > 1 ) {
+        auto oldest = m_entries.end();
+        for (auto it = m_entries.begin(); it != m_entries.end(); ++it) {
+            if ( it.key() != key && (oldest == m_entries.end() || it->used < oldest->used) )
+                oldest = it;
+        }
+        m_bytes -= oldest->image.sizeInBytes();
+        m_entries.erase(oldest);
+    }
+}
+
+AssetDecodeTask::AssetDecodeTask(AssetCache *cache, const QString &name, const QSize &size)
+    : m_cache(cache), m_name(name), m_size(size)
+{
+}
+
+void AssetDecodeTask::run()
+{
+    emit decoded(m_cache->image(m_name, m_size));
+}
+
+AssetImageResponse::AssetImageResponse(AssetCache *cache, const QString &name, const QSize &size)
+    : m_name(name)
+{
+    /* Queued connection is dropped with response if QML cancels request */
+    AssetDecodeTask *task = new AssetDecodeTask(cache, name, size);
+    connect(task, &AssetDecodeTask::decoded, this, &AssetImageResponse::imageDecoded, Qt::QueuedConnection);
+    cache->pool()->start(task);
+}
+
+QQuickTextureFactory *AssetImageResponse::textureFactory() const
+{
+    return QQuickTextureFactory::textureFactoryForImage(m_image);
+}
+
+QString AssetImageResponse::errorString() const
+{
+    return m_image.isNull() ? "Cannot decode " + m_name : QString();
+}
+
+void AssetImageResponse::imageDecoded(const QImage &image)
+{
+    m_image = image;
+    emit finished();
+}
+
+AssetImageProvider::AssetImageProvider(AssetCache *cache)
+    : m_cache(cache)
+{
+}
+
+QQuickImageResponse *AssetImageProvider::requestImageResponse(const QString &id, const QSize &requestedSize)
+{
+    return new AssetImageResponse(m_cache, id, requestedSize);
+}
@@ -0,0 +1,123 @@
+/*  Small Pine phone QML interface for Out-Of-Band communication.
+
+    Copyright (C) 2023 Resilience Theatre
+
+    This program is free software; you can redistribute it and/or
+    modify it under the terms of the GNU General Public License
+    as published by the Free Software Foundation; either version 2
+    of the License, or (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; If not, see <http://www.gnu.org/licenses/>.
+
+*/
+#ifndef ASSETIMAGEPROVIDER_H
+#define ASSETIMAGEPROVIDER_H
+#include <QQuickAsyncImageProvider>
+#include <QThreadPool>
+#include <QMutex>
+#include <QWaitCondition>
+#include <QHash>
+#include <QSet>
+#include <QImage>
+
+#define ASSET_PROVIDER_ID       "assets"
+#define ASSET_URL_PREFIX        "image://assets/"
+#define ASSET_RESOURCE_ROOT     ":/"
+#define ASSET_CACHE_BYTES       (12 * 1024 * 1024)  // decoded images kept, lock and camo screen fit
+#define ASSET_DECODE_THREADS    1
+
+/*
+    Decoded image cache behind the QML asset provider. Images are
+    decoded from resources straight to display size given as Image
+    sourceSize, least recently used ones are dropped over byte budget.
+    Decode of same image and size is done once, concurrent requests
+    wait for it. Thread safe, prewarm() decodes on own pool so a
+    screen can be ready before it is shown.
+*/
+class AssetCache
+{
+public:
+    AssetCache();
+    ~AssetCache();
+    QImage image(const QString &name, const QSize &size);
+    void prewarm(const QString &name, const QSize &size);
+    QThreadPool *pool();
+    qint64 bytes() const;
+    quint64 hits() const;
+    quint64 misses() const;
+
+private:
+    struct Entry
+    {
+        QImage image;
+        quint64 used=0;     // LRU stamp
+    };
+    static QString key(const QString &name, const QSize &size);
+    static QImage decode(const QString &name, const QSize &size);
+    void insert(const QString &key, const QImage &image);
+
+    mutable QMutex m_mutex;
+    QWaitCondition m_decoded;
+    QHash<QString, Entry> m_entries;
+    QSet<QString> m_decoding;
+    qint64 m_bytes=0;
+    quint64 m_stamp=0;
+    quint64 m_hits=0;
+    quint64 m_misses=0;
+    QThreadPool m_pool;
+};
+
+/* Decode on cache pool, result is queued to response on GUI thread */
+class AssetDecodeTask : public QObject, public QRunnable
+{
+    Q_OBJECT
+
+public:
+    AssetDecodeTask(AssetCache *cache, const QString &name, const QSize &size);
+    void run() override;
+
+signals:
+    void decoded(const QImage &image);
+
+private:
+    AssetCache *m_cache;
+    QString m_name;
+    QSize m_size;
+};
+
+/* One image request, may be deleted by QML before decode is done */
+class AssetImageResponse : public QQuickImageResponse
+{
+    Q_OBJECT
+
+public:
+    AssetImageResponse(AssetCache *cache, const QString &name, const QSize &size);
+    QQuickTextureFactory *textureFactory() const override;
+    QString errorString() const override;
+
+private slots:
+    void imageDecoded(const QImage &image);
+
+private:
+    QString m_name;
+    QImage m_image;
+};
+
+/* image://assets/<resource name>, cache is owned by engineClass */
+class AssetImageProvider : public QQuickAsyncImageProvider
+{
+public:
+    explicit AssetImageProvider(AssetCache *cache);
+    QQuickImageResponse *requestImageResponse(const QString &id, const QSize &requestedSize) override;
+
+private:
+    AssetCache *m_cache;
+};
+
+#endif // ASSETIMAGEPROVIDER_H
@@ -0,0 +1,58 @@
+# Engine sources shared by application and tests/bench
+
+QT += qml quick dbus
+
+CONFIG += c++17
+
+LIBS += -lasound
+
+INCLUDEPATH += $$PWD
+
+# qmake CONFIG+=tracing: span macros of trace.h record, SIGUSR1 dumps Chrome trace
+tracing: DEFINES += QTUI_TRACING
+
+SOURCES += \
+    $$PWD/engineclass.cpp \
+    $$PWD/assetimageprovider.cpp \
+    $$PWD/fiforeader.cpp \
+    $$PWD/fiforecorder.cpp \
+    $$PWD/fifowriter.cpp \
+    $$PWD/hardwarecontrol.cpp \
+    $$PWD/iwdclient.cpp \
+    $$PWD/keyusage.cpp \
+    $$PWD/latencyprober.cpp \
+    $$PWD/messagemodel.cpp \
+    $$PWD/mixercontrol.cpp \
+    $$PWD/netlinkmonitor.cpp \
+    $$PWD/peermodel.cpp \
+    $$PWD/processexecutor.cpp \
+    $$PWD/sensorsampler.cpp \
+    $$PWD/startuppipeline.cpp \
+    $$PWD/statuswatcher.cpp \
+    $$PWD/tickscheduler.cpp \
+    $$PWD/trace.cpp \
+    $$PWD/wifinetworkmodel.cpp
+
+HEADERS += \
+    $$PWD/engineclass.h \
+    $$PWD/assetimageprovider.h \
+    $$PWD/fifoprotocol.h \
+    $$PWD/fiforeader.h \
+    $$PWD/fiforecorder.h \
+    $$PWD/fifowriter.h \
+    $$PWD/hardwarecontrol.h \
+    $$PWD/iwdclient.h \
+    $$PWD/keyusage.h \
+    $$PWD/latencyprober.h \
+    $$PWD/messagemodel.h \
+    $$PWD/mixercontrol.h \
+    $$PWD/netlinkmonitor.h \
+    $$PWD/peermodel.h \
+    $$PWD/processexecutor.h \
+    $$PWD/propertycell.h \
+    $$PWD/sensorsampler.h \
+    $$PWD/startuppipeline.h \
+    $$PWD/statuswatcher.h \
+    $$PWD/tickscheduler.h \
+    $$PWD/trace.h \
+    $$PWD/wifinetworkmodel.h
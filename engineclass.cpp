@@ -18,7 +18,9 @@
 
     TODO:
     ---------------------------------------------------------------------
-    [ ]     Wifi SSID's with spaces do not work
+    [ ]     Wifi SSID's with spaces do not work on non-iwd fallback when
+            /opt/tunnel/wifi_getnetworks.sh prints them space separated,
+            script should print one SSID per line
 
     NOTE:   If you turn LTE modem off with DIP switches, adjust /root/utils/cell.sh
             because it might block if modem is non reachable.
@@ -41,13 +43,15 @@
 */
 
 #include "engineclass.h"
+#include "trace.h"
 #include <QDebug>
 #include <QFile>
-#include <QFileSystemWatcher>
 #include <QProcess>
 #include <QCoreApplication>
 #include <QTimer>
 #include <QSettings>
+#include <QGuiApplication>
+#include <QScreen>
 #include <QQmlEngine>
 #include <QQmlComponent>
 #include <fcntl.h>
@@ -59,35 +63,64 @@
 #define TELEMETRY_FIFO_IN       "/tmp/telemetry_fifo_in"
 #define TELEMETRY_FIFO_OUT      "/tmp/telemetry_fifo_out"
 #define MESSAGE_RECEIVE_FIFO    "/tmp/message_fifo_out"
-#define NODECOUNT               10
+#define CLIENT_CALL_ACTIVE_FILE "/tmp/CLIENT_CALL_ACTIVE"
 #define CONNPOINTCOUNT          3
 #define INDICATE_ONLY           0
 #define LOG_ONLY                1
 #define LOG_AND_INDICATE        2
-#define SETTINGS_INI_FILE       "/opt/tunnel/sinm.ini"
 #define SUBSTITUTE_CHAR_CODE    24
 #define PWR_GPIO_INPUT_PATH     "/dev/input/by-path/platform-1f03400.rsb-platform-axp221-pek-event"
 #define VOL_GPIO_INPUT_PATH     "/dev/input/by-path/platform-1c21800.lradc-event"
 #define HF_PLUG_GPIO_INPUT_PATH "/dev/input/by-path/platform-sound-event"
-#define BATTERY_CAPACITY_PATH   "/sys/class/power_supply/axp20x-battery/capacity"
-#define BATTERY_CURRENT_PATH    "/sys/class/power_supply/axp20x-battery/current_now"
-#define BATTERY_STATUS_PATH     "/sys/class/power_supply/axp20x-battery/status"
-#define PROXIMITY_SENSOR_PATH   "/sys/devices/platform/soc/1c2b000.i2c/i2c-1/1-0048/iio:device1/in_proximity_raw"
-#define PROXIMITY_SENSOR_PATH_2 "/sys/devices/platform/soc/1c2b000.i2c/i2c-1/1-0048/iio:device2/in_proximity_raw"
 #define LOCK_DEVICE             true
 #define UNLOCK_DEVICE           false
 #define DEVICE_LOCK_TIME        120
-#define FIFO_TIMEOUT            1
-#define FIFO_REPLY_RECEIVED     0
+#define FIFO_REPLY_TIMEOUT      10000 // 10 s
 #define SIDEBUTTON_KEY_UP       0
 #define SIDEBUTTON_KEY_DOWN     1
 #define IWD_MAIN_CONFIG_FILE    "/etc/iwd/main.conf"
 
 #define AUTOMATIC_SHUTDOWNTIME   600000 // 10 min
 #define AUTOMATIC_SHUTDOWNTIME_IN_VAULT_MODE   60000 // 1 min
+#define RING_BLINK_INTERVAL     250
+#define VOLUME_SAVE_DELAY       1000
+#define ENV_INTERVAL            5000
+#define ENV_INTERVAL_IDLE       10000
+#define ENV_INTERVAL_LOCKED     60000
+#define PROXIMITY_INTERVAL      1000
+#define PROBE_INTERVAL          2000
+#define PROBE_INTERVAL_IN_CALL  5000
+
+#define INSIGNIA_SIZE           QSize(130, 130)    // Image sourceSize in Page1Form.qml
+
+/* Insignia per node index, wraps around after juliet */
+static const char *insigniaImages[] = { "alpha.png", "bravo.png", "charlie.png", "delta.png", "echo.png",
+                                        "foxrot.png", "golf.png", "hotel.png", "india.png", "juliet.png" };
+#define INSIGNIA_COUNT          int(sizeof(insigniaImages) / sizeof(insigniaImages[0]))
+
+/* FIFOs, settings, key directory, preferences and input devices under QTUI_FILE_ROOT when set, tests/bench uses it */
+static QString rootedPath(const char *path)
+{
+    return QString::fromLocal8Bit(qgetenv(FILE_ROOT_ENV)) + path;
+}
+
+/* Sysfs root can be pointed to a fake tree with QTUI_SYSFS_ROOT */
+static QByteArray hardwareRoot()
+{
+    QByteArray root = qgetenv(HARDWARE_ROOT_ENV);
+    return root.isEmpty() ? QByteArrayLiteral(HARDWARE_SYSFS_ROOT) : root;
+}
+
+/* Mixer card can be changed or left closed ("none") with QTUI_MIXER_CARD */
+static QByteArray mixerCard()
+{
+    QByteArray card = qgetenv(MIXER_CARD_ENV);
+    return card.isEmpty() ? QByteArrayLiteral(MIXER_CARD) : card;
+}
 
 engineClass::engineClass(QObject *parent)
-    : QObject{parent}
+    : QObject{parent}, m_hardware(hardwareRoot(), QFile::encodeName(rootedPath(VIBRATOR_INPUT_PATH))),
+      m_mixer(mixerCard().constData())
 {
     /* Initial UI colors */
     mMainColor = "#00FF00";
@@ -96,24 +129,72 @@ engineClass::engineClass(QObject *parent)
     emit highColorChanged();
     mDimColor = "#21cc00";
     emit dimColorChanged();
-    mMessageColorLocal = "#FFFFFF";
-    mMessageColorRemote = "#00FF00";
-
-    QTimer::singleShot(2 * 1000, this, SLOT(loadSettings()));
-    QTimer::singleShot(4 * 1000, this, SLOT(initEngine()));
-
-    /* environment and proximity evaluation timers */
-    envTimer = new QTimer();
-    connect(envTimer, &QTimer::timeout, this, QOverload<>::of(&engineClass::envTimerTick));
-    envTimer->start(5000);
-    proximityTimer = new QTimer();
-    connect(proximityTimer, &QTimer::timeout, this, QOverload<>::of(&engineClass::proximityTimerTick));
-    proximityTimer->start(2000);
-    automaticShutdownTimer = new QTimer();
-    connect(automaticShutdownTimer, &QTimer::timeout, this, QOverload<>::of(&engineClass::automaticShutdownTimeout));
+    m_peerModel = new PeerModel(this);
+    m_messageModel = new MessageModel(this);
+    /* Wi-Fi through iwd, QTUI_IWD_BUS=session or a bus address talks to a mock iwd, "none" to nothing */
+    m_wifiNetworkModel = new WifiNetworkModel(this);
+    QString iwdBusAddress = qEnvironmentVariable(IWD_BUS_ENV);
+    QDBusConnection iwdBus = iwdBusAddress.isEmpty() ? QDBusConnection::systemBus()
+                             : iwdBusAddress == "session" ? QDBusConnection::sessionBus()
+                             : iwdBusAddress == IWD_BUS_NONE ? QDBusConnection(IWD_BUS_NONE)
+                             : QDBusConnection::connectToBus(iwdBusAddress, "iwd");
+    m_iwdClient = new IwdClient(m_wifiNetworkModel, iwdBus, this);
+    connect(m_iwdClient, &IwdClient::scanFinished, this, &engineClass::wifiScanFinished);
+    connect(m_iwdClient, &IwdClient::stateChanged, this, &engineClass::wifiStateChanged);
+    connect(m_iwdClient, &IwdClient::connectFailed, this, &engineClass::wifiConnectFailed);
+
+    /* Startup steps run once main() has set vault mode and event loop is up */
+    m_startup = new StartupPipeline(this);
+    connect(m_startup, &StartupPipeline::stepFinished, this, &engineClass::startupTimelineChanged);
+    connect(m_startup, &StartupPipeline::finished, this, &engineClass::startupFinished);
+    QTimer::singleShot(0, this, &engineClass::startup);
+
+    /* Peer link quality, no probes with QTUI_LATENCY_PROBE=off */
+    m_latencyProber = new LatencyProber(this);
+    connect(m_latencyProber, &LatencyProber::statsChanged, this, &engineClass::peerLinkStatsChanged);
+    /* Periodic work, intervals per power state:     LOCKED               IDLE               IN_CALL             SETTINGS */
+    m_scheduler = new TickScheduler(this);
+    m_envJob = m_scheduler->addJob("env", [this] { envTimerTick(); },
+                                   {ENV_INTERVAL_LOCKED, ENV_INTERVAL_IDLE, ENV_INTERVAL, ENV_INTERVAL});
+    m_proximityJob = m_scheduler->addJob("proximity", [this] { proximityTimerTick(); },
+                                   {0, 0, PROXIMITY_INTERVAL, 0});
+    TickScheduler::Intervals probeIntervals = {0, PROBE_INTERVAL, PROBE_INTERVAL_IN_CALL, PROBE_INTERVAL};
+    if ( qEnvironmentVariable(LATENCY_PROBE_ENV) == "off" )
+        probeIntervals.fill(0);
+    m_probeJob = m_scheduler->addJob("probe", [this] { m_latencyProber->probe(); }, probeIntervals);
+    m_screenLockJob = m_scheduler->addDeadlineJob("screenlock", [this] { screenLockTimeout(); });
+    m_shutdownJob = m_scheduler->addDeadlineJob("shutdown", [this] { automaticShutdownTimeout(); });
+    /* Default route and link changes */
+    m_netlinkMonitor = new NetlinkMonitor(this);
+    connect(m_netlinkMonitor, &NetlinkMonitor::defaultRouteChanged, this, &engineClass::defaultRouteChanged);
+    /* Status files written by env script and dpinger */
+    m_statusWatcher = new StatusWatcher(STATUS_FILE_DIR, this);
+    m_envWatchId = m_statusWatcher->watch("env");
+    m_networkWatchId = m_statusWatcher->watch("network");
+    connect(m_statusWatcher, &StatusWatcher::fileChanged, this, &engineClass::statusFileChanged);
+    m_keyUsage = new KeyUsage(rootedPath(KEY_DIRECTORY), this);
+    connect(m_keyUsage, &KeyUsage::usageChanged, this, &engineClass::keyUsageChanged);
+    /* Outbound telemetry FIFO */
+    m_fifoWriter = new FifoWriter(rootedPath(TELEMETRY_FIFO_IN), this);
+    connect(m_fifoWriter, &FifoWriter::backpressureChanged, this, &engineClass::fifoBackpressureChanged);
+    /* Inbound FIFO traffic log for tests/replay */
+    if ( qEnvironmentVariableIsSet(FIFO_RECORD_ENV) )
+        m_fifoRecorder = new FifoRecorder(qEnvironmentVariable(FIFO_RECORD_ENV), this);
+    /* Helper scripts with output run asynchronously */
+    m_processExecutor = new ProcessExecutor(PROCESS_POOL_SIZE, this);
+    /* Volume key repeats are saved once */
+    volumeSaveTimer = new QTimer(this);
+    volumeSaveTimer->setSingleShot(true);
+    volumeSaveTimer->setInterval(VOLUME_SAVE_DELAY);
+    connect(volumeSaveTimer, &QTimer::timeout, this, &engineClass::saveUserPreferences);
+    /* FIFO reply timeout for call control steps */
+    fifoReplyTimer = new QTimer(this);
+    fifoReplyTimer->setSingleShot(true);
+    fifoReplyTimer->setInterval(FIFO_REPLY_TIMEOUT);
+    connect(fifoReplyTimer, &QTimer::timeout, this, &engineClass::fifoReplyTimeout);
 
     /* Power button, TODO: m_pwrButtonFileHandle close */
-    QByteArray pwrButtonDevice = QByteArrayLiteral(PWR_GPIO_INPUT_PATH);
+    QByteArray pwrButtonDevice = QFile::encodeName(rootedPath(PWR_GPIO_INPUT_PATH));
     m_pwrButtonFileHandle = open(pwrButtonDevice.constData(), O_RDONLY);
     if (m_pwrButtonFileHandle >= 0) {
         m_pwrButtonNotify = new QSocketNotifier(m_pwrButtonFileHandle, QSocketNotifier::Read, this);
@@ -122,7 +203,7 @@ engineClass::engineClass(QObject *parent)
         qErrnoWarning(errno, "Cannot open input device %s", pwrButtonDevice.constData());
     }
     /* Volume buttons */
-    QByteArray volButtonDevice = QByteArrayLiteral(VOL_GPIO_INPUT_PATH);
+    QByteArray volButtonDevice = QFile::encodeName(rootedPath(VOL_GPIO_INPUT_PATH));
     m_volButtonFileHandle = open(volButtonDevice.constData(), O_RDONLY);
     if (m_volButtonFileHandle >= 0) {
         m_volButtonNotify = new QSocketNotifier(m_volButtonFileHandle, QSocketNotifier::Read, this);
@@ -131,7 +212,7 @@ engineClass::engineClass(QObject *parent)
         qErrnoWarning(errno, "Cannot open input device %s", volButtonDevice.constData());
     }
     /* Headset insert  */
-    QByteArray hfPlugDevice = QByteArrayLiteral(HF_PLUG_GPIO_INPUT_PATH);
+    QByteArray hfPlugDevice = QFile::encodeName(rootedPath(HF_PLUG_GPIO_INPUT_PATH));
     m_hfPlugFileHandle = open(hfPlugDevice.constData(), O_RDONLY);
     if (m_hfPlugFileHandle >= 0) {
         m_hfPlugNotify = new QSocketNotifier(m_hfPlugFileHandle, QSocketNotifier::Read, this);
@@ -140,22 +221,18 @@ engineClass::engineClass(QObject *parent)
         qErrnoWarning(errno, "Cannot open input device %s", hfPlugDevice.constData());
     }
     /* Enable backlight */
-    runExternalCmd("/bin/pptk-backlight", {"set_percent", "50"});
-    m_screenTimeoutCounter=DEVICE_LOCK_TIME;
+    m_hardware.setBacklightPercent(50);
+    m_touchClock.start();
+    armScreenLock();
     /* Set default wifi status on top bar*/
-    m_wifiNotifyText = "WIFI";
-    m_wifiNotifyColor = mMainColor;
-    emit wifiNotifyTextChanged();
-    emit wifiNotifyColorChanged();
-    /* Load about text content */
-    loadAboutText();
+    m_wifiNotifyText.set("WIFI", this, &engineClass::wifiNotifyTextChanged);
+    m_wifiNotifyColor.set(mMainColor, this, &engineClass::wifiNotifyColorChanged);
     mAudioDeviceBusy = false;
     /* No nuke */
     mNukeCounterVisible = false;
     emit nukeCounterVisibleChanged();
     /* Internal speaker by default */
-    mMixerNameSpeaker = "Earpiece";
-    runExternalCmd("/root/utils/internal-speaker.sh", {});
+    m_mixer.setRoute(MixerControl::ROUTE_EARPIECE);
     mHfIndicatorVisible = false;
     emit hfIndicatorVisibleChanged();
     mMacsecKeyed = "NO KEY";
@@ -164,11 +241,82 @@ engineClass::engineClass(QObject *parent)
     emit macsecValidChanged();
 }
 
+/* Shutdown deadline, touches only restart the clock so job is re-armed here for the rest */
 void engineClass::automaticShutdownTimeout()
 {
+    if ( m_shutdownLimit == 0 )
+        return;
+    qint64 remaining = m_shutdownLimit - m_shutdownClock.elapsed();
+    if ( remaining > 0 ) {
+        m_scheduler->runJobIn(m_shutdownJob, remaining);
+        return;
+    }
     powerOff();
 }
 
+void engineClass::armAutomaticShutdown(qint64 limit)
+{
+    m_shutdownLimit = limit;
+    m_shutdownClock.start();
+    m_scheduler->runJobIn(m_shutdownJob, limit);
+}
+
+void engineClass::disarmAutomaticShutdown()
+{
+    m_shutdownLimit = 0;
+    m_scheduler->cancelJob(m_shutdownJob);
+}
+
+/* Lock DEVICE_LOCK_TIME after last touch, not while in call or in vault */
+void engineClass::screenLockTimeout()
+{
+    if ( m_deviceLocked || g_connectState || m_vaultModeActive )
+        return;
+    qint64 remaining = DEVICE_LOCK_TIME * 1000 - m_touchClock.elapsed();
+    if ( remaining > 0 ) {
+        m_scheduler->runJobIn(m_screenLockJob, remaining);
+        return;
+    }
+    lockDevice(LOCK_DEVICE);
+}
+
+void engineClass::armScreenLock()
+{
+    m_scheduler->runJobIn(m_screenLockJob, DEVICE_LOCK_TIME * 1000 - m_touchClock.elapsed());
+}
+
+/* Scheduler intervals follow lock, call and visible page */
+void engineClass::updatePowerState()
+{
+    TickScheduler::PowerState state = TickScheduler::POWER_IDLE;
+    if ( m_deviceLocked )
+        state = TickScheduler::POWER_LOCKED;
+    else if ( g_connectState )
+        state = TickScheduler::POWER_IN_CALL;
+    else if ( m_SwipeViewIndex == 2 )
+        state = TickScheduler::POWER_SETTINGS;
+    m_scheduler->setPowerState(state);
+
+    if ( g_connectState == m_powerStateInCall )
+        return;
+    m_powerStateInCall = g_connectState;
+    m_keyUsage->setInCall(g_connectState);
+    if ( g_connectState ) {
+        // Ring indication ends when call is up
+        m_hardware.setLed(LED_GREEN, false);
+        if ( m_automaticShutdownEnabled )
+            disarmAutomaticShutdown();
+    } else {
+        // Proximity is sampled only in call, release its touch block
+        if ( !m_deviceLocked )
+            m_touchBlock_active.set(false, this, &engineClass::touchBlock_activeChanged);
+        m_touchClock.restart();
+        armScreenLock();
+        if ( m_automaticShutdownEnabled )
+            armAutomaticShutdown(AUTOMATIC_SHUTDOWNTIME);
+    }
+}
+
 
 QString engineClass::appVersion()
 {
@@ -205,7 +353,12 @@ bool engineClass::getHfIndicatorVisible()
     return mHfIndicatorVisible;
 }
 
+/* QTUI_EXTERNAL_COMMANDS=off only logs, tests/bench must not touch services of host */
 void engineClass::runExternalCmd(QString command, QStringList parameters){
+    if ( qEnvironmentVariable(EXTERNAL_COMMANDS_ENV) == "off" ) {
+        qDebug() << "External command not run:" << command << parameters;
+        return;
+    }
     qint64 pid;
     QProcess process;
     process.setProgram(command);
@@ -214,24 +367,21 @@ void engineClass::runExternalCmd(QString command, QStringList parameters){
 }
 
 void engineClass::runExternalCmdCaptureOutput(QString command, QStringList parameters){
-    QProcess process;
-    process.setProgram(command);
-    process.setArguments(parameters);
-    process.start();
-    process.waitForFinished();
-    QString result=process.readAllStandardOutput();
-    qDebug() << "runExternalCmdCaptureOutput() " << result;
+    m_processExecutor->run(command, parameters, [](const ProcessResult &result) {
+        qDebug() << "runExternalCmdCaptureOutput() " << QString::fromLocal8Bit(result.output);
+    });
 }
 
 void engineClass::lockDevice(bool state)
 {
+    TRACE_SCOPE("engine::lockDevice");
     if ( state == LOCK_DEVICE && g_connectState == false ) {
+        prewarmLockScreen();
         m_deviceLocked = true;
-        runExternalCmd("/bin/pptk-vibrate", {"200","200","1"});
-        runExternalCmd("/bin/pptk-backlight", {"set_percent", "0"});
+        m_hardware.vibrate(200, 100, 1);
+        m_hardware.setBacklightPercent(0);
         runExternalCmd("/bin/pptk-cpu-sleep", {"enable"});
-        m_touchBlock_active=true;
-        emit touchBlock_activeChanged();
+        m_touchBlock_active.set(true, this, &engineClass::touchBlock_activeChanged);
         m_SwipeViewIndex = 0;
         emit swipeViewIndexChanged();
         m_lockScreen_active=true;
@@ -242,18 +392,38 @@ void engineClass::lockDevice(bool state)
         emit camoScreen_activeChanged();
         if ( m_deepSleepEnabled )
             runExternalCmd("/bin/deepsleep.sh", {});
+        updatePowerState();
+        m_scheduler->logStats();
+        qDebug() << "Property notifies emitted:" << PropertyCellStats::emitted
+                 << "suppressed:" << PropertyCellStats::suppressed;
     }
     if ( state == UNLOCK_DEVICE ) {
         m_deviceLocked = false;
-        m_screenTimeoutCounter=DEVICE_LOCK_TIME;
-        runExternalCmd("/bin/pptk-vibrate", {"200","200","2"});
-        runExternalCmd("/bin/pptk-backlight", {"set_percent", "50"});
+        m_touchClock.restart();
+        armScreenLock();
+        updatePowerState();
+        m_hardware.vibrate(200, 100, 2);
+        m_hardware.setBacklightPercent(50);
         runExternalCmd("/bin/pptk-cpu-sleep", {"disable"});
-        m_touchBlock_active=false;
-        emit touchBlock_activeChanged();
+        m_touchBlock_active.set(false, this, &engineClass::touchBlock_activeChanged);
+        // Cache may have dropped lock screen while unlocked, decode it for next lock
+        prewarmLockScreen();
     }
 }
 
+/* Lock screen is decoded at screen size, same as sourceSize in main.qml */
+void engineClass::prewarmLockScreen()
+{
+    QScreen *screen = QGuiApplication::primaryScreen();
+    if ( screen )
+        m_assetCache.prewarm("lockscreen.png", screen->size());
+}
+
+AssetCache *engineClass::assetCache()
+{
+    return &m_assetCache;
+}
+
 bool engineClass::getPowerOffVisible()
 {
     return mPowerOffDialog;
@@ -281,6 +451,7 @@ void engineClass::closePowerOffDialog()
 void engineClass::setSwipeIndex(int index)
 {
     m_SwipeViewIndex = index;
+    updatePowerState();
 }
 
 void engineClass::readPwrGpioButton()
@@ -298,12 +469,12 @@ void engineClass::readPwrGpioButton()
             mPwrButtonCycle = true;
             mPwrButtonReleased = false;
             QTimer::singleShot(4 * 1000, this, SLOT(readPwrGpioButtonTimer()));
-            runExternalCmd("/bin/pptk-led", {"set", "red", "1"});
+            m_hardware.setLed(LED_RED, true);
             break;
         }
         if (KEY_POWER == in_ev.code && in_ev.value == 0 ) {
             mPwrButtonReleased = true;
-            runExternalCmd("/bin/pptk-led", {"set", "red", "0"});
+            m_hardware.setLed(LED_RED, false);
             if ( m_deviceLocked == false && !mPowerOffDialog ) {
                 lockDevice(LOCK_DEVICE);
             } else
@@ -323,7 +494,7 @@ void engineClass::countNukeTimer()
     mNukeCounterVisible = true;
     emit nukeCounterTextChanged();
     emit nukeCounterVisibleChanged();
-    runExternalCmd("/bin/pptk-vibrate", {"400","10","1"});
+    m_hardware.vibrate(400, 10, 1);
     if ( nukeCountDownValue > 0 ) {
         nukeCountDownValue--;
     }
@@ -366,7 +537,7 @@ void engineClass::readNukeTimer()
     if ( mVolUpKeyReleased  == false ) {
         if ( mNukeTimerRunning ) {
             mNukeTimerRunning = false;
-            runExternalCmd("/bin/pptk-backlight", {"set_percent", "50"});
+            m_hardware.setBacklightPercent(50);
             nukeCountDownValue = 10;
             nukeCountDownTimer = new QTimer();
             connect(nukeCountDownTimer, &QTimer::timeout, this, QOverload<>::of(&engineClass::countNukeTimer));
@@ -404,7 +575,7 @@ void engineClass::readVolGpioButton()
                 if ( m_SwipeViewIndex == 2 ) {
                     if ( mBacklightLevel >= 20 && mBacklightLevel <= 90 ) {
                         registerTouch();
-                        runExternalCmd("/bin/pptk-backlight", {"set_percent", QString::number(mBacklightLevel)});
+                        m_hardware.setBacklightPercent(mBacklightLevel);
                         mBacklightLevel = mBacklightLevel - 10;
                     }
                 } else {
@@ -416,7 +587,8 @@ void engineClass::readVolGpioButton()
                     m_statusMessage = "Volume: " + QString::number(m_SpeakerVolumeRuntimeValue) + " %" ;
                     emit statusMessageChanged();
                     uPref.volumeValue = QString::number(m_SpeakerVolumeRuntimeValue);
-                    saveUserPreferences();
+                    setSystemVolume(m_SpeakerVolumeRuntimeValue);
+                    volumeSaveTimer->start();
                     break;
                 }
             }
@@ -441,7 +613,7 @@ void engineClass::readVolGpioButton()
                 if ( mBacklightLevel >= 10 && mBacklightLevel <= 80 ) {
                     registerTouch();
                     mBacklightLevel = mBacklightLevel + 10;
-                    runExternalCmd("/bin/pptk-backlight", {"set_percent", QString::number(mBacklightLevel)});
+                    m_hardware.setBacklightPercent(mBacklightLevel);
                 }
             } else {
                 /* Volume */
@@ -452,7 +624,8 @@ void engineClass::readVolGpioButton()
                 m_statusMessage = "Volume: " + QString::number(m_SpeakerVolumeRuntimeValue) + " %" ;
                 emit statusMessageChanged();
                 uPref.volumeValue = QString::number(m_SpeakerVolumeRuntimeValue);
-                saveUserPreferences();
+                setSystemVolume(m_SpeakerVolumeRuntimeValue);
+                volumeSaveTimer->start();
                 break;
             }
         }
@@ -476,15 +649,13 @@ void engineClass::readHfPlugEvents()
     case EV_SW:
     {
         if (SW_HEADPHONE_INSERT == in_ev.code && in_ev.value == 1 ) {
-            mMixerNameSpeaker = "Headphone";
-            runExternalCmd("/root/utils/headset.sh", {});
+            m_mixer.setRoute(MixerControl::ROUTE_HEADPHONE);
             mHfIndicatorVisible = true;
             emit hfIndicatorVisibleChanged();
             break;
         }
         if (SW_HEADPHONE_INSERT == in_ev.code && in_ev.value == 0 ) {
-            mMixerNameSpeaker = "Earpiece";
-            runExternalCmd("/root/utils/internal-speaker.sh", {});
+            m_mixer.setRoute(MixerControl::ROUTE_EARPIECE);
             mHfIndicatorVisible = false;
             emit hfIndicatorVisibleChanged();
             break;
@@ -494,42 +665,25 @@ void engineClass::readHfPlugEvents()
 }
 
 /*
- * Set system volume with external process.
- *
- * * Mixer is now named based on HF plug status.
+ * Set system volume through ALSA mixer.
  *
- * Playback volume:     amixer sset [DEVICENAME] Playback 100%
- * Microphone volume:   amixer sset [DEVICENAME] Capture 5%+
+ * * Playback element follows HF plug status (Earpiece or Headphone).
  *
- * Internal earpiece: "'Earpiece'"
- * Internal mic: "'Mic1'" or "'Mic2'"
+ * Internal earpiece: "Earpiece"
+ * Internal mic: "Mic1", headset mic "Mic2"
  *
  */
 void engineClass::setSystemVolume(int volume)
 {
-    QString volumePercentString = QString::number(volume) + "%";
-    qint64 pid;
-    QProcess process;
-    process.setProgram("/usr/bin/amixer");
-    process.setArguments({"sset",mMixerNameSpeaker, "Playback",volumePercentString});
-    process.setStandardOutputFile(QProcess::nullDevice());
-    process.setStandardErrorFile(QProcess::nullDevice());
-    process.startDetached(&pid);
+    m_mixer.setPlaybackVolume(volume);
 }
 void engineClass::setMicrophoneVolume(int volume)
 {
-    QString volumePercentString = QString::number(volume) + "%";
-    qint64 pid;
-    QProcess process;
-    process.setProgram("/usr/bin/amixer");
-    process.setArguments({"sset","'Mic'", "Capture", volumePercentString });
-    process.setStandardOutputFile(QProcess::nullDevice());
-    process.setStandardErrorFile(QProcess::nullDevice());
-    process.startDetached(&pid);
+    m_mixer.setCaptureVolume(volume);
 }
 void engineClass::loadUserPreferences()
 {
-    QSettings settings(USER_PREF_INI_FILE,QSettings::IniFormat);
+    QSettings settings(rootedPath(USER_PREF_INI_FILE),QSettings::IniFormat);
     uPref.volumeValue = settings.value("volume","70").toString();
     uPref.m_micVolume = settings.value("micvolume","100").toString();
     nodes.beepActive = settings.value("beep").toString();
@@ -551,7 +705,7 @@ void engineClass::loadUserPreferences()
     emit layer2WifiChanged();
     // Some settings are required to be available before vault is open,
     // so we load them from PRE_VAULT_INI_FILE
-    QSettings vaultPreferences(PRE_VAULT_INI_FILE,QSettings::IniFormat);
+    QSettings vaultPreferences(rootedPath(PRE_VAULT_INI_FILE),QSettings::IniFormat);
     m_callSignVisibleOnVaultPage = vaultPreferences.value("vaultpagecallsign",true).toBool();
     emit callSignOnVaultEnabledChanged();
     m_messageEraseEnabled = vaultPreferences.value("msg_erase",true).toBool();
@@ -559,7 +713,7 @@ void engineClass::loadUserPreferences()
     m_automaticShutdownEnabled = vaultPreferences.value("automaticshutdown",true).toBool();
     emit automaticShutdownEnabledChanged();
     if (m_automaticShutdownEnabled) {
-        automaticShutdownTimer->start( AUTOMATIC_SHUTDOWNTIME );
+        armAutomaticShutdown( AUTOMATIC_SHUTDOWNTIME );
     }
 
 
@@ -571,10 +725,7 @@ void engineClass::loadUserPreferences()
         emit highColorChanged();
         mDimColor = "#cc2100";      //  #dd5300     21cc00          cc2100
         emit dimColorChanged();
-        m_wifiNotifyColor = mMainColor;
-        emit wifiNotifyColorChanged();
-        mMessageColorLocal = mDimColor;
-        mMessageColorRemote = mMainColor;
+        m_wifiNotifyColor.set(mMainColor, this, &engineClass::wifiNotifyColorChanged);
 
     }
     else {
@@ -585,106 +736,135 @@ void engineClass::loadUserPreferences()
         emit highColorChanged();
         mDimColor = "#21cc00";      //  #dd5300     21cc00          cc2100
         emit dimColorChanged();
-        m_wifiNotifyColor = mMainColor;
-        emit wifiNotifyColorChanged();
-        mMessageColorLocal = mDimColor;
-        mMessageColorRemote = mMainColor;
+        m_wifiNotifyColor.set(mMainColor, this, &engineClass::wifiNotifyColorChanged);
     }
 }
 
+/* Volume is applied on key press, INI write trails last press by VOLUME_SAVE_DELAY */
 void engineClass::saveUserPreferences()
 {
-    QSettings settings(USER_PREF_INI_FILE,QSettings::IniFormat);
+    volumeSaveTimer->stop();
+    QSettings settings(rootedPath(USER_PREF_INI_FILE),QSettings::IniFormat);
     settings.setValue("volume", uPref.volumeValue);
-    setSystemVolume( uPref.volumeValue.toInt() );
-    setMicrophoneVolume(uPref.m_micVolume.toInt());
 }
 
-void engineClass::loadSettings()
+/*
+    Startup order: preferences and node settings -> peers -> key usage,
+    FIFOs need own address from settings. File reads run on pool.
+*/
+void engineClass::startup()
 {
     if ( m_vaultModeActive ) {
-        automaticShutdownTimer->start( AUTOMATIC_SHUTDOWNTIME_IN_VAULT_MODE );
-        QSettings vaultPreferences(PRE_VAULT_INI_FILE,QSettings::IniFormat);
-        bool vaultPinDisplay = vaultPreferences.value("vaultpagecallsign",false).toBool();
-        if ( vaultPinDisplay ) {
-            QString vaultMyCallSign = vaultPreferences.value("my_name","").toString();
-            m_vaultNotifyText = "ENTER VAULT PIN [ " + vaultMyCallSign + " ]";
-            emit vaultScreenNotifyTextChanged();
-        } else {
-            m_vaultNotifyText = "ENTER VAULT PIN";
-            emit vaultScreenNotifyTextChanged();
-        }
-        m_vaultNotifyColor = "red";
-        m_vaultNotifyTextColor = "white";
-        emit vaultScreenNotifyColorChanged();
-        emit vaultScreenNotifyTextColorChanged();
+        m_startup->addStep("vault", [this] { loadVaultSettings(); });
+        m_startup->start();
         return;
     }
-    /* Load volumes (for now)*/
-    loadUserPreferences();
-    QSettings settings(SETTINGS_INI_FILE,QSettings::IniFormat);
+    m_startup->addStep("lockscreen", [this] { prewarmLockScreen(); });
+    m_startup->addPoolStep("apn", [this] {
+        QString apn = readApnName();
+        return StartupPipeline::Apply([this, apn] {
+            mApnName = apn;
+            emit apnNameChanged();
+        });
+    });
+    int preferences = m_startup->addStep("preferences", [this] { loadUserPreferences(); });
+    int settings = m_startup->addPoolStep("settings", [this] {
+        SPreferences read = readNodeSettings();
+        return StartupPipeline::Apply([this, read] { applyNodeSettings(read); });
+    });
+    // Peer colors follow night mode from preferences
+    int peers = m_startup->addStep("peers", [this] { loadPeers(); }, {preferences, settings});
+    int fifos = m_startup->addStep("fifos", [this] { initEngine(); }, {settings});
+    int keys = m_startup->addStep("keys", [this] {
+        m_keyUsage->setNodes(nodes.node_id, nodes.myNodeId);
+    }, {peers});
+    m_startup->addStep("ready", [this] {
+        /* Activate contact buttons, except my own */
+        m_peerModel->setAllActive(true);
+        m_peerModel->setActive(nodes.node_name.indexOf(nodes.myNodeName), false);
+        m_statusMessage = "Ready!";
+        emit statusMessageChanged();
+    }, {peers, fifos, keys});
+    m_startup->start();
+}
+
+QString engineClass::getStartupTimeline()
+{
+    return m_startup->timelineText();
+}
+
+void engineClass::loadVaultSettings()
+{
+    armAutomaticShutdown( AUTOMATIC_SHUTDOWNTIME_IN_VAULT_MODE );
+    QSettings vaultPreferences(rootedPath(PRE_VAULT_INI_FILE),QSettings::IniFormat);
+    bool vaultPinDisplay = vaultPreferences.value("vaultpagecallsign",false).toBool();
+    if ( vaultPinDisplay ) {
+        QString vaultMyCallSign = vaultPreferences.value("my_name","").toString();
+        m_vaultNotifyText = "ENTER VAULT PIN [ " + vaultMyCallSign + " ]";
+        emit vaultScreenNotifyTextChanged();
+    } else {
+        m_vaultNotifyText = "ENTER VAULT PIN";
+        emit vaultScreenNotifyTextChanged();
+    }
+    m_vaultNotifyColor = "red";
+    m_vaultNotifyTextColor = "white";
+    emit vaultScreenNotifyColorChanged();
+    emit vaultScreenNotifyTextColorChanged();
+}
+
+/* Runs on startup pool, touches no members */
+engineClass::SPreferences engineClass::readNodeSettings()
+{
+    SPreferences read;
+    QSettings settings(rootedPath(SETTINGS_INI_FILE),QSettings::IniFormat);
     /* Get own node information*/
-    nodes.myNodeId = settings.value("my_id").toString();
-    nodes.myNodeIp = settings.value("my_ip").toString();
-    nodes.myNodeName = settings.value("my_name").toString();
-    emit myCallSignChanged();
-    /* Get nodes */
-    for (int x=0; x < NODECOUNT; x++ ) {
-        nodes.node_name[x] = settings.value("node_name_"+QString::number(x), "").toString();
-        nodes.node_ip[x] = settings.value("node_ip_"+QString::number(x), "").toString();
-        nodes.node_id[x] = settings.value("node_id_"+QString::number(x), "").toString();
+    read.myNodeId = settings.value("my_id").toString();
+    read.myNodeIp = settings.value("my_ip").toString();
+    read.myNodeName = settings.value("my_name").toString();
+    /* Get nodes, numbered from zero until first missing entry */
+    for (int x=0; settings.contains("node_name_"+QString::number(x)); x++ ) {
+        read.node_name << settings.value("node_name_"+QString::number(x), "").toString();
+        read.node_ip << settings.value("node_ip_"+QString::number(x), "").toString();
+        read.node_id << settings.value("node_id_"+QString::number(x), "").toString();
     }
+    return read;
+}
+
+void engineClass::applyNodeSettings(const SPreferences &settings)
+{
+    nodes.myNodeId = settings.myNodeId;
+    nodes.myNodeIp = settings.myNodeIp;
+    nodes.myNodeName = settings.myNodeName;
+    emit myCallSignChanged();
+    nodes.node_name = settings.node_name;
+    nodes.node_ip = settings.node_ip;
+    nodes.node_id = settings.node_id;
+}
+
+void engineClass::loadPeers()
+{
     /* Change button titles */
-    m_peer_0_CallSign=nodes.node_name[0];
-    emit peer_0_NameChanged();
-    m_peer_1_CallSign=nodes.node_name[1];
-    emit peer_1_NameChanged();
-    m_peer_2_CallSign=nodes.node_name[2];
-    emit peer_2_NameChanged();
-    m_peer_3_CallSign=nodes.node_name[3];
-    emit peer_3_NameChanged();
-    m_peer_4_CallSign=nodes.node_name[4];
-    emit peer_4_NameChanged();
-    m_peer_5_CallSign=nodes.node_name[5];
-    emit peer_5_NameChanged();
-    m_peer_6_CallSign=nodes.node_name[6];
-    emit peer_6_NameChanged();
-    m_peer_7_CallSign=nodes.node_name[7];
-    emit peer_7_NameChanged();
-    m_peer_8_CallSign=nodes.node_name[8];
-    emit peer_8_NameChanged();
-    m_peer_9_CallSign=nodes.node_name[9];
-    emit peer_9_NameChanged();
+    m_peerModel->setPeers(nodes.node_name);
+    /* Peer latency files */
+    m_sensors.setPeerCount(nodes.node_name.size());
+    m_latencyProber->setPeers(nodes.node_ip);
+    m_peerWatchIds.clear();
+    for (int x=0; x < nodes.node_name.size(); x++ )
+        m_peerWatchIds << m_statusWatcher->watch("peer" + QByteArray::number(x));
 
     m_statusMessage = "Settings loaded, please wait.";
     emit statusMessageChanged();
 
-    // Key usage population
-    reloadKeyUsage();
-
-    // Set peer contact colors
-    m_peer_0_CallSignColor = mMainColor;
-    emit peer_0_NameColorChanged();
-    m_peer_1_CallSignColor = mMainColor;
-    emit peer_1_NameColorChanged();
-    m_peer_2_CallSignColor = mMainColor;
-    emit peer_2_NameColorChanged();
-    m_peer_3_CallSignColor = mMainColor;
-    emit peer_3_NameColorChanged();
-    m_peer_4_CallSignColor = mMainColor;
-    emit peer_4_NameColorChanged();
-    m_peer_5_CallSignColor = mMainColor;
-    emit peer_5_NameColorChanged();
-    m_peer_6_CallSignColor = mMainColor;
-    emit peer_6_NameColorChanged();
-    m_peer_7_CallSignColor = mMainColor;
-    emit peer_7_NameColorChanged();
-    m_peer_8_CallSignColor = mMainColor;
-    emit peer_8_NameColorChanged();
-    m_peer_9_CallSignColor = mMainColor;
-    emit peer_9_NameColorChanged();
-    // Load APN
-    loadApnName();
+    // Insignias are decoded ahead so selecting a contact does not wait for PNG
+    for (int x=0; x < qMin(nodes.node_name.size(), INSIGNIA_COUNT); x++ )
+        m_assetCache.prewarm(insigniaImages[x], INSIGNIA_SIZE);
+
+    // Set peer contact colors and initial status, later updates come from StatusWatcher
+    m_peerModel->setAllNameColors(mMainColor);
+    updateEnvStatus();
+    updateNetworkStatus();
+    peerLatency();
+    updateRouteIndicator();
 }
 
 void engineClass::setVaultMode(bool vaultModeActive) {
@@ -692,133 +872,39 @@ void engineClass::setVaultMode(bool vaultModeActive) {
     emit vaultScreen_activeChanged();
 }
 
-/* This function will read key file lenghts and counter values of each key.
-   Way keys are named as files, depends on index unit has. Therefore we
-   need 'tipping point' - which gives index order change location while
-   checking files. See key creation code to get better picture of this.
-*/
-void engineClass::reloadKeyUsage()
-{
-    int tippingPoint=0;
-    QString keyfile;
-    QString keyCountfile;
-    for (int x=0; x < NODECOUNT; x++ ) {
-        m_keyPersentage_incount[x] = "";
-        m_keyPersentage_outcount[x] = "";
-    }
-    /* Find a tipping point in keyfile naming. */
-    for (int x=0; x < NODECOUNT; x++ ) {
-        if ( nodes.node_id[x].compare( nodes.myNodeId ) == 0 ){
-            tippingPoint = x;
-        }
-    }
-    /* Loop for inkey with tipping point evaluation */
-    for (int x=0; x < NODECOUNT; x++ ) {
-        if ( nodes.node_id[x].compare( nodes.myNodeId ) != 0 )
-        {
-            if ( x < tippingPoint ) {
-                keyfile = "/opt/tunnel/" + nodes.node_id[x] + nodes.myNodeId +".inkey";
-                keyCountfile = "/opt/tunnel/" + nodes.node_id[x] + nodes.myNodeId +".incount";
-            } else {
-                keyfile = "/opt/tunnel/" + nodes.myNodeId + nodes.node_id[x] +".inkey";
-                keyCountfile = "/opt/tunnel/" + nodes.myNodeId + nodes.node_id[x] +".incount";
-            }
-            // Read actual information
-            long int key_file_size = get_file_size(keyfile);
-            long int rx_key_used = get_key_index(keyCountfile);
-            float key_percentage = (100.0*rx_key_used)/key_file_size;
-            QString fullPercentage=QString::number(100-key_percentage,'f',0);
-            m_keyPersentage_incount[x] = fullPercentage;
-        }
-    }
-    /* Loop for outkey with tipping point evaluation */
-    for (int x=0; x < NODECOUNT; x++ ) {
-        if ( nodes.node_id[x].compare( nodes.myNodeId ) != 0 )
-        {
-            if ( x < tippingPoint ) {
-                keyfile = "/opt/tunnel/" + nodes.node_id[x] + nodes.myNodeId +".outkey";
-                keyCountfile = "/opt/tunnel/" + nodes.node_id[x] + nodes.myNodeId +".outcount";
-            } else {
-                keyfile = "/opt/tunnel/" + nodes.myNodeId + nodes.node_id[x] +".outkey";
-                keyCountfile = "/opt/tunnel/" + nodes.myNodeId + nodes.node_id[x] +".outcount";
-            }
-            // Read actual information
-            long int key_file_size = get_file_size(keyfile);
-            long int rx_key_used = get_key_index(keyCountfile);
-            float key_percentage = (100.0*rx_key_used)/key_file_size;
-            QString fullPercentage=QString::number(100-key_percentage,'f',0);
-            m_keyPersentage_outcount[x] = fullPercentage;
-        }
-    }
-    emit peer_0_keyPercentageChanged();
-    emit peer_1_keyPercentageChanged();
-    emit peer_2_keyPercentageChanged();
-    emit peer_3_keyPercentageChanged();
-    emit peer_4_keyPercentageChanged();
-    emit peer_5_keyPercentageChanged();
-    emit peer_6_keyPercentageChanged();
-    emit peer_7_keyPercentageChanged();
-    emit peer_8_keyPercentageChanged();
-    emit peer_9_keyPercentageChanged();
+/* Key usage and depletion forecast of one peer to model, own node and unknown show no value */
+void engineClass::keyUsageChanged(int index)
+{
+    if ( index >= nodes.node_id.size() || nodes.node_id.at(index) == nodes.myNodeId )
+        return;
+    int in = m_keyUsage->remainingPercent(index, KeyUsage::KEY_IN);
+    int out = m_keyUsage->remainingPercent(index, KeyUsage::KEY_OUT);
+    m_peerModel->setKeyPercentage(index, in < 0 ? "-" : QString::number(in),
+                                  out < 0 ? "-" : QString::number(out));
+    m_peerModel->setKeyForecast(index, m_keyUsage->talkSecondsLeft(index), m_keyUsage->messagesLeft(index));
 }
 
 // TODO: Check i2c path change and implement better solution
 void engineClass::proximityTimerTick()
 {
-    bool proxValueAvailable = false;
-    QString proxLine;
-    QString proxFileName=PROXIMITY_SENSOR_PATH;
-    QFile proxFile(proxFileName);
-    if(!proxFile.exists()){
-    } else {
-        if (proxFile.open(QIODevice::ReadOnly | QIODevice::Text)){
-            QTextStream stream(&proxFile);
-            while (!stream.atEnd()){
-                proxLine = stream.readLine();
-                break;
-            }
-        }
-        proxFile.close();
-        proxValueAvailable = true;
-    }
-
-    if ( !proxValueAvailable ) {
-        proxFileName = PROXIMITY_SENSOR_PATH_2;
-        QFile proxFileSensodary(proxFileName);
-        if(!proxFileSensodary.exists()){
-            return;
-        } else {
-            if (proxFileSensodary.open(QIODevice::ReadOnly | QIODevice::Text)){
-                QTextStream stream(&proxFileSensodary);
-                while (!stream.atEnd()){
-                    proxLine = stream.readLine();
-                    break;
-                }
-            }
-            proxFileSensodary.close();
-            proxValueAvailable = true;
-        }
-    }
-
-    if ( proxValueAvailable ) {
-        if ( proxLine.toInt() > 400 ) {
-            // Swipe to front page & block touch
+    int proximity;
+    if ( !m_sensors.proximity(proximity) )
+        return;
+    if ( proximity > 400 ) {
+        // Swipe to front page & block touch, once when sensor gets covered
+        if ( m_touchBlock_active.set(true, this, &engineClass::touchBlock_activeChanged) ) {
             m_SwipeViewIndex = 0;
             emit swipeViewIndexChanged();
-            m_touchBlock_active=true;
-            emit touchBlock_activeChanged();
-
-        } else {
-            // Unblock touch
-            m_touchBlock_active=false;
-            emit touchBlock_activeChanged();
         }
+    } else {
+        // Unblock touch
+        m_touchBlock_active.set(false, this, &engineClass::touchBlock_activeChanged);
     }
-
 }
 
 void engineClass::envTimerTick()
 {
+    TRACE_SCOPE("engine::envTimerTick");
 /*
 Cell information
 
@@ -841,276 +927,192 @@ Signal information
         return;
     }
 
-    /* Get default route interface */
-    if ( 1 ) {
+    /* Default route is pushed by NetlinkMonitor, read /proc/net/route only without netlink */
+    if ( !m_netlinkMonitor->isActive() ) {
         mDefaultRouteInterface = getDefaultRoute();
-        if ( mDefaultRouteInterface.contains("wwan0") ) {
-            m_wifiNotifyText = "LTE";
-            m_wifiNotifyColor = mMainColor;
-            emit wifiNotifyTextChanged();
-            emit wifiNotifyColorChanged();
-        }
-        if ( mDefaultRouteInterface.contains("wlan0") ) {
-            m_wifiNotifyText = "WIFI";
-            m_wifiNotifyColor = mMainColor;
-            emit wifiNotifyTextChanged();
-            emit wifiNotifyColorChanged();
-        }
+        updateRouteIndicator();
     }
 
-    if ( 1 ) {
-        /* Read voltage from ENV file as volts */
-        QString filename="/tmp/env";
-        QFile file(filename);
-        if(!file.exists()){
-            qDebug() << "Error, no file: "<<filename;
-        }
-        QString line;
-        if (file.open(QIODevice::ReadOnly | QIODevice::Text)){
-            QTextStream stream(&file);
-            while (!stream.atEnd()){
-                line = stream.readLine();
-            }
-        }
-        file.close();
-
-        /* Split string and display voltage type #1 (env file / volts)  */
-        QStringList elements = line.split(',');
-        mVoltage = elements[0] + " V";
-        emit voltageValueChanged();
-        float voltageCompareValue = elements[0].toFloat();
-        if ( voltageCompareValue < 3.7 && voltageCompareValue > 3.6 ) {
-            mvoltageNotifyColor = "#FFFF00";
-            emit voltageNotifyColorChanged();
-        }
-        if (voltageCompareValue > 3.7) {
-            mvoltageNotifyColor = mMainColor;
-            emit voltageNotifyColorChanged();
-        }
-        if (voltageCompareValue < 3.6) {
-            mvoltageNotifyColor = "#FF5555";
-            emit voltageNotifyColorChanged();
-        }
-        /* Parse cellular environment if we have it */
-        mPlmn = elements[1];
-        mTa = elements[2];
-        mGc = elements[3];
-        mSc = elements[4];
-        mAc = elements[5];
-        mRssi = elements[6];
-        mRsrq = elements[7];
-        mRsrp = elements[8];
-        mSnr = elements[9];
-        emit plmnChanged();
-        emit taChanged();
-        emit gcChanged();
-        emit scChanged();
-        emit acChanged();
-        emit rssiChanged();
-        emit rsrqChanged();
-        emit rsrpChanged();
-        emit snrChanged();
-    }
-    /* Read capacity as percentage from /sys/class/power_supply/axp20x-battery/capacity */
-    if ( 1 ) {
-        QString chargeStatusText="";
-        QFile batStatusFile(BATTERY_STATUS_PATH);
-        if(!batStatusFile.exists()){
-        }
-        QString batStatus;
-        if (batStatusFile.open(QIODevice::ReadOnly | QIODevice::Text)){
-            QTextStream stream(&batStatusFile);
-            batStatus = stream.readLine();
-        }
-        batStatusFile.close();
-        if ( batStatus.contains( "Charging",Qt::CaseInsensitive ) ) {
-            chargeStatusText = "↗";
-        }
-        if ( batStatus.contains( "Discharging",Qt::CaseInsensitive ) ) {
-            chargeStatusText = "↘";
-        }
-        // Capacity
-        QFile file(BATTERY_CAPACITY_PATH);
-        if(!file.exists()){
-            mVoltage = "ERR";
-            emit voltageValueChanged();
-        }
-        QString line;
-        if (file.open(QIODevice::ReadOnly | QIODevice::Text)){
-            QTextStream stream(&file);
-            line = stream.readLine();
-        }
-        file.close();
-        mVoltage = "" + line + " % " + chargeStatusText;
-        emit voltageValueChanged();
-        int voltCompare = line.toInt();
-        // Green > 20 %
-        if ( voltCompare > 20 ) {
-            mvoltageNotifyColor = mMainColor;
-            emit voltageNotifyColorChanged();
-        }
-        // Yellow 10 - 20 %
-        if ( voltCompare >= 10 && voltCompare <= 20 ) {
-            mvoltageNotifyColor = "#FFFF00";
-            emit voltageNotifyColorChanged();
-        }
-        // Red < 10 %
-        if ( voltCompare < 10 ) {
-            mvoltageNotifyColor = "#FF5555";
-            emit voltageNotifyColorChanged();
-        }
+    /* Status files are pushed by StatusWatcher, poll them only without inotify */
+    if ( !m_statusWatcher->isActive() ) {
+        updateEnvStatus();
+        updateNetworkStatus();
+        peerLatency();
     }
+    updateBatteryStatus();
+}
 
-    QString networkStatusFile="/tmp/network";
-    QFile networkFile(networkStatusFile);
-    if(!networkFile.exists()){
-        qDebug() << "Error, no file: " << networkStatusFile;
-    }
-    QString networkMeasurementValues;
-    if (networkFile.open(QIODevice::ReadOnly | QIODevice::Text)){
-        QTextStream stream(&networkFile);
-        while (!stream.atEnd()){
-            networkMeasurementValues = stream.readLine();
-        }
-    }
-    networkFile.close();
+void engineClass::defaultRouteChanged(const QString &interfaceName)
+{
+    mDefaultRouteInterface = interfaceName;
+    updateRouteIndicator();
+}
 
-    // <Average Latency in μs> <Standard Deviation in μs> <Percentage of Loss>
-    QStringList networkElements = networkMeasurementValues.split(' ');
-    int latencyIntms = networkElements[0].toInt()/1000;
-    QString indicateValue = QString::number(latencyIntms) + " ms";
-    mnetworkStatusLabelValue = indicateValue;
-    mnetworkStatusLabelColor=mMainColor;
-    if ( latencyIntms < 200 ) {
-        mnetworkStatusLabelColor=mMainColor;
-    }
-    if ( latencyIntms == 0 ) {
-        mnetworkStatusLabelColor="#FF5555";
-    }
-    if ( latencyIntms > 200 ) {
-        mnetworkStatusLabelColor="#FFFF00";
+/* Top bar LTE / WIFI badge from default route interface */
+void engineClass::updateRouteIndicator()
+{
+    if ( m_vaultModeActive )
+        return;
+    if ( mDefaultRouteInterface.contains("wwan0") ) {
+        m_wifiNotifyText.set("LTE", this, &engineClass::wifiNotifyTextChanged);
+        m_wifiNotifyColor.set(mMainColor, this, &engineClass::wifiNotifyColorChanged);
     }
-    if ( latencyIntms > 1000 ) {
-        mnetworkStatusLabelColor="#FF5555";
+    if ( mDefaultRouteInterface.contains("wlan0") ) {
+        m_wifiNotifyText.set("WIFI", this, &engineClass::wifiNotifyTextChanged);
+        m_wifiNotifyColor.set(mMainColor, this, &engineClass::wifiNotifyColorChanged);
     }
-    emit networkStatusLabelChanged();
-    emit networkStatusLabelColorChanged();
+}
 
-    /* Screen timeout counter */
-    if ( m_screenTimeoutCounter > 0 && m_deviceLocked == false && g_connectState == false ) {
-        m_screenTimeoutCounter = m_screenTimeoutCounter - 5;
+/* Cellular environment from /tmp/env, properties are rebuilt only when file content changed */
+void engineClass::updateEnvStatus()
+{
+    char buffer[SENSOR_LINE_MAX];
+    EnvSample env;
+    if ( !m_sensors.envSample(buffer, sizeof(buffer), env) || !m_sensors.envChanged() )
+        return;
+    auto field = [&env](int index) {
+        return QString::fromUtf8(env.field[index].data(), int(env.field[index].size()));
+    };
+    /* Voltage is shown only if battery capacity is not readable */
+    m_envVoltage = field(0);
+    mPlmn.set(field(1), this, &engineClass::plmnChanged);
+    mTa.set(field(2), this, &engineClass::taChanged);
+    mGc.set(field(3), this, &engineClass::gcChanged);
+    mSc.set(field(4), this, &engineClass::scChanged);
+    mAc.set(field(5), this, &engineClass::acChanged);
+    mRssi.set(field(6), this, &engineClass::rssiChanged);
+    mRsrq.set(field(7), this, &engineClass::rsrqChanged);
+    mRsrp.set(field(8), this, &engineClass::rsrpChanged);
+    mSnr.set(field(9), this, &engineClass::snrChanged);
+}
+
+/* Battery capacity & charge direction, /tmp/env voltage as fallback */
+void engineClass::updateBatteryStatus()
+{
+    int batteryPercent;
+    if ( m_sensors.batteryCapacity(batteryPercent) ) {
+        BatteryState batteryState = m_sensors.batteryState();
+        if ( batteryPercent != m_batteryPercent || batteryState != m_batteryState ) {
+            m_batteryPercent = batteryPercent;
+            m_batteryState = batteryState;
+            QString chargeStatusText="";
+            if ( batteryState == BATTERY_CHARGING )
+                chargeStatusText = "↗";
+            if ( batteryState == BATTERY_DISCHARGING )
+                chargeStatusText = "↘";
+            mVoltage.set(QString::number(batteryPercent) + " % " + chargeStatusText, this, &engineClass::voltageValueChanged);
+        }
+        // Green > 20 %, Yellow 10 - 20 %, Red < 10 %
+        if ( batteryPercent > 20 )
+            mvoltageNotifyColor.set(mMainColor, this, &engineClass::voltageNotifyColorChanged);
+        else if ( batteryPercent >= 10 )
+            mvoltageNotifyColor.set(QStringLiteral("#FFFF00"), this, &engineClass::voltageNotifyColorChanged);
+        else
+            mvoltageNotifyColor.set(QStringLiteral("#FF5555"), this, &engineClass::voltageNotifyColorChanged);
+        return;
     }
-    if ( m_screenTimeoutCounter == 0 && m_deviceLocked == false ) {
-        lockDevice(LOCK_DEVICE);
+    m_batteryPercent = -1;
+    if ( m_envVoltage.isEmpty() ) {
+        mVoltage.set(QStringLiteral("ERR"), this, &engineClass::voltageValueChanged);
+        return;
     }
-    peerLatency();
+    mVoltage.set(m_envVoltage + " V", this, &engineClass::voltageValueChanged);
+    float voltageCompareValue = m_envVoltage.toFloat();
+    if ( voltageCompareValue > 3.7 )
+        mvoltageNotifyColor.set(mMainColor, this, &engineClass::voltageNotifyColorChanged);
+    else if ( voltageCompareValue > 3.6 )
+        mvoltageNotifyColor.set(QStringLiteral("#FFFF00"), this, &engineClass::voltageNotifyColorChanged);
+    else
+        mvoltageNotifyColor.set(QStringLiteral("#FF5555"), this, &engineClass::voltageNotifyColorChanged);
+}
 
-    // Stop shutdown timer if connection is active
-    if ( g_connectState && m_automaticShutdownEnabled && automaticShutdownTimer->isActive() ) {
-        automaticShutdownTimer->stop();
+/* Network latency from dpinger output in /tmp/network */
+void engineClass::updateNetworkStatus()
+{
+    // <Average Latency in μs> <Standard Deviation in μs> <Percentage of Loss>
+    PingerSample sample;
+    if ( !m_sensors.networkStatus(sample) )
+        sample = PingerSample();
+    int latencyIntms = int(sample.latencyUs / 1000);
+    int lossPercent = int(sample.lossPercent);
+    if ( latencyIntms != m_networkLatencyMs || lossPercent != m_networkLossPercent ) {
+        m_networkLatencyMs = latencyIntms;
+        m_networkLossPercent = lossPercent;
+        QString label = QString::number(latencyIntms) + " ms";
+        if ( lossPercent > 0 )
+            label += " " + QString::number(lossPercent) + "%";
+        mnetworkStatusLabelValue.set(label, this, &engineClass::networkStatusLabelChanged);
+    }
+    if ( latencyIntms == 0 || latencyIntms > 1000 || lossPercent >= 50 )
+        mnetworkStatusLabelColor.set(QStringLiteral("#FF5555"), this, &engineClass::networkStatusLabelColorChanged);
+    else if ( latencyIntms > 200 || lossPercent > 0 )
+        mnetworkStatusLabelColor.set(QStringLiteral("#FFFF00"), this, &engineClass::networkStatusLabelColorChanged);
+    else
+        mnetworkStatusLabelColor.set(mMainColor, this, &engineClass::networkStatusLabelColorChanged);
+}
+
+/* Status file written by producer script, re-read only that file */
+void engineClass::statusFileChanged(int id)
+{
+    if ( m_vaultModeActive ) {
+        return;
+    }
+    if ( id == m_envWatchId ) {
+        updateEnvStatus();
+        updateBatteryStatus();
+        return;
     }
-    // Start shutdown timer if connection is inactive
-    if ( !g_connectState && m_automaticShutdownEnabled && !automaticShutdownTimer->isActive() ) {
-        automaticShutdownTimer->start( AUTOMATIC_SHUTDOWNTIME );
+    if ( id == m_networkWatchId ) {
+        updateNetworkStatus();
+        return;
     }
+    int peerIndex = m_peerWatchIds.indexOf(id);
+    if ( peerIndex >= 0 )
+        updatePeerLatency(peerIndex);
 }
 
-/* Read dpinger service output file for peers */
+/* Refresh peer link quality, from prober or dpinger output files */
 void engineClass::peerLatency()
 {
-    QStringList peerStatusFileNames = { "/tmp/peer0","/tmp/peer1","/tmp/peer2","/tmp/peer3","/tmp/peer4", "/tmp/peer5", "/tmp/peer6", "/tmp/peer7", "/tmp/peer8", "/tmp/peer9" };
-
-    for (int i = 0; i < peerStatusFileNames.size(); i++) {
-        QString fileName=peerStatusFileNames.at(i).toLocal8Bit().constData();
-        QString entryLatency;
-        QFile peerLatencyFile( fileName );
-        if(!peerLatencyFile.exists()) {
-            qDebug() << "No latency file: " << fileName;
-        } else {
-            QString peerLatencyValue;
-            if (peerLatencyFile.open(QIODevice::ReadOnly | QIODevice::Text)){
-                QTextStream stream(&peerLatencyFile);
-                while (!stream.atEnd()){
-                    entryLatency = stream.readLine();
-                }
-            }
-            peerLatencyFile.close();
-            QStringList latencyElements = entryLatency.split(' ');
-            int latencyIntms = latencyElements[0].toInt()/1000;
-            m_peerLatencyValue[i] = QString::number(latencyIntms);
-        }
+    TRACE_SCOPE("engine::peerLatency");
+    for (int i = 0; i < m_peerModel->count(); i++) {
+        if ( m_latencyProber->isActive() )
+            peerLinkStatsChanged(i);
+        else
+            updatePeerLatency(i);
     }
+}
+
+/* dpinger fallback, no percentiles available */
+void engineClass::updatePeerLatency(int index)
+{
+    if ( m_latencyProber->isActive() )
+        return;
+    PingerSample sample;
+    if ( m_sensors.peerStatus(index, sample) )
+        m_peerModel->setLinkStats(index, int(sample.latencyUs / 1000), -1,
+                                  int(sample.deviationUs / 1000), int(sample.lossPercent));
     /* Peer latency */
-    if ( m_peerLatencyValue[0].toInt() > 0 ) {
-        m_peer_0_CallSignColor = mHighColor;
-        emit peer_0_NameColorChanged();
-    } else {
-        m_peer_0_CallSignColor = mMainColor;
-        emit peer_0_NameColorChanged();
-    }
-    if ( m_peerLatencyValue[1].toInt() > 0 ) {
-        m_peer_1_CallSignColor = mHighColor;
-        emit peer_1_NameColorChanged();
-    } else {
-        m_peer_1_CallSignColor = mMainColor;
-        emit peer_1_NameColorChanged();
-    }
-    if ( m_peerLatencyValue[2].toInt() > 0 ) {
-        m_peer_2_CallSignColor = mHighColor;
-        emit peer_2_NameColorChanged();
-    } else {
-        m_peer_2_CallSignColor = mMainColor;
-        emit peer_2_NameColorChanged();
-    }
-    if ( m_peerLatencyValue[3].toInt() > 0 ) {
-        m_peer_3_CallSignColor = mHighColor;
-        emit peer_3_NameColorChanged();
-    } else {
-        m_peer_3_CallSignColor = mMainColor;
-        emit peer_3_NameColorChanged();
-    }
-    if ( m_peerLatencyValue[4].toInt() > 0 ) {
-        m_peer_4_CallSignColor = mHighColor;
-        emit peer_4_NameColorChanged();
-    } else {
-        m_peer_4_CallSignColor = mMainColor;
-        emit peer_4_NameColorChanged();
-    }
-    if ( m_peerLatencyValue[5].toInt() > 0 ) {
-        m_peer_5_CallSignColor = mHighColor;
-        emit peer_5_NameColorChanged();
-    } else {
-        m_peer_5_CallSignColor = mMainColor;
-        emit peer_5_NameColorChanged();
-    }
-    if ( m_peerLatencyValue[6].toInt() > 0 ) {
-        m_peer_6_CallSignColor = mHighColor;
-        emit peer_6_NameColorChanged();
-    } else {
-        m_peer_6_CallSignColor = mMainColor;
-        emit peer_6_NameColorChanged();
-    }
-    if ( m_peerLatencyValue[7].toInt() > 0 ) {
-        m_peer_7_CallSignColor = mHighColor;
-        emit peer_7_NameColorChanged();
-    } else {
-        m_peer_7_CallSignColor = mMainColor;
-        emit peer_7_NameColorChanged();
-    }
-    if ( m_peerLatencyValue[8].toInt() > 0 ) {
-        m_peer_8_CallSignColor = mHighColor;
-        emit peer_8_NameColorChanged();
-    } else {
-        m_peer_8_CallSignColor = mMainColor;
-        emit peer_8_NameColorChanged();
-    }
-    if ( m_peerLatencyValue[9].toInt() > 0 ) {
-        m_peer_9_CallSignColor = mHighColor;
-        emit peer_9_NameColorChanged();
-    } else {
-        m_peer_9_CallSignColor = mMainColor;
-        emit peer_9_NameColorChanged();
-    }
+    if ( m_peerModel->peer(index).latency > 0 )
+        m_peerModel->setNameColor(index, mHighColor);
+    else
+        m_peerModel->setNameColor(index, mMainColor);
+}
+
+void engineClass::peerLinkStatsChanged(int index)
+{
+    if ( index >= m_latencyProber->peerCount() )
+        return;
+    const LinkStats &stats = m_latencyProber->stats(index);
+    if ( stats.samples == 0 )
+        return;
+    m_peerModel->setLinkStats(index, stats.p50Us < 0 ? 0 : stats.p50Us / 1000,
+                              stats.p95Us < 0 ? -1 : stats.p95Us / 1000,
+                              stats.jitterUs < 0 ? -1 : stats.jitterUs / 1000, stats.lossPercent);
+    if ( stats.p50Us >= 0 && stats.lossPercent < 100 )
+        m_peerModel->setNameColor(index, mHighColor);
+    else
+        m_peerModel->setNameColor(index, mMainColor);
 }
 
 
@@ -1120,108 +1122,21 @@ void engineClass::initEngine()
         return;
     }
 
-    int myOwnNodeId;
     g_connectState = false;
 
-    // Telemetry FIFO watcher
-    watcher = new QFileSystemWatcher();
-    watcher->addPath(TELEMETRY_FIFO_OUT);
-    QObject::connect(watcher, SIGNAL(fileChanged(QString)), this, SLOT(fifoChanged()));
+    // Telemetry FIFO reader, delivers one line at a time
+    m_telemetryFifoReader = new FifoReader(rootedPath(TELEMETRY_FIFO_OUT), this);
+    connect(m_telemetryFifoReader, &FifoReader::lineReceived, this, &engineClass::fifoChanged);
+    m_telemetryFifoReader->setRecorder(m_fifoRecorder, FIFO_CHANNEL_TELEMETRY);
 
     // Ping daemon
     fifoWrite("127.0.0.1,daemon_ping");
 
-    // Open telemetry FIFO
-    fifoIn.setFileName(TELEMETRY_FIFO_OUT);
-    if(!fifoIn.open(QIODevice::ReadOnly | QIODevice::Unbuffered | QIODevice::Text)) {
-        qDebug() << "error " << fifoIn.errorString();
-    }
-
-    // Init message fifo & watcher
+    // Init message fifo & reader (reader retries until daemon creates FIFO)
     fifoWrite(nodes.myNodeIp + ",message,init"); // nodes.myNodeIp
-    QFileSystemWatcher *msgWatcher = new QFileSystemWatcher();
-    msgWatcher->addPath(MESSAGE_RECEIVE_FIFO);
-    QObject::connect(msgWatcher, SIGNAL(fileChanged(QString)), this, SLOT(msgFifoChanged()));
-
-    // Open incoming message FIFO
-    msgFifoIn.setFileName(MESSAGE_RECEIVE_FIFO);
-    if(!msgFifoIn.open(QIODevice::ReadOnly | QIODevice::Unbuffered | QIODevice::Text)) {
-        qDebug() << "error" << msgFifoIn.errorString();
-    }
-
-    /* Activate contact buttons */
-    m_button_0_active = true;
-    emit button_0_activeChanged();
-    m_button_1_active = true;
-    emit button_1_activeChanged();
-    m_button_2_active = true;
-    emit button_2_activeChanged();
-    m_button_3_active = true;
-    emit button_3_activeChanged();
-    m_button_4_active = true;
-    emit button_4_activeChanged();
-    m_button_5_active = true;
-    emit button_5_activeChanged();
-    m_button_6_active = true;
-    emit button_6_activeChanged();
-    m_button_7_active = true;
-    emit button_7_activeChanged();
-    m_button_8_active = true;
-    emit button_8_activeChanged();
-    m_button_9_active = true;
-    emit button_9_activeChanged();
-
-    /* Disable my own contact button */
-    for (int x=0; x < NODECOUNT; x++ ) {
-
-        if ( nodes.node_name[x].compare( nodes.myNodeName ) == 0 )
-            myOwnNodeId = x;
-
-         if ( myOwnNodeId == x ) {
-             if ( x == 0 ) {
-                 m_button_0_active = false;
-                 emit button_0_activeChanged();
-             }
-             if ( x == 1 ) {
-                 m_button_1_active = false;
-                 emit button_1_activeChanged();
-             }
-             if ( x == 2 ) {
-                 m_button_2_active = false;
-                 emit button_2_activeChanged();
-             }
-             if ( x == 3 )  {
-                 m_button_3_active = false;
-                 emit button_3_activeChanged();
-             }
-             if ( x == 4 )  {
-                 m_button_4_active = false;
-                 emit button_4_activeChanged();
-             }
-             if ( x == 5 ) {
-                 m_button_5_active = false;
-                 emit button_5_activeChanged();
-             }
-             if ( x == 6 ) {
-                 m_button_6_active = false;
-                 emit button_6_activeChanged();
-             }
-             if ( x == 7 ) {
-                 m_button_7_active = false;
-                 emit button_7_activeChanged();
-             }
-             if ( x == 8 ) {
-                 m_button_8_active = false;
-                 emit button_8_activeChanged();
-             }
-             if ( x == 9 ) {
-                 m_button_9_active = false;
-                 emit button_9_activeChanged();
-             }
-         }
-    }
-    m_statusMessage = "Ready!";
-    emit statusMessageChanged();
+    m_messageFifoReader = new FifoReader(rootedPath(MESSAGE_RECEIVE_FIFO), this);
+    connect(m_messageFifoReader, &FifoReader::lineReceived, this, &engineClass::msgFifoChanged);
+    m_messageFifoReader->setRecorder(m_fifoRecorder, FIFO_CHANNEL_MESSAGE);
 }
 
 /* Msg quick buttons */
@@ -1263,241 +1178,252 @@ void engineClass::quickButtonSend(int sendCode)
 }
 
 /* Messaging fifo handler [pine] */
-int engineClass::msgFifoChanged()
-{
-    QTextStream in(&msgFifoIn);
-    QString line = in.readAll();
-    QStringList token = line.split(',');
-
-    /* macsec (WiP) */
-    QString secondToken = token[1];
-    if ( secondToken.contains("macsec_keyed") ) {
-        mMacsecKeyed = "LOADED";
-        emit macsecKeyedChanged();
-        mMacsecKeyValid = true;
-        emit macsecValidChanged();
-        return 0;
+int engineClass::msgFifoChanged(const QByteArray &line)
+{
+    TRACE_SCOPE("engine::msgFifoChanged");
+    FifoFrame frame;
+    FifoParseResult result = parseFifoFrame(std::string_view(line.constData(), line.size()), frame);
+    if ( result != FIFO_FRAME_OK ) {
+        m_malformedFrameCount++;
+        qWarning() << "Malformed message FIFO frame:" << fifoParseErrorString(result) << line;
+        return -1;
+    }
+
+    /* New commands: add to fifoMessageCommand() and handle here */
+    switch ( fifoMessageCommand(frame.command) ) {
+    case FIFO_MESSAGE_MACSEC_KEYED:
+        return msgMacsecKeyedCommand(frame);
+    case FIFO_MESSAGE_HSM_INSERT:
+        return msgHsmInsertCommand(frame);
+    case FIFO_MESSAGE_RING:
+        return msgRingCommand(frame);
+    case FIFO_MESSAGE_REMOTE_HANGUP:
+        return msgRemoteHangupCommand(frame);
+    case FIFO_MESSAGE_ANSWER_SUCCESS:
+        return msgAnswerSuccessCommand(frame);
+    case FIFO_MESSAGE_INITIATOR_DISCONNECT:
+        return msgInitiatorDisconnectCommand(frame);
+    case FIFO_MESSAGE_CLIENT_CONNECTED:
+        return msgClientConnectedCommand(frame);
+    case FIFO_MESSAGE_PING:
+        return msgPingCommand(frame);
+    case FIFO_MESSAGE_LED:
+        return msgLedCommand(frame);
+    case FIFO_MESSAGE_SONAR_PING:
+        return msgSonarPingCommand(frame);
+    case FIFO_MESSAGE_TEXT:
+        break;
+    }
+    /* Normal message to be shown. */
+    return msgTextMessage(frame);
+}
+
+/* macsec (WiP) */
+int engineClass::msgMacsecKeyedCommand(const FifoFrame &frame)
+{
+    Q_UNUSED(frame);
+    mMacsecKeyed = "LOADED";
+    emit macsecKeyedChanged();
+    mMacsecKeyValid = true;
+    emit macsecValidChanged();
+    return 0;
+}
+
+int engineClass::msgHsmInsertCommand(const FifoFrame &frame)
+{
+    Q_UNUSED(frame);
+    mMacsecKeyed = "KEYING";
+    emit macsecKeyedChanged();
+    return 0;
+}
+
+/* Indicate incoming audio request ('ring') */
+int engineClass::msgRingCommand(const FifoFrame &frame)
+{
+    Q_UNUSED(frame);
+    if ( m_deviceLocked == true ) {
+        lockDevice(UNLOCK_DEVICE);
+    }
+    m_callDialogVisible = true;
+    emit callDialogVisibleChanged();
+    m_hardware.vibrate(400, 90, 2);
+    m_hardware.blinkLed(LED_GREEN, RING_BLINK_INTERVAL, RING_BLINK_INTERVAL);
+    return 0;
+}
+
+int engineClass::msgRemoteHangupCommand(const FifoFrame &frame)
+{
+    Q_UNUSED(frame);
+    updateCallStatusIndicator("Remote hangup", "green", "transparent",LOG_AND_INDICATE);
+    eraseConnectionLabels();
+    m_callSignInsigniaImage = "";
+    m_insigniaLabelText = "";
+    m_insigniaLabelStateText = "";
+    emit callSignInsigniaImageChanged();
+    emit insigniaLabelTextChanged();
+    emit insigniaLabelStateTextChanged();
+    disconnectButton();
+    return 0;
+}
+
+int engineClass::msgAnswerSuccessCommand(const FifoFrame &frame)
+{
+    Q_UNUSED(frame);
+    updateCallStatusIndicator("Audio active", "lightgreen", "transparent",INDICATE_ONLY);
+    mAudioDeviceBusy = true;
+    return 0;
+}
+
+// Remote (who connected us) press 'terminate', we should do the same
+int engineClass::msgInitiatorDisconnectCommand(const FifoFrame &frame)
+{
+    Q_UNUSED(frame);
+    // Hangup to FIFO, continues in initiatorHangupReady()
+    QString hangupCommandString = g_connectedNodeIp + ",hangup";
+    fifoWrite( hangupCommandString );
+    expectFifoReply(CALL_INITIATOR_HANGUP, g_connectedNodeIp, "hangup_ready");
+    return 0;
+}
+
+// client_connected,[client_id];[client_ip];[client_name]
+int engineClass::msgClientConnectedCommand(const FifoFrame &frame)
+{
+    std::string_view args = frame.args;
+    std::string_view remoteId;
+    std::string_view remoteIp;
+    std::string_view remoteName;
+    if ( !nextFifoField(args, remoteId) || !nextFifoField(args, remoteIp) || !nextFifoField(args, remoteName) ) {
+        m_malformedFrameCount++;
+        qWarning() << "Malformed client_connected frame, expected id;ip;name";
+        return -1;
+    }
+    qDebug() << "** Remote client connected **";
+    if ( m_deviceLocked ) {
+        lockDevice(UNLOCK_DEVICE);
+    }
+    g_connectedNodeId = QString::fromUtf8(remoteId.data(), int(remoteId.size()));
+    g_connectedNodeIp = QString::fromUtf8(remoteIp.data(), int(remoteIp.size()));
+    g_connectState = true;
+    updatePowerState();
+    updateCallStatusIndicator(QString::fromUtf8(remoteName.data(), int(remoteName.size())) + " connected" , "lightgreen","transparent",LOG_AND_INDICATE);
+
+    // Light up green label for connected name
+    setIndicatorForIncomingConnection(g_connectedNodeIp);
+
+    // Search ID for connectedNodeId and activate insignia
+    int insigniaNodeId = nodes.node_id.lastIndexOf(g_connectedNodeId);
+    if ( insigniaNodeId != -1 )
+        activateInsignia(insigniaNodeId, "Incoming connection");
+
+    // Disable 'Go Secure' TODO: and Contacts until terminate
+    m_goSecureButton_active = false;
+    emit goSecureButton_activeChanged();
+
+    // Inbound OTP, remote is 10.10.0.2 (client) and I am 10.10.0.1 (server)
+    g_remoteOtpPeerIp = "10.10.0.2";
+
+    // Erase messaging
+    if ( m_messageEraseEnabled ) {
+        m_messageModel->clear();
+    }
+    return 0;
+}
+
+/* ping - pong */
+int engineClass::msgPingCommand(const FifoFrame &frame)
+{
+    Q_UNUSED(frame);
+    if ( g_connectState ) {
+        QString fifo_command = g_remoteOtpPeerIp + ",message,CommCheck [ " + mVoltage.value() + " ] [ " + mnetworkStatusLabelValue.value() +" ]";
+        fifoWrite(fifo_command);
     }
-    if ( secondToken.contains("hsm_insert") ) {
-        mMacsecKeyed = "KEYING";
-        emit macsecKeyedChanged();
+    return 0;
+}
+
+/* Red and green Led setting: Led[red|green][on|off] */
+int engineClass::msgLedCommand(const FifoFrame &frame)
+{
+    if ( !g_connectState )
         return 0;
+    bool red = frame.command.substr(0, 6) == "Ledred";
+    bool on = frame.command.substr(frame.command.size() - 2) == "on";
+    m_hardware.setLed(red ? LED_RED : LED_GREEN, on);
+    QString ledText = QString(red ? "Red" : "Green") + " led " + ( on ? "ON" : "OFF" );
+    QString fifo_command = g_remoteOtpPeerIp + ",message," + ledText + " [ " + mVoltage.value() + " ] [ " + mnetworkStatusLabelValue.value() +" ]";
+    fifoWrite(fifo_command);
+    return 0;
+}
+
+int engineClass::msgSonarPingCommand(const FifoFrame &frame)
+{
+    Q_UNUSED(frame);
+    if ( g_connectState ) {
+        if ( !mAudioDeviceBusy ) {
+            runExternalCmd("/bin/aplay", {"/etc/sonar.wav"});
+            QString fifo_command = g_remoteOtpPeerIp + ",message,Sonar ping played [ " + mVoltage.value() + " ] [ " + mnetworkStatusLabelValue.value() +" ]";
+            fifoWrite(fifo_command);
+        }
     }
+    return 0;
+}
 
-    /* Indicate incoming audio request ('ring') */
-    if ( token[1] == "ring" )
-    {
-       if ( m_deviceLocked == true ) {
-           lockDevice(UNLOCK_DEVICE);
-       }
-       m_callDialogVisible = true;
-       emit callDialogVisibleChanged();
-       runExternalCmd("/bin/pptk-vibrate", {"400","90","2"});
-       token[1]="";
-       return 0;
-    }
-
-       if ( token[1] == "remote_hangup") {
-           updateCallStatusIndicator("Remote hangup", "green", "transparent",LOG_AND_INDICATE);
-           token[1]="";
-           eraseConnectionLabels();
-           m_callSignInsigniaImage = "";
-           m_insigniaLabelText = "";
-           m_insigniaLabelStateText = "";
-           emit callSignInsigniaImageChanged();
-           emit insigniaLabelTextChanged();
-           emit insigniaLabelStateTextChanged();
-           disconnectButton();
-           return 0;
-       }
-
-       if ( token[1] == "answer_success") {
-           updateCallStatusIndicator("Audio active", "lightgreen", "transparent",INDICATE_ONLY);
-           token[1]="";
-           mAudioDeviceBusy = true;
-           return 0;
-       }
-
-       // Remote (who connected us) press 'terminate', we should do the same
-       if ( token[1] == "initiator_disconnect") {
-           // Hangup to FIFO
-           QString hangupCommandString = g_connectedNodeIp + ",hangup";
-           fifoWrite( hangupCommandString );
-           // Wait FIFO with timeout
-           if ( waitForFifoReply() == FIFO_TIMEOUT ) {
-               updateCallStatusIndicator("Timeout. Aborting.", "green", "transparent",LOG_ONLY );
-               return 0;
-           }
-           // Turn off local audio
-           hangupCommandString = "127.0.0.1,disconnect_audio";
-           fifoWrite( hangupCommandString );
-           updateCallStatusIndicator("Incoming Terminated", "lightgreen", "transparent",INDICATE_ONLY);
-           eraseConnectionLabels();
-           if ( m_messageEraseEnabled ) {
-               m_textMsgDisplay = "";
-               emit textMsgDisplayChanged();
-           }
-           g_connectState = false;
-           m_callSignInsigniaImage = "";
-           m_insigniaLabelText = "";
-           m_insigniaLabelStateText = "";
-           m_goSecureButton_active = false;
-           emit callSignInsigniaImageChanged();
-           emit insigniaLabelTextChanged();
-           emit insigniaLabelStateTextChanged();
-           emit goSecureButton_activeChanged();
-           m_callDialogVisible = false;
-           emit callDialogVisibleChanged();
-           // Return to main page
-           m_SwipeViewIndex = 0;
-           emit swipeViewIndexChanged();
-           token[1]="";
-           mAudioDeviceBusy = false;
-           return 0;
-       }
-
-       // client_connected,[client_id];[client_ip];[client_name]
-       if ( token[1].contains( "client_connected",Qt::CaseInsensitive ) ) {
-           qDebug() << "** Remote client connected **";
-           if ( m_deviceLocked ) {
-               lockDevice(UNLOCK_DEVICE);
-           }
-           QStringList remoteParameters = token[1].split(';');
-           g_connectedNodeId = remoteParameters[1];
-           g_connectedNodeIp = remoteParameters[2];
-           // remote name: remoteParameters[3]
-           g_connectState = true;
-           updateCallStatusIndicator(remoteParameters[3] + " connected" , "lightgreen","transparent",LOG_AND_INDICATE);
-           token[1]="";
-
-           // Light up green label for connected name
-           setIndicatorForIncomingConnection(remoteParameters[2]);
-
-           // Search ID for connectedNodeId and activate insignia
-           int insigniaNodeId=-1;
-           for (int x=0; x < NODECOUNT; x++ ) {
-               if ( nodes.node_id[x].compare( g_connectedNodeId ) == 0 )
-                   insigniaNodeId = x;
-           }
-           if ( insigniaNodeId != -1 )
-               activateInsignia(insigniaNodeId, "Incoming connection");
-
-           // Disable 'Go Secure' TODO: and Contacts until terminate
-           m_goSecureButton_active = false;
-           emit goSecureButton_activeChanged();
-
-           // Inbound OTP, remote is 10.10.0.2 (client) and I am 10.10.0.1 (server)
-           g_remoteOtpPeerIp = "10.10.0.2";
-
-           // Erase messaging
-           if ( m_messageEraseEnabled ) {
-               m_textMsgDisplay = "";
-               emit textMsgDisplayChanged();
-           }
-           return 0;
-       }
-
-       /* ping - pong */
-       if ( token[1] == "Ping") {
-           if ( g_connectState ) {
-               QString fifo_command = g_remoteOtpPeerIp + ",message,CommCheck [ " + mVoltage + " ] [ " + mnetworkStatusLabelValue +" ]";
-               fifoWrite(fifo_command);
-               return 0;
-           }
-       }
-       /* Red Led Setting */
-       if ( token[1] == "Ledredon") {
-           if ( g_connectState ) {
-               runExternalCmd("/bin/pptk-led", {"set", "red", "1"});
-               QString fifo_command = g_remoteOtpPeerIp + ",message,Red led ON [ " + mVoltage + " ] [ " + mnetworkStatusLabelValue +" ]";
-               fifoWrite(fifo_command);
-               return 0;
-           }
-       }
-       if ( token[1] == "Ledredoff") {
-           if ( g_connectState ) {
-               runExternalCmd("/bin/pptk-led", {"set", "red", "0"});
-               QString fifo_command = g_remoteOtpPeerIp + ",message,Red led OFF [ " + mVoltage + " ] [ " + mnetworkStatusLabelValue +" ]";
-               fifoWrite(fifo_command);
-               return 0;
-           }
-       }
-       /* Green Led Setting */
-       if ( token[1] == "Ledgreenon") {
-           if ( g_connectState ) {
-               runExternalCmd("/bin/pptk-led", {"set", "green", "1"});
-               QString fifo_command = g_remoteOtpPeerIp + ",message,Green led ON [ " + mVoltage + " ] [ " + mnetworkStatusLabelValue +" ]";
-               fifoWrite(fifo_command);
-               return 0;
-           }
-       }
-       if ( token[1] == "Ledgreenoff") {
-           if ( g_connectState ) {
-               runExternalCmd("/bin/pptk-led", {"set", "green", "0"});
-               QString fifo_command = g_remoteOtpPeerIp + ",message,Green led OFF [ " + mVoltage + " ] [ " + mnetworkStatusLabelValue +" ]";
-               fifoWrite(fifo_command);
-               return 0;
-           }
-       }
-       if ( token[1] == "SonarPing") {
-           if ( g_connectState ) {
-               if ( !mAudioDeviceBusy ) {
-                   runExternalCmd("/bin/aplay", {"/etc/sonar.wav"});
-                   QString fifo_command = g_remoteOtpPeerIp + ",message,Sonar ping played [ " + mVoltage + " ] [ " + mnetworkStatusLabelValue +" ]";
-                   fifoWrite(fifo_command);
-               }
-               return 0;
-           }
-       }
-       /* Normal message to be shown. */
-       if (token[1] != "" )
-       {
-           if ( g_connectState == true ) {
-               if ( m_deviceLocked == true ) {
-                   qDebug() << "Message received in locked mode";
-                   lockDevice(UNLOCK_DEVICE);
-               }
-               /* Swipe only unlocked */
-               if ( m_lockScreen_active == false ) {
-                   qDebug() << "Message received in m_lockScreen_active == false";
-                   m_SwipeViewIndex = 1;
-                   emit swipeViewIndexChanged();
-               }
-               /* Vibrate test */
-               runExternalCmd("/bin/pptk-vibrate", {"200","200","1"});
-               /* Display message */
-               token[1].replace( QChar(SUBSTITUTE_CHAR_CODE), "," );
-               m_textMsgDisplay = m_textMsgDisplay + "<br> <font color='" + mMessageColorRemote + "'>" + token[1] + "</font>";
-               emit textMsgDisplayChanged();
-               return 0;
-           }
-       }
-       return 0;
+int engineClass::msgTextMessage(const FifoFrame &frame)
+{
+    if ( g_connectState == true ) {
+        if ( m_deviceLocked == true ) {
+            qDebug() << "Message received in locked mode";
+            lockDevice(UNLOCK_DEVICE);
+        }
+        /* Swipe only unlocked */
+        if ( m_lockScreen_active == false ) {
+            qDebug() << "Message received in m_lockScreen_active == false";
+            m_SwipeViewIndex = 1;
+            emit swipeViewIndexChanged();
+        }
+        /* Vibrate test */
+        m_hardware.vibrate(200, 100, 1);
+        /* Display message */
+        QString message = QString::fromUtf8(frame.payload.data(), int(frame.payload.size()));
+        message.replace( QChar(SUBSTITUTE_CHAR_CODE), "," );
+        m_messageModel->append(MessageModel::MESSAGE_REMOTE, message);
+    }
+    return 0;
+}
+
+/* Remote pressed 'terminate' and our hangup was acknowledged */
+void engineClass::initiatorHangupReady()
+{
+    // Turn off local audio
+    QString hangupCommandString = "127.0.0.1,disconnect_audio";
+    fifoWrite( hangupCommandString );
+    updateCallStatusIndicator("Incoming Terminated", "lightgreen", "transparent",INDICATE_ONLY);
+    eraseConnectionLabels();
+    if ( m_messageEraseEnabled ) {
+        m_messageModel->clear();
+    }
+    g_connectState = false;
+    updatePowerState();
+    m_callSignInsigniaImage = "";
+    m_insigniaLabelText = "";
+    m_insigniaLabelStateText = "";
+    m_goSecureButton_active = false;
+    emit callSignInsigniaImageChanged();
+    emit insigniaLabelTextChanged();
+    emit insigniaLabelStateTextChanged();
+    emit goSecureButton_activeChanged();
+    m_callDialogVisible = false;
+    emit callDialogVisibleChanged();
+    m_hardware.setLed(LED_GREEN, false);
+    // Return to main page
+    m_SwipeViewIndex = 0;
+    emit swipeViewIndexChanged();
+    mAudioDeviceBusy = false;
 }
 
 void engineClass::eraseConnectionLabels()
 {
     // Erase green status
-    m_peer_0_connection_label = false;
-    m_peer_1_connection_label = false;
-    m_peer_2_connection_label = false;
-    m_peer_3_connection_label = false;
-    m_peer_4_connection_label = false;
-    m_peer_5_connection_label = false;
-    m_peer_6_connection_label = false;
-    m_peer_7_connection_label = false;
-    m_peer_8_connection_label = false;
-    m_peer_9_connection_label = false;
-    emit peer_0_LabelChanged();
-    emit peer_1_LabelChanged();
-    emit peer_2_LabelChanged();
-    emit peer_3_LabelChanged();
-    emit peer_4_LabelChanged();
-    emit peer_5_LabelChanged();
-    emit peer_6_LabelChanged();
-    emit peer_7_LabelChanged();
-    emit peer_8_LabelChanged();
-    emit peer_9_LabelChanged();
+    m_peerModel->clearLabels();
 }
 
 /* Incoming connection indicates who connected
@@ -1505,320 +1431,153 @@ void engineClass::eraseConnectionLabels()
 */
 void engineClass::setIndicatorForIncomingConnection(QString peerIp)
 {
-   eraseConnectionLabels();
-
-    int nodeNumber;
-    for (int x=0; x<NODECOUNT; x++) {
-      if(peerIp.compare(nodes.node_ip[x]) == 0) {
-          nodeNumber=x;
-      }
-    }
-    if( nodeNumber == 0 ) {
-          m_peer_0_connection_label = true;
-          emit peer_0_LabelChanged();
-          m_peer_0_connection_label_color = mMainColor;
-          emit peer_0_LabelColorChanged();
-    }
-    if( nodeNumber == 1 ) {
-          m_peer_1_connection_label = true;
-          emit peer_1_LabelChanged();
-          m_peer_1_connection_label_color = mMainColor;
-          emit peer_1_LabelColorChanged();
-    }
-    if( nodeNumber == 2 ) {
-          m_peer_2_connection_label = true;
-          emit peer_2_LabelChanged();
-          m_peer_2_connection_label_color = mMainColor;
-          emit peer_2_LabelColorChanged();
-    }
-    if( nodeNumber == 3 ) {
-          m_peer_3_connection_label = true;
-          emit peer_3_LabelChanged();
-          m_peer_3_connection_label_color = mMainColor;
-          emit peer_3_LabelColorChanged();
-    }
-    if( nodeNumber == 4 ) {
-          m_peer_4_connection_label = true;
-          emit peer_4_LabelChanged();
-          m_peer_4_connection_label_color = mMainColor;
-          emit peer_4_LabelColorChanged();
-    }
-    if( nodeNumber == 5 ) {
-          m_peer_5_connection_label = true;
-          emit peer_5_LabelChanged();
-          m_peer_5_connection_label_color = mMainColor;
-          emit peer_5_LabelColorChanged();
-    }
-    if( nodeNumber == 6 ) {
-          m_peer_6_connection_label = true;
-          emit peer_6_LabelChanged();
-          m_peer_6_connection_label_color = mMainColor;
-          emit peer_6_LabelColorChanged();
-    }
-    if( nodeNumber == 7 ) {
-          m_peer_7_connection_label = true;
-          emit peer_7_LabelChanged();
-          m_peer_7_connection_label_color = mMainColor;
-          emit peer_7_LabelColorChanged();
-    }
-    if( nodeNumber == 8 ) {
-          m_peer_8_connection_label = true;
-          emit peer_8_LabelChanged();
-          m_peer_8_connection_label_color = mMainColor;
-          emit peer_8_LabelColorChanged();
-    }
-    if( nodeNumber == 9 ) {
-          m_peer_9_connection_label = true;
-          emit peer_9_LabelChanged();
-          m_peer_9_connection_label_color = mMainColor;
-          emit peer_9_LabelColorChanged();
-    }
+    eraseConnectionLabels();
+    m_peerModel->setLabel(nodeIndexForIp(peerIp), true, mMainColor);
 }
 
+/* Commands are queued and flushed in batches by FifoWriter */
 void engineClass::fifoWrite(QString message)
 {
-    if ( fifoIn.isOpen() ) {
-        QTextStream in(&fifoIn);        // dummy read
-        QString line = in.readAll();    // dummy read
-    }
-    g_fifoReply = "";
-    QFile file(TELEMETRY_FIFO_IN);
-    if(!file.open(QIODevice::ReadWrite | QIODevice::Text)) {
-        qDebug() << "FIFO Write file open error" << file.errorString();
+    m_fifoWriter->write(message.toUtf8());
+}
+
+void engineClass::fifoBackpressureChanged(bool active)
+{
+    if ( active ) {
+        qDebug() << "Telemetry FIFO backpressure, queued bytes:" << m_fifoWriter->queuedBytes();
+        updateCallStatusIndicator("Telemetry busy", "green", "transparent",LOG_AND_INDICATE);
+    } else {
+        qDebug() << "Telemetry FIFO backpressure cleared";
     }
-    QTextStream out(&file);
-    out << message << Qt::endl;
-    file.close();
 }
 
 
 /* Telemetry FIFO [PINE] */
-int engineClass::fifoChanged()
+int engineClass::fifoChanged(const QByteArray &line)
 {
-    int nodeNumber;
-    QTextStream in(&fifoIn);
-    QString line = in.readAll();
-
-    if ( line.length() == 0 ) {
-        qDebug() << "EMPTY FIFO Received";
+    TRACE_SCOPE("engine::fifoChanged");
+    if ( line == "telemetryclient_is_alive" )
         return 0;
+
+    /* Reply of awaited peer completes the pending call control step (after status handling) */
+    CallControlState pendingState = m_callControlState;
+    FifoFrame frame;
+    FifoParseResult result = parseFifoFrame(std::string_view(line.constData(), line.size()), frame);
+    if ( result != FIFO_FRAME_OK ) {
+        m_malformedFrameCount++;
+        qWarning() << "Malformed telemetry FIFO frame:" << fifoParseErrorString(result) << line;
+        return -1;
     }
-    if(line.compare("telemetryclient_is_alive") == 0) {
-          g_fifoReply = "client_alive";
-    } else {
 
-        /* Main logic for telemetry fifo handling */
-        QStringList token = line.split(',');
-        g_fifoReply = token[1];
-        // qDebug() << "Telemetry FIFO received:  IP:" << token[0] << " Status: " << token[1];
-          if( token[1].compare("available") == 0 )
-          {
-              for (int x=0; x<NODECOUNT; x++) {
-                if(token[0].compare(nodes.node_ip[x]) == 0) {
-                    nodeNumber=x;
-                }
-              }
-              if( nodeNumber == 0 ) {
-                    connectAsClient(nodes.node_ip[nodeNumber], nodes.node_id[nodeNumber]);
-                    m_peer_0_connection_label = true;
-                    emit peer_0_LabelChanged();
-                    m_peer_0_connection_label_color = mMainColor;
-                    emit peer_0_LabelColorChanged();
-              }
-              if( nodeNumber == 1 ) {
-                    connectAsClient(nodes.node_ip[nodeNumber], nodes.node_id[nodeNumber]);
-                    m_peer_1_connection_label = true;
-                    emit peer_1_LabelChanged();
-                    m_peer_1_connection_label_color = mMainColor;
-                    emit peer_1_LabelColorChanged();
-              }
-              if( nodeNumber == 2 ) {
-                    connectAsClient(nodes.node_ip[nodeNumber], nodes.node_id[nodeNumber]);
-                    m_peer_2_connection_label = true;
-                    emit peer_2_LabelChanged();
-                    m_peer_2_connection_label_color = mMainColor;
-                    emit peer_2_LabelColorChanged();
-              }
-              if( nodeNumber == 3 ) {
-                    connectAsClient(nodes.node_ip[nodeNumber], nodes.node_id[nodeNumber]);
-                    m_peer_3_connection_label = true;
-                    emit peer_3_LabelChanged();
-                    m_peer_3_connection_label_color = mMainColor;
-                    emit peer_3_LabelColorChanged();
-              }
-              if( nodeNumber == 4 ) {
-                    connectAsClient(nodes.node_ip[nodeNumber], nodes.node_id[nodeNumber]);
-                    m_peer_4_connection_label = true;
-                    emit peer_4_LabelChanged();
-                    m_peer_4_connection_label_color = mMainColor;
-                    emit peer_4_LabelColorChanged();
-              }
-              if( nodeNumber == 5 ) {
-                    connectAsClient(nodes.node_ip[nodeNumber], nodes.node_id[nodeNumber]);
-                    m_peer_5_connection_label = true;
-                    emit peer_5_LabelChanged();
-                    m_peer_5_connection_label_color = mMainColor;
-                    emit peer_5_LabelColorChanged();
-              }
-              if( nodeNumber == 6 ) {
-                    connectAsClient(nodes.node_ip[nodeNumber], nodes.node_id[nodeNumber]);
-                    m_peer_6_connection_label = true;
-                    emit peer_6_LabelChanged();
-                    m_peer_6_connection_label_color = mMainColor;
-                    emit peer_6_LabelColorChanged();
-              }
-              if( nodeNumber == 7 ) {
-                    connectAsClient(nodes.node_ip[nodeNumber], nodes.node_id[nodeNumber]);
-                    m_peer_7_connection_label = true;
-                    emit peer_7_LabelChanged();
-                    m_peer_7_connection_label_color = mMainColor;
-                    emit peer_7_LabelColorChanged();
-              }
-              if( nodeNumber == 8 ) {
-                    connectAsClient(nodes.node_ip[nodeNumber], nodes.node_id[nodeNumber]);
-                    m_peer_8_connection_label = true;
-                    emit peer_8_LabelChanged();
-                    m_peer_8_connection_label_color = mMainColor;
-                    emit peer_8_LabelColorChanged();
-              }
-              if( nodeNumber == 9 ) {
-                    connectAsClient(nodes.node_ip[nodeNumber], nodes.node_id[nodeNumber]);
-                    m_peer_9_connection_label = true;
-                    emit peer_9_LabelChanged();
-                    m_peer_9_connection_label_color = mMainColor;
-                    emit peer_9_LabelColorChanged();
-              }
-          }
-          // TODO: Terminate should erase 'red ones'
-          if( token[1].compare("offline") == 0 )
-          {
-              for (int x=0; x<NODECOUNT; x++) {
-                if(token[0].compare(nodes.node_ip[x]) == 0) {
-                    nodeNumber=x;
-                }
-              }
-              if( nodeNumber == 0 ) {
-                  m_peer_0_connection_label = true;
-                  emit peer_0_LabelChanged();
-                  m_peer_0_connection_label_color = "red";
-                  emit peer_0_LabelColorChanged();
-              }
-              if( nodeNumber == 1 ) {
-                  m_peer_1_connection_label = true;
-                  emit peer_1_LabelChanged();
-                  m_peer_1_connection_label_color = "red";
-                  emit peer_1_LabelColorChanged();
-              }
-              if( nodeNumber == 2 ) {
-                  m_peer_2_connection_label = true;
-                  emit peer_2_LabelChanged();
-                  m_peer_2_connection_label_color = "red";
-                  emit peer_2_LabelColorChanged();
-              }
-              if( nodeNumber == 3 ) {
-                  m_peer_3_connection_label = true;
-                  emit peer_3_LabelChanged();
-                  m_peer_3_connection_label_color = "red";
-                  emit peer_3_LabelColorChanged();
-              }
-              if( nodeNumber == 4 ) {
-                  m_peer_4_connection_label = true;
-                  emit peer_4_LabelChanged();
-                  m_peer_4_connection_label_color = "red";
-                  emit peer_4_LabelColorChanged();
-              }
-              if( nodeNumber == 5 ) {
-                  m_peer_5_connection_label = true;
-                  emit peer_5_LabelChanged();
-                  m_peer_5_connection_label_color = "red";
-                  emit peer_5_LabelColorChanged();
-              }
-              if( nodeNumber == 6 ) {
-                  m_peer_6_connection_label = true;
-                  emit peer_6_LabelChanged();
-                  m_peer_6_connection_label_color = "red";
-                  emit peer_6_LabelColorChanged();
-              }
-              if( nodeNumber == 7 ) {
-                  m_peer_7_connection_label = true;
-                  emit peer_7_LabelChanged();
-                  m_peer_7_connection_label_color = "red";
-                  emit peer_7_LabelColorChanged();
-              }
-              if( nodeNumber == 8 ) {
-                  m_peer_8_connection_label = true;
-                  emit peer_8_LabelChanged();
-                  m_peer_8_connection_label_color = "red";
-                  emit peer_8_LabelColorChanged();
-              }
-              if( nodeNumber == 9 ) {
-                  m_peer_9_connection_label = true;
-                  emit peer_9_LabelChanged();
-                  m_peer_9_connection_label_color = "red";
-                  emit peer_9_LabelColorChanged();
-              }
-          }
-
-          if( token[1].compare("terminate_ready") == 0 )
-          {
-              updateCallStatusIndicator("OTP disconnected", "green", "transparent",INDICATE_ONLY );
-              eraseConnectionLabels();
-              m_callSignInsigniaImage = "";
-              m_insigniaLabelText = "";
-              m_insigniaLabelStateText = "";
-              emit callSignInsigniaImageChanged();
-              emit insigniaLabelTextChanged();
-              emit insigniaLabelStateTextChanged();
-              m_goSecureButton_active = false;
-              emit goSecureButton_activeChanged();
-          }
-          if( token[1].compare("busy") == 0 )
-          {
-              updateCallStatusIndicator("Remote busy", "green", "transparent",LOG_ONLY );
-          }
-          if( token[1].compare("offline") == 0 )
-          {
-              updateCallStatusIndicator("Remote offline", "green", "transparent",LOG_ONLY );
-          }
-      }
+    /* New status codes: add handler and register it here */
+    static constexpr FifoDispatchTable<FifoHandler, 4> telemetryStatus({{
+        { "available",          &engineClass::telemetryAvailableStatus },
+        { "offline",            &engineClass::telemetryOfflineStatus },
+        { "terminate_ready",    &engineClass::telemetryTerminateReadyStatus },
+        { "busy",               &engineClass::telemetryBusyStatus }
+    }});
+    static_assert(telemetryStatus.isPerfect(), "Telemetry FIFO status table has hash collisions");
+
+    FifoHandler handler = telemetryStatus.find(frame.command);
+    if ( handler )
+        (this->*handler)(frame);
+    if ( pendingState != CALL_IDLE && m_callControlState == pendingState && isFifoReply(frame) ) {
+        fifoReplyReceived();
+    }
 
     /* Other status codes (TODO):
-        busy
-        terminate_ready
         prepare_ready
         ring_ready
     */
     return 0;
 }
 
+/* Node index for peer ip of frame, -1 if not one of ours */
+int engineClass::nodeIndexForIp(std::string_view ip)
+{
+    QLatin1String peerIp(ip.data(), int(ip.size()));
+    for (int x=0; x<nodes.node_ip.size(); x++) {
+        if ( nodes.node_ip.at(x) == peerIp )
+            return x;
+    }
+    return -1;
+}
+
+int engineClass::nodeIndexForIp(const QString &ip)
+{
+    return nodes.node_ip.indexOf(ip);
+}
+
+int engineClass::telemetryAvailableStatus(const FifoFrame &frame)
+{
+    int nodeNumber = nodeIndexForIp(frame.peer);
+    if ( nodeNumber >= 0 ) {
+        connectAsClient(nodes.node_ip[nodeNumber], nodes.node_id[nodeNumber]);
+        m_peerModel->setLabel(nodeNumber, true, mMainColor);
+    }
+    return 0;
+}
+
+// TODO: Terminate should erase 'red ones'
+int engineClass::telemetryOfflineStatus(const FifoFrame &frame)
+{
+    m_peerModel->setLabel(nodeIndexForIp(frame.peer), true, "red");
+    updateCallStatusIndicator("Remote offline", "green", "transparent",LOG_ONLY );
+    return 0;
+}
+
+int engineClass::telemetryTerminateReadyStatus(const FifoFrame &frame)
+{
+    Q_UNUSED(frame);
+    updateCallStatusIndicator("OTP disconnected", "green", "transparent",INDICATE_ONLY );
+    eraseConnectionLabels();
+    m_callSignInsigniaImage = "";
+    m_insigniaLabelText = "";
+    m_insigniaLabelStateText = "";
+    emit callSignInsigniaImageChanged();
+    emit insigniaLabelTextChanged();
+    emit insigniaLabelStateTextChanged();
+    m_goSecureButton_active = false;
+    emit goSecureButton_activeChanged();
+    return 0;
+}
+
+int engineClass::telemetryBusyStatus(const FifoFrame &frame)
+{
+    Q_UNUSED(frame);
+    updateCallStatusIndicator("Remote busy", "green", "transparent",LOG_ONLY );
+    return 0;
+}
+
 /* Connect as client ('initiator') to peer ('as OTP server') */
 void engineClass::connectAsClient(QString nodeIp, QString nodeId)
 {
-    // 1. Send 'prepare' to recipient via FIFO
+    m_callControlNodeIp = nodeIp;
+    m_callControlNodeId = nodeId;
+
+    // 1. Send 'prepare' to recipient via FIFO, continues in connectAsClientPrepared()
     QString prepareFifoCmd = nodeIp + ",prepare";
     fifoWrite(prepareFifoCmd);
+    expectFifoReply(CALL_CONNECT_PREPARED, nodeIp, "prepare_ready");
+}
 
-    // Wait FIFO with timeout
-    if ( waitForFifoReply() == FIFO_TIMEOUT ) {
-        updateCallStatusIndicator("Timeout. Aborting.", "green", "transparent",LOG_ONLY );
-        return;
-    }
+void engineClass::connectAsClientPrepared()
+{
+    QString nodeIp = m_callControlNodeIp;
+    QString nodeId = m_callControlNodeId;
 
     updateCallStatusIndicator("Remote prepared", "black","yellow",LOG_AND_INDICATE);
 
     // 2. Start local service for OTP to targeted node as 'client' role
     QString serviceNameAsClient = "connect-with-"+nodeId+"-c.service";
-    qint64 pid;
-    QProcess process;
-    process.setProgram("systemctl");
-    process.setArguments({"start",serviceNameAsClient});
-    process.startDetached(&pid);
+    runExternalCmd("systemctl", {"start",serviceNameAsClient});
 
     // 3. Touch local file
-    touchLocalFile("/tmp/CLIENT_CALL_ACTIVE");
+    touchLocalFile(rootedPath(CLIENT_CALL_ACTIVE_FILE));
 
     // Now we should have OTP connectivity ready
     g_connectState = true;
+    updatePowerState();
     g_connectedNodeId = nodeId;
     g_connectedNodeIp = nodeIp;
 
@@ -1831,8 +1590,7 @@ void engineClass::connectAsClient(QString nodeIp, QString nodeId)
 
     // Erase messaging history
     if ( m_messageEraseEnabled ) {
-        m_textMsgDisplay = "";
-        emit textMsgDisplayChanged();
+        m_messageModel->clear();
     }
 
     // 4.5 We should disable Peer keys when connected (TODO)
@@ -1850,419 +1608,113 @@ void engineClass::connectAsClient(QString nodeIp, QString nodeId)
     // 6. Indicate remote peer UI that we're connected WORK IN PROGRESS!!
     QString informRemoteUi = nodeIp + ",message,client_connected;"+nodes.myNodeId+";"+nodes.myNodeIp+";"+nodes.myNodeName;
     fifoWrite(informRemoteUi);
-
-    // Wait FIFO with timeout
-    if ( waitForFifoReply() == FIFO_TIMEOUT ) {
-        updateCallStatusIndicator("Timeout. Aborting.", "green", "transparent",LOG_ONLY );
-        return;
-    }
+    expectFifoReply(CALL_CONNECT_INFORMED, nodeIp, "message_ready");
 
     // 7. Audio gets established by remote end sending 'answer'
     //    after 'Go Secure' is pressed. So it's actually remote peer
     //    who activates audio on this calling 'client' side (!)
 
-    // 8. After termination => terminate_ready
-
-}
-
-/* Disconnect from 'client' side */
-void engineClass::disconnectAsClient(QString nodeIp, QString nodeId)
-{
-    // 1. terminate to FIFO
-    QString terminateFifoCmd = nodeIp + ",terminate";
-    fifoWrite(terminateFifoCmd);
-
-    // Wait FIFO with timeout
-    if ( waitForFifoReply() == FIFO_TIMEOUT ) {
-        updateCallStatusIndicator("Timeout. Aborting.", "green", "transparent",LOG_ONLY );
-        return;
-    }
-
-    // 2a. stop local service for targeted node (as client)
-    QString serviceNameAsClient = "connect-with-"+nodeId+"-c.service";
-    qint64 pid;
-    QProcess process;
-    process.setProgram("systemctl");
-    process.setArguments({"stop",serviceNameAsClient});
-    process.startDetached(&pid);
-
-    // 2b. stop local service for targeted node (as server)
-    QString serviceNameAsServer = "connect-with-"+nodeId+"-s.service";
-    qint64 s_pid;
-    QProcess s_process;
-    s_process.setProgram("systemctl");
-    s_process.setArguments({"stop",serviceNameAsServer});
-    s_process.startDetached(&s_pid);
-
-    // 3. Remove status file
-    removeLocalFile("/tmp/CLIENT_CALL_ACTIVE");
-
-    // 4 Send UI message to remote for disconnect indications for remote UI
-    QString informRemoteUi = nodeIp + ",message,remote_hangup";
-    fifoWrite(informRemoteUi);
-
-    // Wait FIFO with timeout
-    if ( waitForFifoReply() == FIFO_TIMEOUT ) {
-        updateCallStatusIndicator("Timeout. Aborting.", "green", "transparent",LOG_ONLY );
-        return;
-    }
-
-    // 5. Terminate local audio (TODO)
-    // 'telemetryclient' knows how to terminate audio, based on how it's established (client or server)
-    QString terminateAudioFifoCmd = "127.0.0.1,disconnect_audio";
-    fifoWrite(terminateAudioFifoCmd);
-    g_connectState = false;
-    g_connectedNodeId = "";
-    g_connectedNodeIp = "";
-    g_remoteOtpPeerIp = "";
-
-}
-
-/* Go Secure button clicked ('Call') */
-void engineClass::on_goSecure_clicked()
-{
-    updateCallStatusIndicator("Waiting remote", "lightgreen","transparent",INDICATE_ONLY);
-    // This is shell script ring -> ring_ready
-    QString callString = g_connectedNodeIp + ",ring";
-    fifoWrite( callString );
-    // Wait FIFO with timeout
-    if ( waitForFifoReply() == FIFO_TIMEOUT ) {
-        updateCallStatusIndicator("Timeout. Aborting.", "green", "transparent",LOG_ONLY );
-        return;
-    }
-    // Ring also on UI
-    callString = g_connectedNodeIp + ",message,ring";
-    fifoWrite( callString );
-}
-
-// NOTE: Pine version does not use (yet) method & colors !!
-void engineClass::updateCallStatusIndicator(QString text, QString fontColor, QString backgroundColor, int logMethod )
-{
-    m_statusMessage = text;
-    emit statusMessageChanged();
-}
-void engineClass::touchLocalFile(QString filename)
-{
-    QFile touchFile(filename);
-    touchFile.open( QIODevice::WriteOnly);
-    touchFile.close();
-}
-void engineClass::removeLocalFile(QString filename)
-{
-    QFile file (filename);
-    file.remove();
-}
-
-/* Sample debug from QML side: eClass.debugThis('string') */
-void engineClass::debugThis(QString debugMessage)
-{
-    qDebug() << "Engine class debug: " << debugMessage;
-
-}
-
-void engineClass::powerOff()
-{
-    qint64 pid;
-    QProcess process;
-    process.setProgram("poweroff");
-    process.setArguments({"-f"});
-    process.startDetached(&pid);
-}
-
-QString engineClass::getPeer_0_Name()
-{
-    return m_peer_0_CallSign;
-}
-QString engineClass::getPeer_1_Name()
-{
-    return m_peer_1_CallSign;
-}
-QString engineClass::getPeer_2_Name()
-{
-    return m_peer_2_CallSign;
-}
-QString engineClass::getPeer_3_Name()
-{
-    return m_peer_3_CallSign;
-}
-QString engineClass::getPeer_4_Name()
-{
-    return m_peer_4_CallSign;
-}
-QString engineClass::getPeer_5_Name()
-{
-    return m_peer_5_CallSign;
-}
-QString engineClass::getPeer_6_Name()
-{
-    return m_peer_6_CallSign;
-}
-QString engineClass::getPeer_7_Name()
-{
-    return m_peer_7_CallSign;
-}
-QString engineClass::getPeer_8_Name()
-{
-    return m_peer_8_CallSign;
-}
-QString engineClass::getPeer_9_Name()
-{
-    return m_peer_9_CallSign;
-}
-
-
-QString engineClass::getPeer_0_NameColor()
-{
-    return m_peer_0_CallSignColor;
-}
-QString engineClass::getPeer_1_NameColor()
-{
-    return m_peer_1_CallSignColor;
-}
-QString engineClass::getPeer_2_NameColor()
-{
-    return m_peer_2_CallSignColor;
-}
-QString engineClass::getPeer_3_NameColor()
-{
-    return m_peer_3_CallSignColor;
-}
-QString engineClass::getPeer_4_NameColor()
-{
-    return m_peer_4_CallSignColor;
-}
-QString engineClass::getPeer_5_NameColor()
-{
-    return m_peer_5_CallSignColor;
-}
-QString engineClass::getPeer_6_NameColor()
-{
-    return m_peer_6_CallSignColor;
-}
-QString engineClass::getPeer_7_NameColor()
-{
-    return m_peer_7_CallSignColor;
-}
-QString engineClass::getPeer_8_NameColor()
-{
-    return m_peer_8_CallSignColor;
-}
-QString engineClass::getPeer_9_NameColor()
-{
-    return m_peer_9_CallSignColor;
-}
-
+    // 8. After termination => terminate_ready
 
-bool engineClass::getPeer_0_Label()
-{
-    return m_peer_0_connection_label;
 }
 
-bool engineClass::getPeer_1_Label()
-{
-    return m_peer_1_connection_label;
-}
-bool engineClass::getPeer_2_Label()
-{
-    return m_peer_2_connection_label;
-}
-bool engineClass::getPeer_3_Label()
-{
-    return m_peer_3_connection_label;
-}
-bool engineClass::getPeer_4_Label()
-{
-    return m_peer_4_connection_label;
-}
-bool engineClass::getPeer_5_Label()
-{
-    return m_peer_5_connection_label;
-}
-bool engineClass::getPeer_6_Label()
-{
-    return m_peer_6_connection_label;
-}
-bool engineClass::getPeer_7_Label()
-{
-    return m_peer_7_connection_label;
-}
-bool engineClass::getPeer_8_Label()
+/* Disconnect from 'client' side */
+void engineClass::disconnectAsClient(QString nodeIp, QString nodeId)
 {
-    return m_peer_8_connection_label;
+    m_callControlNodeIp = nodeIp;
+    m_callControlNodeId = nodeId;
+
+    // 1. terminate to FIFO, continues in disconnectAsClientTerminated()
+    QString terminateFifoCmd = nodeIp + ",terminate";
+    fifoWrite(terminateFifoCmd);
+    expectFifoReply(CALL_DISCONNECT_TERMINATED, nodeIp, "terminate_ready");
 }
-bool engineClass::getPeer_9_Label()
+
+void engineClass::disconnectAsClientTerminated()
 {
-    return m_peer_9_connection_label;
-}
+    QString nodeIp = m_callControlNodeIp;
+    QString nodeId = m_callControlNodeId;
 
+    // 2a. stop local service for targeted node (as client)
+    QString serviceNameAsClient = "connect-with-"+nodeId+"-c.service";
+    runExternalCmd("systemctl", {"stop",serviceNameAsClient});
 
-QString engineClass::getPeer_0_Label_color()
-{
-    return m_peer_0_connection_label_color;
-}
-QString engineClass::getPeer_1_Label_color()
-{
-    return m_peer_1_connection_label_color;
-}
-QString engineClass::getPeer_2_Label_color()
-{
-    return m_peer_2_connection_label_color;
-}
-QString engineClass::getPeer_3_Label_color()
-{
-    return m_peer_3_connection_label_color;
-}
-QString engineClass::getPeer_4_Label_color()
-{
-    return m_peer_4_connection_label_color;
-}
-QString engineClass::getPeer_5_Label_color()
-{
-    return m_peer_5_connection_label_color;
-}
-QString engineClass::getPeer_6_Label_color()
-{
-    return m_peer_6_connection_label_color;
-}
-QString engineClass::getPeer_7_Label_color()
-{
-    return m_peer_7_connection_label_color;
-}
-QString engineClass::getPeer_8_Label_color()
-{
-    return m_peer_8_connection_label_color;
-}
-QString engineClass::getPeer_9_Label_color()
-{
-    return m_peer_9_connection_label_color;
-}
+    // 2b. stop local service for targeted node (as server)
+    QString serviceNameAsServer = "connect-with-"+nodeId+"-s.service";
+    runExternalCmd("systemctl", {"stop",serviceNameAsServer});
 
+    // 3. Remove status file
+    removeLocalFile(rootedPath(CLIENT_CALL_ACTIVE_FILE));
 
-bool engineClass::getButton_0_active()
-{
-    return m_button_0_active;
-}
-bool engineClass::getButton_1_active()
-{
-    return m_button_1_active;
-}
-bool engineClass::getButton_2_active()
-{
-    return m_button_2_active;
-}
-bool engineClass::getButton_3_active()
-{
-    return m_button_3_active;
-}
-bool engineClass::getButton_4_active()
-{
-    return m_button_4_active;
-}
-bool engineClass::getButton_5_active()
-{
-    return m_button_5_active;
-}
-bool engineClass::getButton_6_active()
-{
-    return m_button_6_active;
-}
-bool engineClass::getButton_7_active()
-{
-    return m_button_7_active;
-}
-bool engineClass::getButton_8_active()
-{
-    return m_button_8_active;
-}
-bool engineClass::getButton_9_active()
-{
-    return m_button_9_active;
+    // 4 Send UI message to remote for disconnect indications for remote UI
+    QString informRemoteUi = nodeIp + ",message,remote_hangup";
+    fifoWrite(informRemoteUi);
+    expectFifoReply(CALL_DISCONNECT_INFORMED, nodeIp, "message_ready");
 }
 
-QString engineClass::getPeer_0_keyPercentage()
+void engineClass::disconnectAsClientInformed()
 {
-    QString keyValueString="";
-    if ( m_keyPersentage_incount[0] != "" ) {
-        keyValueString=m_keyPersentage_incount[0] + "/" + m_keyPersentage_outcount[0];
-    }
-    return keyValueString;
+    // 5. Terminate local audio (TODO)
+    // 'telemetryclient' knows how to terminate audio, based on how it's established (client or server)
+    QString terminateAudioFifoCmd = "127.0.0.1,disconnect_audio";
+    fifoWrite(terminateAudioFifoCmd);
+    updateCallStatusIndicator("Connection terminated.", "green", "transparent",LOG_AND_INDICATE);
+    resetCallState();
 }
 
-QString engineClass::getPeer_1_keyPercentage()
+/* Go Secure button clicked ('Call') */
+void engineClass::on_goSecure_clicked()
 {
-    QString keyValueString="";
-    if ( m_keyPersentage_incount[1] != "" ) {
-        keyValueString=m_keyPersentage_incount[1] + "/" + m_keyPersentage_outcount[1];
-    }
-    return keyValueString;
+    updateCallStatusIndicator("Waiting remote", "lightgreen","transparent",INDICATE_ONLY);
+    // This is shell script ring -> ring_ready, continues in goSecureRingReady()
+    QString callString = g_connectedNodeIp + ",ring";
+    fifoWrite( callString );
+    expectFifoReply(CALL_RING_READY, g_connectedNodeIp, "ring_ready");
 }
-QString engineClass::getPeer_2_keyPercentage()
+
+void engineClass::goSecureRingReady()
 {
-    QString keyValueString="";
-    if ( m_keyPersentage_incount[2] != "" ) {
-        keyValueString=m_keyPersentage_incount[2] + "/" + m_keyPersentage_outcount[2];
-    }
-    return keyValueString;
+    // Ring also on UI
+    QString callString = g_connectedNodeIp + ",message,ring";
+    fifoWrite( callString );
 }
-QString engineClass::getPeer_3_keyPercentage()
+
+// NOTE: Pine version does not use (yet) method & colors !!
+void engineClass::updateCallStatusIndicator(QString text, QString fontColor, QString backgroundColor, int logMethod )
 {
-    QString keyValueString="";
-    if ( m_keyPersentage_incount[3] != "" ) {
-        keyValueString=m_keyPersentage_incount[3] + "/" + m_keyPersentage_outcount[3];
-    }
-    return keyValueString;
+    m_statusMessage = text;
+    emit statusMessageChanged();
 }
-QString engineClass::getPeer_4_keyPercentage()
+void engineClass::touchLocalFile(QString filename)
 {
-    QString keyValueString="";
-    if ( m_keyPersentage_incount[4] != "" ) {
-        keyValueString=m_keyPersentage_incount[4] + "/" + m_keyPersentage_outcount[4];
-    }
-    return keyValueString;
+    QFile touchFile(filename);
+    touchFile.open( QIODevice::WriteOnly);
+    touchFile.close();
 }
-QString engineClass::getPeer_5_keyPercentage()
+void engineClass::removeLocalFile(QString filename)
 {
-    QString keyValueString="";
-    if ( m_keyPersentage_incount[5] != "" ) {
-        keyValueString=m_keyPersentage_incount[5] + "/" + m_keyPersentage_outcount[5];
-    }
-    return keyValueString;
+    QFile file (filename);
+    file.remove();
 }
 
-QString engineClass::getPeer_6_keyPercentage()
-{
-    QString keyValueString="";
-    if ( m_keyPersentage_incount[6] != "" ) {
-        keyValueString=m_keyPersentage_incount[6] + "/" + m_keyPersentage_outcount[6];
-    }
-    return keyValueString;
-}
-QString engineClass::getPeer_7_keyPercentage()
-{
-    QString keyValueString="";
-    if ( m_keyPersentage_incount[7] != "" ) {
-        keyValueString=m_keyPersentage_incount[7] + "/" + m_keyPersentage_outcount[7];
-    }
-    return keyValueString;
-}
-QString engineClass::getPeer_8_keyPercentage()
+/* Sample debug from QML side: eClass.debugThis('string') */
+void engineClass::debugThis(QString debugMessage)
 {
-    QString keyValueString="";
-    if ( m_keyPersentage_incount[8] != "" ) {
-        keyValueString=m_keyPersentage_incount[8] + "/" + m_keyPersentage_outcount[8];
-    }
-    return keyValueString;
+    qDebug() << "Engine class debug: " << debugMessage;
+
 }
-QString engineClass::getPeer_9_keyPercentage()
+
+void engineClass::powerOff()
 {
-    QString keyValueString="";
-    if ( m_keyPersentage_incount[9] != "" ) {
-        keyValueString=m_keyPersentage_incount[9] + "/" + m_keyPersentage_outcount[9];
-    }
-    return keyValueString;
+    if ( volumeSaveTimer->isActive() )
+        saveUserPreferences();
+    qint64 pid;
+    QProcess process;
+    process.setProgram("poweroff");
+    process.setArguments({"-f"});
+    process.startDetached(&pid);
 }
 
-
 bool engineClass::getTouchBlock_active()
 {
     return m_touchBlock_active;
@@ -2348,6 +1800,7 @@ void engineClass::onVaultProcessFinished()
 
 int engineClass::lockNumberEntry(int pinCodeNumber)
 {
+    TRACE_SCOPE("engine::lockNumberEntry");
     /* 99 is 'enter' */
     if ( pinCodeNumber == 99 ) {
 
@@ -2421,6 +1874,21 @@ QString engineClass::getLockScreenPinCode()
     return m_lockScreenPinCode;
 }
 
+PeerModel *engineClass::getPeerModel()
+{
+    return m_peerModel;
+}
+
+MessageModel *engineClass::getMessageModel()
+{
+    return m_messageModel;
+}
+
+WifiNetworkModel *engineClass::getWifiNetworkModel()
+{
+    return m_wifiNetworkModel;
+}
+
 bool engineClass::getGoSecureButton_active()
 {
     return m_goSecureButton_active;
@@ -2486,94 +1954,23 @@ QString engineClass::getNetworkStatusLabelColor()
 
 void engineClass::activateInsignia(int node_id, QString stateText)
 {
-    // Set insignia image (0=alpha etc)
-    if (node_id==0) {
-        m_callSignInsigniaImage="alpha.png";
-        m_insigniaLabelText=nodes.node_name[node_id];
-        m_insigniaLabelStateText=stateText;
-        emit callSignInsigniaImageChanged();
-        emit insigniaLabelTextChanged();
-        emit insigniaLabelStateTextChanged();
-    }
-    if (node_id==1) {
-        m_callSignInsigniaImage="bravo.png";
-        m_insigniaLabelText=nodes.node_name[node_id];
-        m_insigniaLabelStateText=stateText;
-        emit callSignInsigniaImageChanged();
-        emit insigniaLabelTextChanged();
-        emit insigniaLabelStateTextChanged();
-    }
-    if (node_id==2) {
-        m_callSignInsigniaImage="charlie.png";
-        m_insigniaLabelText=nodes.node_name[node_id];
-        m_insigniaLabelStateText=stateText;
-        emit callSignInsigniaImageChanged();
-        emit insigniaLabelTextChanged();
-        emit insigniaLabelStateTextChanged();
-    }
-    if (node_id==3) {
-        m_callSignInsigniaImage="delta.png";
-        m_insigniaLabelText=nodes.node_name[node_id];
-        m_insigniaLabelStateText=stateText;
-        emit callSignInsigniaImageChanged();
-        emit insigniaLabelTextChanged();
-        emit insigniaLabelStateTextChanged();
-    }
-    if (node_id==4) {
-        m_callSignInsigniaImage="echo.png";
-        m_insigniaLabelText=nodes.node_name[node_id];
-        m_insigniaLabelStateText=stateText;
-        emit callSignInsigniaImageChanged();
-        emit insigniaLabelTextChanged();
-        emit insigniaLabelStateTextChanged();
-    }
-    if (node_id==5) {
-        m_callSignInsigniaImage="foxrot.png";
-        m_insigniaLabelText=nodes.node_name[node_id];
-        m_insigniaLabelStateText=stateText;
-        emit callSignInsigniaImageChanged();
-        emit insigniaLabelTextChanged();
-        emit insigniaLabelStateTextChanged();
-    }
-    if (node_id==6) {
-        m_callSignInsigniaImage="golf.png";
-        m_insigniaLabelText=nodes.node_name[node_id];
-        m_insigniaLabelStateText=stateText;
-        emit callSignInsigniaImageChanged();
-        emit insigniaLabelTextChanged();
-        emit insigniaLabelStateTextChanged();
-    }
-    if (node_id==7) {
-        m_callSignInsigniaImage="hotel.png";
-        m_insigniaLabelText=nodes.node_name[node_id];
-        m_insigniaLabelStateText=stateText;
-        emit callSignInsigniaImageChanged();
-        emit insigniaLabelTextChanged();
-        emit insigniaLabelStateTextChanged();
-    }
-    if (node_id==8) {
-        m_callSignInsigniaImage="india.png";
-        m_insigniaLabelText=nodes.node_name[node_id];
-        m_insigniaLabelStateText=stateText;
-        emit callSignInsigniaImageChanged();
-        emit insigniaLabelTextChanged();
-        emit insigniaLabelStateTextChanged();
-    }
-    if (node_id==9) {
-        m_callSignInsigniaImage="juliet.png";
-        m_insigniaLabelText=nodes.node_name[node_id];
-        m_insigniaLabelStateText=stateText;
-        emit callSignInsigniaImageChanged();
-        emit insigniaLabelTextChanged();
-        emit insigniaLabelStateTextChanged();
-    }
-
-
+    // Set insignia image (0=alpha etc), wraps around after juliet
+    if ( node_id < 0 || node_id >= nodes.node_name.size() )
+        return;
+    m_callSignInsigniaImage=QString(ASSET_URL_PREFIX) + insigniaImages[node_id % INSIGNIA_COUNT];
+    m_insigniaLabelText=nodes.node_name[node_id];
+    m_insigniaLabelStateText=stateText;
+    emit callSignInsigniaImageChanged();
+    emit insigniaLabelTextChanged();
+    emit insigniaLabelStateTextChanged();
 }
 
 /* Connect to peer buttons pressed with ID */
 void engineClass::connectButton(int node_id)
 {
+    TRACE_SCOPE("engine::connectButton");
+    if ( node_id < 0 || node_id >= nodes.node_ip.size() )
+        return;
     eraseConnectionLabels();
     QString scanCmd = nodes.node_ip[node_id] + ",status";
     fifoWrite(scanCmd);
@@ -2586,29 +1983,14 @@ void engineClass::connectButton(int node_id)
 /* Terminate button */
 void engineClass::disconnectButton()
 {
+    /* Connected: UI is reset when telemetry has completed disconnect, in disconnectAsClientInformed() */
     if ( g_connectState ) {
+        updateCallStatusIndicator("Disconnecting", "green", "transparent",INDICATE_ONLY);
         disconnectAsClient(g_connectedNodeIp, g_connectedNodeId);
+        return;
     }
     updateCallStatusIndicator("Connection terminated.", "green", "transparent",LOG_AND_INDICATE);
-    m_callSignInsigniaImage = "";
-    m_insigniaLabelText = "";
-    m_insigniaLabelStateText = "";
-    emit callSignInsigniaImageChanged();
-    emit insigniaLabelTextChanged();
-    emit insigniaLabelStateTextChanged();
-    m_goSecureButton_active = false;
-    emit goSecureButton_activeChanged();
-    m_SwipeViewIndex = 0;
-    emit swipeViewIndexChanged();
-    if ( m_messageEraseEnabled ) {
-        m_textMsgDisplay = "";
-        emit textMsgDisplayChanged();
-    }
-    m_callDialogVisible = false;
-    emit callDialogVisibleChanged();
-    eraseConnectionLabels();
-    reloadKeyUsage();
-    mAudioDeviceBusy = false;
+    resetCallState();
 }
 
 /* Popup buttons for CALL dialog */
@@ -2619,23 +2001,21 @@ void engineClass::on_answerButton_clicked()
     // Send UI indication that we answered succesfully (TEST) WORK IN PROGRESS
     QString answerString = g_connectedNodeIp + ",message,answer_success";
     fifoWrite( answerString );
-    // Wait FIFO with timeout
-    if ( waitForFifoReply() == FIFO_TIMEOUT ) {
-        updateCallStatusIndicator("Timeout. Aborting.", "green", "transparent",LOG_ONLY );
-        return;
-    }
+    expectFifoReply(CALL_ANSWER_INDICATED, g_connectedNodeIp, "message_ready");
+}
 
+void engineClass::answerIndicated()
+{
     // Send answer to telemetry server
-    answerString = g_connectedNodeIp + ",answer";
+    QString answerString = g_connectedNodeIp + ",answer";
     fifoWrite( answerString );
-    // Wait FIFO with timeout
-    if ( waitForFifoReply() == FIFO_TIMEOUT ) {
-        updateCallStatusIndicator("Timeout. Aborting.", "green", "transparent",LOG_ONLY );
-        return;
-    }
+    expectFifoReply(CALL_ANSWERED, g_connectedNodeIp, "answer_ready");
+}
 
+void engineClass::answerAccepted()
+{
     // Connect audio as Server
-    answerString = "127.0.0.1,connect_audio_as_server";
+    QString answerString = "127.0.0.1,connect_audio_as_server";
     fifoWrite( answerString );
     updateCallStatusIndicator("Audio connected", "green","transparent",INDICATE_ONLY);
     mAudioDeviceBusy = true;
@@ -2645,20 +2025,20 @@ void engineClass::on_denyButton_clicked()
 {
     QString hangupCommandString = g_connectedNodeIp + ",hangup";
     fifoWrite( hangupCommandString );
+    expectFifoReply(CALL_DENY_HANGUP, g_connectedNodeIp, "hangup_ready");
+}
 
-    if ( waitForFifoReply() == FIFO_TIMEOUT ) {
-        updateCallStatusIndicator("Timeout. Aborting.", "green", "transparent",LOG_ONLY );
-        return;
-    }
-
+void engineClass::denyHangupReady()
+{
     // Turn off local audio
-    hangupCommandString = "127.0.0.1,disconnect_audio";
+    QString hangupCommandString = "127.0.0.1,disconnect_audio";
     fifoWrite( hangupCommandString );
     updateCallStatusIndicator("Incoming Terminated", "green","transparent",LOG_AND_INDICATE);
 
     // Erase gree status, insignia
     m_callDialogVisible = false;
     emit callDialogVisibleChanged();
+    m_hardware.setLed(LED_GREEN, false);
     eraseConnectionLabels();
     m_callSignInsigniaImage = "";
     m_insigniaLabelText = "";
@@ -2671,70 +2051,112 @@ void engineClass::on_denyButton_clicked()
 void engineClass::on_LineEdit_returnPressed(QString message)
 {
     if ( g_connectState ) {
-        m_textMsgDisplay = m_textMsgDisplay + "<br> <font color='" + mMessageColorLocal + "'>" + message + "</font>";
-        emit textMsgDisplayChanged();
+        m_messageModel->append(MessageModel::MESSAGE_LOCAL, message);
         message.replace( ",", QChar(SUBSTITUTE_CHAR_CODE) );
         QString fifo_command = g_remoteOtpPeerIp + ",message," + message;
         fifoWrite(fifo_command);
     } else {
-        m_textMsgDisplay = "<font color='#00ff00'>NOTE: You are not connected!</font>";
-        emit textMsgDisplayChanged();
+        m_messageModel->clear();
+        m_messageModel->append(MessageModel::MESSAGE_NOTICE, "NOTE: You are not connected!");
     }
 }
 
-/* Timeout for FIFO replies */
-int engineClass::waitForFifoReply() {
-    g_fifoCheckInProgress = true;
-    fifoReplyTimer = new QTimer(this);
-    fifoReplyTimer->start(10000); // 10 s
-    connect(fifoReplyTimer, SIGNAL(timeout()), this, SLOT(checkFifoReplyTimeout()) );
-
-        while ( g_fifoReply == "" && g_fifoCheckInProgress == true ) {
-            QCoreApplication::processEvents();
-            if ( g_fifoReply != "" ) {
-                fifoReplyTimer->stop();
-                return FIFO_REPLY_RECEIVED;
-            }
-        }
-
-    if ( g_fifoReply == "" && g_fifoCheckInProgress == false )
-        return FIFO_TIMEOUT;
+/* Call control: arm reply timeout and remember which step continues on reply.
+   Nothing spins here, control returns to event loop until fifoChanged()
+   sees "<peerIp>,<replyCode>" or fifoReplyTimer aborts the step. */
+void engineClass::expectFifoReply(CallControlState nextState, const QString &peerIp, const char *replyCode)
+{
+    if ( m_callControlState != CALL_IDLE ) {
+        qDebug() << "Call control step" << m_callControlState << "replaced by" << nextState;
+    }
+    m_callControlState = nextState;
+    m_callControlReplyIp = peerIp;
+    m_callControlReplyCode = replyCode;
+    fifoReplyTimer->start();
 }
 
-int engineClass::checkFifoReplyTimeout() {
-    g_fifoCheckInProgress = false;
-    fifoReplyTimer->stop();
-    return 0;
+/* Status lines of other peers and other codes leave the step pending */
+bool engineClass::isFifoReply(const FifoFrame &frame) const
+{
+    return frame.command == std::string_view(m_callControlReplyCode.constData(), m_callControlReplyCode.size())
+           && QLatin1String(frame.peer.data(), int(frame.peer.size())) == m_callControlReplyIp;
 }
 
-
-QString engineClass::getTextMsgDisplay()
+void engineClass::fifoReplyReceived()
 {
-    return m_textMsgDisplay;
+    TRACE_SCOPE("engine::fifoReplyReceived");
+    CallControlState state = m_callControlState;
+    m_callControlState = CALL_IDLE;
+    fifoReplyTimer->stop();
+
+    switch ( state ) {
+    case CALL_CONNECT_PREPARED:
+        connectAsClientPrepared();
+        break;
+    case CALL_DISCONNECT_TERMINATED:
+        disconnectAsClientTerminated();
+        break;
+    case CALL_DISCONNECT_INFORMED:
+        disconnectAsClientInformed();
+        break;
+    case CALL_RING_READY:
+        goSecureRingReady();
+        break;
+    case CALL_ANSWER_INDICATED:
+        answerIndicated();
+        break;
+    case CALL_ANSWERED:
+        answerAccepted();
+        break;
+    case CALL_DENY_HANGUP:
+        denyHangupReady();
+        break;
+    case CALL_INITIATOR_HANGUP:
+        initiatorHangupReady();
+        break;
+    case CALL_CONNECT_INFORMED:
+    case CALL_IDLE:
+        break;
+    }
 }
 
-long int engineClass::get_file_size(QString keyFilename)
+/* Timeout for FIFO replies, call is aborted and UI returns to idle */
+void engineClass::fifoReplyTimeout()
 {
-    long int size = 0;
-    QFile myFile(keyFilename);
-    if (myFile.open(QIODevice::ReadOnly)){
-        size = myFile.size();
-        myFile.close();
-        return size;
-    }
-    return -1;
+    qDebug() << "Call control step" << m_callControlState << "timed out waiting"
+             << m_callControlReplyIp << m_callControlReplyCode;
+    m_callControlState = CALL_IDLE;
+    resetCallState();
+    updateCallStatusIndicator("Timeout. Aborting.", "green", "transparent",LOG_AND_INDICATE );
 }
 
-long int engineClass::get_key_index(QString counterFilename)
+/* Not connected: connection globals, insignia, call dialog and labels back to idle */
+void engineClass::resetCallState()
 {
-    long int index=0;
-    FILE *keyindex_file;
-    std::string str = counterFilename.toStdString();
-    const char* filename = str.c_str();
-    keyindex_file = fopen(filename, "rb");
-    fread(&index, sizeof(long int),1,keyindex_file);
-    fclose(keyindex_file);
-    return index;
+    g_connectState = false;
+    updatePowerState();
+    g_connectedNodeId = "";
+    g_connectedNodeIp = "";
+    g_remoteOtpPeerIp = "";
+    m_callSignInsigniaImage = "";
+    m_insigniaLabelText = "";
+    m_insigniaLabelStateText = "";
+    emit callSignInsigniaImageChanged();
+    emit insigniaLabelTextChanged();
+    emit insigniaLabelStateTextChanged();
+    m_goSecureButton_active = false;
+    emit goSecureButton_activeChanged();
+    m_SwipeViewIndex = 0;
+    emit swipeViewIndexChanged();
+    if ( m_messageEraseEnabled ) {
+        m_messageModel->clear();
+    }
+    m_callDialogVisible = false;
+    emit callDialogVisibleChanged();
+    m_hardware.setLed(LED_GREEN, false);
+    eraseConnectionLabels();
+    m_keyUsage->refresh();
+    mAudioDeviceBusy = false;
 }
 
 /* WIFI */
@@ -2753,15 +2175,24 @@ QString engineClass::getWifiNotifyColor()
     return m_wifiNotifyColor;
 }
 
+/* iwd over D-Bus when available, helper scripts otherwise */
 void engineClass::wifiScanButton()
 {
     m_wifiStatusText = "Scanning...";
     emit wifiStatusTextChanged();
+    if ( m_iwdClient->scan() )
+        return;
     scanAvailableWifiNetworks("/opt/tunnel/wifi_getnetworks.sh",{""});
 }
 
 void engineClass::wifiConnectButton(QString ssid, QString psk)
 {
+    if ( m_iwdClient->isAvailable() ) {
+        m_wifiStatusText = "Connecting to " + ssid;
+        emit wifiStatusTextChanged();
+        m_iwdClient->connectNetwork(ssid, psk);
+        return;
+    }
     QStringList parameters={"--passphrase",psk,"station","wlan0","connect",ssid};
     connectWifiNetwork("iwctl", parameters);
     QTimer::singleShot(10000, this, SLOT( getWifiStatus() ));
@@ -2771,41 +2202,71 @@ void engineClass::wifiConnectButton(QString ssid, QString psk)
 
 void engineClass::wifiEraseAllConnection()
 {
-    QProcess process;
-    process.setProgram("/bin/nukewifi.sh");
-    process.setArguments({""});
-    process.start();
-    process.waitForFinished();
-    m_wifiStatusText = "Connections removed. Power off unit!";
+    m_processExecutor->run("/bin/nukewifi.sh", {""}, [this](const ProcessResult &result) {
+        Q_UNUSED(result);
+        m_wifiStatusText = "Connections removed. Power off unit!";
+        emit wifiStatusTextChanged();
+        m_wifiNotifyColor.set("#FF0000", this, &engineClass::wifiNotifyColorChanged);
+    });
+}
+
+void engineClass::wifiScanFinished(int count)
+{
+    m_wifiStatusText = "Scan ready, found " + QString::number( count ) + " networks.";
     emit wifiStatusTextChanged();
-    m_wifiNotifyColor = "#FF0000";
-    emit wifiNotifyColorChanged();
+}
 
+void engineClass::wifiStateChanged(const QString &state)
+{
+    if ( state == "connected" ) {
+        m_wifiStatusText = "Connected: " + m_iwdClient->connectedSsid();
+        m_wifiNotifyColor.set(mMainColor, this, &engineClass::wifiNotifyColorChanged);
+    } else {
+        m_wifiStatusText = state.isEmpty() ? "iwd not available" : state;
+    }
+    emit wifiStatusTextChanged();
 }
 
-QStringList engineClass::getWifiNetworks()
+void engineClass::wifiConnectFailed(const QString &error)
 {
-    return m_wifiNetworks;
+    m_wifiStatusText = "Connect failed: " + error;
+    emit wifiStatusTextChanged();
 }
 
+/* Repeated scan request replaces the one still running */
 void engineClass::scanAvailableWifiNetworks(QString command, QStringList parameters)
 {
-    QProcess process;
-    process.setProgram(command);
-    process.setArguments(parameters);
-    process.start();
-    process.waitForFinished();
-    QString result=process.readAllStandardOutput();
+    if ( m_wifiScanJob )
+        m_processExecutor->cancel(m_wifiScanJob);
+    m_wifiScanJob = m_processExecutor->run(command, parameters, [this](const ProcessResult &result) {
+        if ( result.id == m_wifiScanJob )
+            m_wifiScanJob = 0;
+        if ( result.cancelled )
+            return;
+        if ( result.timedOut ) {
+            m_wifiStatusText = "Scan timed out.";
+            emit wifiStatusTextChanged();
+            return;
+        }
+        wifiScanReady(QString::fromLocal8Bit(result.output));
+    });
+}
+
+void engineClass::wifiScanReady(const QString &result)
+{
     QString trimmedList = result.trimmed();
 
-    /*  TODO: Improve this after modified /opt/tunnel/wifi_getnetworks.sh
-        The SSID can be any alphanumeric, case-sensitive entry from 2 to 32 characters.
+    /*  The SSID can be any alphanumeric, case-sensitive entry from 2 to 32 characters.
         The printable characters plus the space (ASCII 0x20) are allowed,
         but these six characters are not: ?, ", $, [, \, ], and +.
+        One SSID per line keeps spaces, old space separated output
+        of /opt/tunnel/wifi_getnetworks.sh is still split on spaces.
     */
-    QStringList networks=trimmedList.split(" ");
-    m_wifiNetworks=trimmedList.split(" ");
-    emit wifiNetworksChanged();
+    QStringList networks = trimmedList.contains('\n') ? trimmedList.split('\n', Qt::SkipEmptyParts)
+                                                      : trimmedList.split(" ");
+    for (QString &network : networks)
+        network = network.trimmed();
+    m_wifiNetworkModel->setSsidList(networks);
     m_wifiStatusText = "Scan ready, found " + QString::number( networks.length() ) + " networks.";
     emit wifiStatusTextChanged();
 }
@@ -2819,62 +2280,49 @@ void engineClass::connectWifiNetwork(QString command, QStringList parameters)
 }
 void engineClass::getWifiStatus()
 {
-    QProcess process;
-    process.setProgram("/opt/tunnel/wifi_status.sh");
-    process.setArguments({""});
-    process.start();
-    process.waitForFinished();
-    QString result=process.readAllStandardOutput();
-    m_wifiStatusText = result;
-    emit wifiStatusTextChanged();
-
-    if ( result.contains( "connected",Qt::CaseInsensitive ) ) {
-        m_wifiNotifyColor = mMainColor;
-        emit wifiNotifyColorChanged();
+    if ( m_iwdClient->isAvailable() ) {
+        wifiStateChanged(m_iwdClient->state());
+        return;
     }
+    m_processExecutor->run("/opt/tunnel/wifi_status.sh", {""}, [this](const ProcessResult &process) {
+        if ( process.cancelled || process.timedOut )
+            return;
+        QString result = QString::fromLocal8Bit(process.output);
+        m_wifiStatusText = result;
+        emit wifiStatusTextChanged();
+
+        if ( result.contains( "connected",Qt::CaseInsensitive ) ) {
+            m_wifiNotifyColor.set(mMainColor, this, &engineClass::wifiNotifyColorChanged);
+        }
+    });
 }
 
+/* Called on every touch, deadline jobs notice restarted clocks when they fire */
 void engineClass::registerTouch()
 {
-    m_screenTimeoutCounter = DEVICE_LOCK_TIME;
+    m_touchClock.restart();
     if ( !g_connectState && m_automaticShutdownEnabled ) {
-        automaticShutdownTimer->start( AUTOMATIC_SHUTDOWNTIME );
+        if ( m_shutdownLimit == AUTOMATIC_SHUTDOWNTIME )
+            m_shutdownClock.restart();
+        else
+            armAutomaticShutdown( AUTOMATIC_SHUTDOWNTIME );
     }
 }
 
-void engineClass::getKnownWifiNetworks()
-{
-    QProcess process;
-    process.setProgram("/opt/tunnel/wifi_getknownnetworks.sh");
-    process.setArguments({""});
-    process.start();
-    process.waitForFinished();
-    QString result=process.readAllStandardOutput();
-    QString trimmedList = result.trimmed();
-    QStringList networks=trimmedList.split(" ");
-    // m_wifiNetworks=trimmedList.split(" ");
-    // emit wifiNetworksChanged();
-}
-
+/* Read when settings page first shows it */
 QString engineClass::getAboutTextContent()
 {
+    if ( m_aboutText.isNull() )
+        m_aboutText = readAboutText();
     return m_aboutText;
 }
 
-void engineClass::loadAboutText()
+QString engineClass::readAboutText()
 {
-    QString line;
     QFile file("/root/license.txt");
-    if(!file.open(QIODevice::ReadOnly)) {
-        m_aboutText = "license.txt missing";
-    }
-    QTextStream in(&file);
-    while(!in.atEnd()) {
-         line = in.readLine();
-         m_aboutText = m_aboutText + line + "\n";
-    }
-    file.close();
-    emit aboutTextContentChanged();
+    if ( !file.open(QIODevice::ReadOnly | QIODevice::Text) )
+        return "license.txt missing";
+    return QString::fromUtf8(file.readAll());
 }
 
 bool engineClass::deepSleepEnabled() const
@@ -2888,7 +2336,7 @@ void engineClass::setDeepSleepEnabled(bool newDeepSleepEnabled)
         return;
     m_deepSleepEnabled = newDeepSleepEnabled;
     emit deepSleepEnabledChanged();
-    QSettings settings(USER_PREF_INI_FILE,QSettings::IniFormat);
+    QSettings settings(rootedPath(USER_PREF_INI_FILE),QSettings::IniFormat);
     settings.setValue("deepsleep", m_deepSleepEnabled);
 }
 
@@ -2912,7 +2360,7 @@ void engineClass::setLteEnabled(bool newLteEnabled)
         return;
     m_lteEnabled = newLteEnabled;
     emit lteEnabledChanged();
-    QSettings settings(USER_PREF_INI_FILE,QSettings::IniFormat);
+    QSettings settings(rootedPath(USER_PREF_INI_FILE),QSettings::IniFormat);
     settings.setValue("lte", m_lteEnabled);
 }
 
@@ -2938,7 +2386,7 @@ void engineClass::setLteCellDisplayEnabled(bool newLteCellDisplayEnabled)
         return;
     m_lteCellDisplayEnabled = newLteCellDisplayEnabled;
     emit lteCellDisplayEnabledChanged();
-    QSettings settings(USER_PREF_INI_FILE,QSettings::IniFormat);
+    QSettings settings(rootedPath(USER_PREF_INI_FILE),QSettings::IniFormat);
     settings.setValue("celldisplay", m_lteCellDisplayEnabled);
 }
 
@@ -2971,7 +2419,7 @@ void engineClass::setMacsecPttEnabled(bool newPttValue)
         return;
     mMacsecPttEnabled = newPttValue;
     emit macsecPttEnabledChanged();
-    QSettings settings(USER_PREF_INI_FILE,QSettings::IniFormat);
+    QSettings settings(rootedPath(USER_PREF_INI_FILE),QSettings::IniFormat);
     settings.setValue("ptt", mMacsecPttEnabled);
 }
 
@@ -2991,7 +2439,7 @@ void engineClass::setLayer2Wifi(bool newLayer2Value)
         return;
     mLayer2WifiEnabled = newLayer2Value;
     emit layer2WifiChanged();
-    QSettings settings(USER_PREF_INI_FILE,QSettings::IniFormat);
+    QSettings settings(rootedPath(USER_PREF_INI_FILE),QSettings::IniFormat);
     settings.setValue("layer2wifi", mLayer2WifiEnabled);
     QSettings iwd_settings(IWD_MAIN_CONFIG_FILE,QSettings::IniFormat);
     iwd_settings.setValue("EnableNetworkConfiguration", !mLayer2WifiEnabled);
@@ -3003,26 +2451,20 @@ bool engineClass::getMacsecValid()
 }
 
 // Load APN from file and default to 'internet' if no file is present
-void engineClass::loadApnName()
+// Runs on startup pool, last line of apn.env is APN=<name>
+QString engineClass::readApnName()
 {
-    QString apnFromFile;
-    QString filename="/root/utils/apn.env";
-    QFile file(filename);
-    if(!file.exists()){
-        apnFromFile = "internet";
-    }
-    else {
-        if (file.open(QIODevice::ReadOnly | QIODevice::Text)){
-            QTextStream stream(&file);
-            while (!stream.atEnd()){
-                apnFromFile = stream.readLine();
-            }
-        }
-        file.close();
+    QString apnLine;
+    QFile file("/root/utils/apn.env");
+    if ( file.open(QIODevice::ReadOnly | QIODevice::Text) ) {
+        QTextStream stream(&file);
+        while ( !stream.atEnd() )
+            apnLine = stream.readLine();
     }
-    QStringList apnElements = apnFromFile.split('=');
-    mApnName = apnElements[1];
-    emit apnNameChanged();
+    int separator = apnLine.indexOf('=');
+    if ( separator < 0 )
+        return "internet";
+    return apnLine.mid(separator + 1);
 }
 
 /* Night mode */
@@ -3037,7 +2479,7 @@ void engineClass::setNightModeEnabled(bool newNightModeEnabled)
         return;
     m_nightModeEnabled = newNightModeEnabled;
     emit nightModeEnabledChanged();
-    QSettings settings(USER_PREF_INI_FILE,QSettings::IniFormat);
+    QSettings settings(rootedPath(USER_PREF_INI_FILE),QSettings::IniFormat);
     settings.setValue("nightmode", m_nightModeEnabled);
 }
 
@@ -3051,10 +2493,7 @@ void engineClass::changeNightModeEnabled(bool newNightModeEnabled)
         emit highColorChanged();
         mDimColor = "#cc2100";      //  #dd5300                     cc2100
         emit dimColorChanged();
-        m_wifiNotifyColor = mMainColor;
-        emit wifiNotifyColorChanged();
-        mMessageColorLocal = mDimColor;
-        mMessageColorRemote = mMainColor;
+        m_wifiNotifyColor.set(mMainColor, this, &engineClass::wifiNotifyColorChanged);
     }
     else {
                                     //  625 nm      green           640 nm
@@ -3064,11 +2503,11 @@ void engineClass::changeNightModeEnabled(bool newNightModeEnabled)
         emit highColorChanged();
         mDimColor = "#21cc00";      //  #dd5300                     cc2100
         emit dimColorChanged();
-        m_wifiNotifyColor = mMainColor;
-        emit wifiNotifyColorChanged();
-        mMessageColorLocal = mDimColor;
-        mMessageColorRemote = mMainColor;
+        m_wifiNotifyColor.set(mMainColor, this, &engineClass::wifiNotifyColorChanged);
     }
+    /* Colors of status labels follow new palette */
+    updateNetworkStatus();
+    peerLatency();
     setNightModeEnabled(newNightModeEnabled);
 }
 
@@ -3083,7 +2522,7 @@ void engineClass::setCallSignOnVaultEnabled(bool newCallSignOnVaultEnabled)
         return;
     m_callSignVisibleOnVaultPage = newCallSignOnVaultEnabled;
     emit callSignOnVaultEnabledChanged();
-    QSettings settings(PRE_VAULT_INI_FILE,QSettings::IniFormat);
+    QSettings settings(rootedPath(PRE_VAULT_INI_FILE),QSettings::IniFormat);
     settings.setValue("vaultpagecallsign", m_callSignVisibleOnVaultPage);
     settings.setValue("my_name", nodes.myNodeName);
 }
@@ -3099,7 +2538,7 @@ void engineClass::setMessageEraseEnabled(bool newMessageEraseEnabled)
         return;
     m_messageEraseEnabled = newMessageEraseEnabled;
     emit messageEraseEnabledChanged();
-    QSettings settings(PRE_VAULT_INI_FILE,QSettings::IniFormat);
+    QSettings settings(rootedPath(PRE_VAULT_INI_FILE),QSettings::IniFormat);
     settings.setValue("msg_erase", m_messageEraseEnabled);
 }
 
@@ -3115,13 +2554,13 @@ void engineClass::setAutomaticShutdownEnabled(bool newAutomaticShutdownEnabled)
         return;
     m_automaticShutdownEnabled = newAutomaticShutdownEnabled;
     emit automaticShutdownEnabledChanged();
-    QSettings settings(PRE_VAULT_INI_FILE,QSettings::IniFormat);
+    QSettings settings(rootedPath(PRE_VAULT_INI_FILE),QSettings::IniFormat);
     settings.setValue("automaticshutdown", m_automaticShutdownEnabled);
     if (m_automaticShutdownEnabled) {
-        automaticShutdownTimer->start( AUTOMATIC_SHUTDOWNTIME );
+        armAutomaticShutdown( AUTOMATIC_SHUTDOWNTIME );
     }
     if (!m_automaticShutdownEnabled) {
-        automaticShutdownTimer->stop();
+        disarmAutomaticShutdown();
     }
 }
 
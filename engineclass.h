@@ -20,18 +20,40 @@
 #define ENGINECLASS_H
 #include <QObject>
 #include <QFile>
-#include <QFileSystemWatcher>
 #include <QTimer>
 #include <QSocketNotifier>
 #include <QProcess>
 #include <QQmlPropertyMap>
+#include "fifowriter.h"
+#include "fiforeader.h"
+#include "fifoprotocol.h"
+#include "peermodel.h"
+#include "messagemodel.h"
+#include "propertycell.h"
+#include "sensorsampler.h"
+#include "statuswatcher.h"
+#include "tickscheduler.h"
+#include "hardwarecontrol.h"
+#include "mixercontrol.h"
+#include "processexecutor.h"
+#include "iwdclient.h"
+#include "netlinkmonitor.h"
+#include "latencyprober.h"
+#include "keyusage.h"
+#include "startuppipeline.h"
+#include "assetimageprovider.h"
+#include "wifinetworkmodel.h"
+#include <QElapsedTimer>
 
 #define PEER_COUNT  10
-#define NODECOUNT   10
 #define CONNPOINTCOUNT 3
 #define TELEMETRY_FIFO_IN       "/tmp/telemetry_fifo_in"
 #define TELEMETRY_FIFO_OUT      "/tmp/telemetry_fifo_out"
 #define MESSAGE_RECEIVE_FIFO    "/tmp/message_fifo_out"
+#define SETTINGS_INI_FILE       "/opt/tunnel/sinm.ini"
+#define FILE_ROOT_ENV           "QTUI_FILE_ROOT"    // prefix of FIFO, settings, key, preference and input device paths, for tests/bench
+#define EXTERNAL_COMMANDS_ENV   "QTUI_EXTERNAL_COMMANDS"    // "off" logs commands instead of running, for tests/bench
+#define BENCH_STARTUP_ENV       "QTUI_BENCH_STARTUP"        // startup bench of main(), baseline file
 #define DEVICE_LOCK_TIME        120
 
 
@@ -40,68 +62,17 @@ class engineClass : public QObject
     Q_OBJECT
 
 
-
     //                               c++ returns private variable:
     //                               return m_peerCallSign[0];
     //                               |
     //                 QML:          |                    c++ emit this signal if m_peerCallSign is updated
     //                 text: eClass.peerName              |
     //                 |             |                    |
-    Q_PROPERTY(QString peer_0_Name READ getPeer_0_Name() NOTIFY peer_0_NameChanged)
-    Q_PROPERTY(QString peer_1_Name READ getPeer_1_Name() NOTIFY peer_1_NameChanged)
-    Q_PROPERTY(QString peer_2_Name READ getPeer_2_Name() NOTIFY peer_2_NameChanged)
-    Q_PROPERTY(QString peer_3_Name READ getPeer_3_Name() NOTIFY peer_3_NameChanged)
-    Q_PROPERTY(QString peer_4_Name READ getPeer_4_Name() NOTIFY peer_4_NameChanged)
-    Q_PROPERTY(QString peer_5_Name READ getPeer_5_Name() NOTIFY peer_5_NameChanged)
-    Q_PROPERTY(QString peer_6_Name READ getPeer_6_Name() NOTIFY peer_6_NameChanged)
-    Q_PROPERTY(QString peer_7_Name READ getPeer_7_Name() NOTIFY peer_7_NameChanged)
-    Q_PROPERTY(QString peer_8_Name READ getPeer_8_Name() NOTIFY peer_8_NameChanged)
-    Q_PROPERTY(QString peer_9_Name READ getPeer_9_Name() NOTIFY peer_9_NameChanged)
-
-    Q_PROPERTY(QString peer_0_NameColor READ getPeer_0_NameColor() NOTIFY peer_0_NameColorChanged)
-    Q_PROPERTY(QString peer_1_NameColor READ getPeer_1_NameColor() NOTIFY peer_1_NameColorChanged)
-    Q_PROPERTY(QString peer_2_NameColor READ getPeer_2_NameColor() NOTIFY peer_2_NameColorChanged)
-    Q_PROPERTY(QString peer_3_NameColor READ getPeer_3_NameColor() NOTIFY peer_3_NameColorChanged)
-    Q_PROPERTY(QString peer_4_NameColor READ getPeer_4_NameColor() NOTIFY peer_4_NameColorChanged)
-    Q_PROPERTY(QString peer_5_NameColor READ getPeer_5_NameColor() NOTIFY peer_5_NameColorChanged)
-    Q_PROPERTY(QString peer_6_NameColor READ getPeer_6_NameColor() NOTIFY peer_6_NameColorChanged)
-    Q_PROPERTY(QString peer_7_NameColor READ getPeer_7_NameColor() NOTIFY peer_7_NameColorChanged)
-    Q_PROPERTY(QString peer_8_NameColor READ getPeer_8_NameColor() NOTIFY peer_8_NameColorChanged)
-    Q_PROPERTY(QString peer_9_NameColor READ getPeer_9_NameColor() NOTIFY peer_9_NameColorChanged)
-
-    Q_PROPERTY(bool peer_0_label READ getPeer_0_Label() NOTIFY peer_0_LabelChanged)
-    Q_PROPERTY(bool peer_1_label READ getPeer_1_Label() NOTIFY peer_1_LabelChanged)
-    Q_PROPERTY(bool peer_2_label READ getPeer_2_Label() NOTIFY peer_2_LabelChanged)
-    Q_PROPERTY(bool peer_3_label READ getPeer_3_Label() NOTIFY peer_3_LabelChanged)
-    Q_PROPERTY(bool peer_4_label READ getPeer_4_Label() NOTIFY peer_4_LabelChanged)
-    Q_PROPERTY(bool peer_5_label READ getPeer_5_Label() NOTIFY peer_5_LabelChanged)
-    Q_PROPERTY(bool peer_6_label READ getPeer_6_Label() NOTIFY peer_6_LabelChanged)
-    Q_PROPERTY(bool peer_7_label READ getPeer_7_Label() NOTIFY peer_7_LabelChanged)
-    Q_PROPERTY(bool peer_8_label READ getPeer_8_Label() NOTIFY peer_8_LabelChanged)
-    Q_PROPERTY(bool peer_9_label READ getPeer_9_Label() NOTIFY peer_9_LabelChanged)
-
-    Q_PROPERTY(QString peer_0_label_color READ getPeer_0_Label_color() NOTIFY peer_0_LabelColorChanged)
-    Q_PROPERTY(QString peer_1_label_color READ getPeer_1_Label_color() NOTIFY peer_1_LabelColorChanged)
-    Q_PROPERTY(QString peer_2_label_color READ getPeer_2_Label_color() NOTIFY peer_2_LabelColorChanged)
-    Q_PROPERTY(QString peer_3_label_color READ getPeer_3_Label_color() NOTIFY peer_3_LabelColorChanged)
-    Q_PROPERTY(QString peer_4_label_color READ getPeer_4_Label_color() NOTIFY peer_4_LabelColorChanged)
-    Q_PROPERTY(QString peer_5_label_color READ getPeer_5_Label_color() NOTIFY peer_5_LabelColorChanged)
-    Q_PROPERTY(QString peer_6_label_color READ getPeer_6_Label_color() NOTIFY peer_6_LabelColorChanged)
-    Q_PROPERTY(QString peer_7_label_color READ getPeer_7_Label_color() NOTIFY peer_7_LabelColorChanged)
-    Q_PROPERTY(QString peer_8_label_color READ getPeer_8_Label_color() NOTIFY peer_8_LabelColorChanged)
-    Q_PROPERTY(QString peer_9_label_color READ getPeer_9_Label_color() NOTIFY peer_9_LabelColorChanged)
-
-    Q_PROPERTY(bool button_0_active READ getButton_0_active() NOTIFY button_0_activeChanged)
-    Q_PROPERTY(bool button_1_active READ getButton_1_active() NOTIFY button_1_activeChanged)
-    Q_PROPERTY(bool button_2_active READ getButton_2_active() NOTIFY button_2_activeChanged)
-    Q_PROPERTY(bool button_3_active READ getButton_3_active() NOTIFY button_3_activeChanged)
-    Q_PROPERTY(bool button_4_active READ getButton_4_active() NOTIFY button_4_activeChanged)
-    Q_PROPERTY(bool button_5_active READ getButton_5_active() NOTIFY button_5_activeChanged)
-    Q_PROPERTY(bool button_6_active READ getButton_6_active() NOTIFY button_6_activeChanged)
-    Q_PROPERTY(bool button_7_active READ getButton_7_active() NOTIFY button_7_activeChanged)
-    Q_PROPERTY(bool button_8_active READ getButton_8_active() NOTIFY button_8_activeChanged)
-    Q_PROPERTY(bool button_9_active READ getButton_9_active() NOTIFY button_9_activeChanged)
 
+    // Peer roster: model rows for contact buttons and key status
+    Q_PROPERTY(PeerModel *peerModel READ getPeerModel CONSTANT)
+    // Message history rows for messaging page
+    Q_PROPERTY(MessageModel *messageModel READ getMessageModel CONSTANT)
     Q_PROPERTY(bool goSecureButton_active READ getGoSecureButton_active() NOTIFY goSecureButton_activeChanged)
     Q_PROPERTY(bool callDialogVisible READ getCallDialogVisible() NOTIFY callDialogVisibleChanged)
     Q_PROPERTY(QString statusMessage READ getStatusMessage() NOTIFY statusMessageChanged)
@@ -109,7 +80,6 @@ class engineClass : public QObject
     Q_PROPERTY(QString callSignInsigniaImage READ getCallSignInsigniaImage() NOTIFY callSignInsigniaImageChanged)
     Q_PROPERTY(QString insigniaLabelText READ getInsigniaLabelText() NOTIFY insigniaLabelTextChanged)
     Q_PROPERTY(QString insigniaLabelStateText READ getInsigniaLabelStateText() NOTIFY insigniaLabelStateTextChanged)
-    Q_PROPERTY(QString textMsgDisplay READ getTextMsgDisplay() NOTIFY textMsgDisplayChanged)
     Q_PROPERTY(int swipeViewIndex READ getSwipeViewIndex() NOTIFY swipeViewIndexChanged)
     Q_PROPERTY(QString voltageValue READ getVoltageValue() NOTIFY voltageValueChanged)
     Q_PROPERTY(QString voltageNotifyColor READ getVoltageNotifyColor() NOTIFY voltageNotifyColorChanged)
@@ -122,22 +92,11 @@ class engineClass : public QObject
     Q_PROPERTY(QString vaultScreenNotifyText READ getVaultScreenNotifyText() NOTIFY vaultScreenNotifyTextChanged)
     Q_PROPERTY(QString vaultScreenNotifyColor READ getVaultScreenNotifyColor() NOTIFY vaultScreenNotifyColorChanged)
     Q_PROPERTY(QString vaultScreenNotifyTextColor READ getVaultScreenNotifyTextColor() NOTIFY vaultScreenNotifyTextColorChanged)
-    // Key percentage
-    Q_PROPERTY(QString peer_0_keyPercentage READ getPeer_0_keyPercentage() NOTIFY peer_0_keyPercentageChanged)
-    Q_PROPERTY(QString peer_1_keyPercentage READ getPeer_1_keyPercentage() NOTIFY peer_1_keyPercentageChanged)
-    Q_PROPERTY(QString peer_2_keyPercentage READ getPeer_2_keyPercentage() NOTIFY peer_2_keyPercentageChanged)
-    Q_PROPERTY(QString peer_3_keyPercentage READ getPeer_3_keyPercentage() NOTIFY peer_3_keyPercentageChanged)
-    Q_PROPERTY(QString peer_4_keyPercentage READ getPeer_4_keyPercentage() NOTIFY peer_4_keyPercentageChanged)
-    Q_PROPERTY(QString peer_5_keyPercentage READ getPeer_5_keyPercentage() NOTIFY peer_5_keyPercentageChanged)
-    Q_PROPERTY(QString peer_6_keyPercentage READ getPeer_6_keyPercentage() NOTIFY peer_6_keyPercentageChanged)
-    Q_PROPERTY(QString peer_7_keyPercentage READ getPeer_7_keyPercentage() NOTIFY peer_7_keyPercentageChanged)
-    Q_PROPERTY(QString peer_8_keyPercentage READ getPeer_8_keyPercentage() NOTIFY peer_8_keyPercentageChanged)
-    Q_PROPERTY(QString peer_9_keyPercentage READ getPeer_9_keyPercentage() NOTIFY peer_9_keyPercentageChanged)
     // Pin code
     Q_PROPERTY(QString lockScreenPinCode READ getLockScreenPinCode() NOTIFY lockScreenPinCodeChanged)
     // Wifi
     Q_PROPERTY(QString wifiStatusText READ getWifiStatusText() NOTIFY wifiStatusTextChanged)
-    Q_PROPERTY(QStringList wifiNetworks READ getWifiNetworks() NOTIFY wifiNetworksChanged)
+    Q_PROPERTY(WifiNetworkModel *wifiNetworkModel READ getWifiNetworkModel CONSTANT)
     // Wifi notify on top bar
     Q_PROPERTY(QString wifiNotifyText READ getWifiNotifyText() NOTIFY wifiNotifyTextChanged)
     Q_PROPERTY(QString wifiNotifyColor READ getWifiNotifyColor() NOTIFY wifiNotifyColorChanged)
@@ -177,67 +136,16 @@ class engineClass : public QObject
     Q_PROPERTY(QString macsecKeyed READ getMacsecKeyed NOTIFY macsecKeyedChanged)
     Q_PROPERTY(bool layer2Wifi READ getLayer2Wifi WRITE setLayer2Wifi NOTIFY layer2WifiChanged)
     Q_PROPERTY(bool macsecValid READ getMacsecValid NOTIFY macsecValidChanged)
+    // Startup step timeline
+    Q_PROPERTY(QString startupTimeline READ getStartupTimeline NOTIFY startupTimelineChanged)
 
 public:
     explicit engineClass(QObject *parent = nullptr);
+    AssetCache *assetCache();
     Q_INVOKABLE void debugThis(QString debugMessage);
 
-    // Peers to buttons
-    Q_INVOKABLE QString getPeer_0_Name();
-    Q_INVOKABLE QString getPeer_1_Name();
-    Q_INVOKABLE QString getPeer_2_Name();
-    Q_INVOKABLE QString getPeer_3_Name();
-    Q_INVOKABLE QString getPeer_4_Name();
-    Q_INVOKABLE QString getPeer_5_Name();
-    Q_INVOKABLE QString getPeer_6_Name();
-    Q_INVOKABLE QString getPeer_7_Name();
-    Q_INVOKABLE QString getPeer_8_Name();
-    Q_INVOKABLE QString getPeer_9_Name();
-
-    Q_INVOKABLE QString getPeer_0_NameColor();
-    Q_INVOKABLE QString getPeer_1_NameColor();
-    Q_INVOKABLE QString getPeer_2_NameColor();
-    Q_INVOKABLE QString getPeer_3_NameColor();
-    Q_INVOKABLE QString getPeer_4_NameColor();
-    Q_INVOKABLE QString getPeer_5_NameColor();
-    Q_INVOKABLE QString getPeer_6_NameColor();
-    Q_INVOKABLE QString getPeer_7_NameColor();
-    Q_INVOKABLE QString getPeer_8_NameColor();
-    Q_INVOKABLE QString getPeer_9_NameColor();
-
-    Q_INVOKABLE bool getPeer_0_Label();
-    Q_INVOKABLE bool getPeer_1_Label();
-    Q_INVOKABLE bool getPeer_2_Label();
-    Q_INVOKABLE bool getPeer_3_Label();
-    Q_INVOKABLE bool getPeer_4_Label();
-    Q_INVOKABLE bool getPeer_5_Label();
-    Q_INVOKABLE bool getPeer_6_Label();
-    Q_INVOKABLE bool getPeer_7_Label();
-    Q_INVOKABLE bool getPeer_8_Label();
-    Q_INVOKABLE bool getPeer_9_Label();
-
-    Q_INVOKABLE QString getPeer_0_Label_color();
-    Q_INVOKABLE QString getPeer_1_Label_color();
-    Q_INVOKABLE QString getPeer_2_Label_color();
-    Q_INVOKABLE QString getPeer_3_Label_color();
-    Q_INVOKABLE QString getPeer_4_Label_color();
-    Q_INVOKABLE QString getPeer_5_Label_color();
-    Q_INVOKABLE QString getPeer_6_Label_color();
-    Q_INVOKABLE QString getPeer_7_Label_color();
-    Q_INVOKABLE QString getPeer_8_Label_color();
-    Q_INVOKABLE QString getPeer_9_Label_color();
-
-    Q_INVOKABLE bool getButton_0_active();
-    Q_INVOKABLE bool getButton_1_active();
-    Q_INVOKABLE bool getButton_2_active();
-    Q_INVOKABLE bool getButton_3_active();
-    Q_INVOKABLE bool getButton_4_active();
-    Q_INVOKABLE bool getButton_5_active();
-    Q_INVOKABLE bool getButton_6_active();
-    Q_INVOKABLE bool getButton_7_active();
-    Q_INVOKABLE bool getButton_8_active();
-    Q_INVOKABLE bool getButton_9_active();
 
+    PeerModel *getPeerModel();
     Q_INVOKABLE bool getGoSecureButton_active();
     Q_INVOKABLE QString getStatusMessage();
     Q_INVOKABLE QString getMyCallSign();
@@ -268,7 +176,8 @@ public:
 
     /* Messaging */
     Q_INVOKABLE void on_LineEdit_returnPressed(QString message);
-    Q_INVOKABLE QString getTextMsgDisplay();
+    MessageModel *getMessageModel();
+    WifiNetworkModel *getWifiNetworkModel();
 
     /* UI */
     Q_INVOKABLE int getSwipeViewIndex();
@@ -281,27 +190,17 @@ public:
     Q_INVOKABLE void powerOff();
     Q_INVOKABLE void quickButtonSend(int sendCode);
 
-    Q_INVOKABLE QString getPeer_0_keyPercentage();
-    Q_INVOKABLE QString getPeer_1_keyPercentage();
-    Q_INVOKABLE QString getPeer_2_keyPercentage();
-    Q_INVOKABLE QString getPeer_3_keyPercentage();
-    Q_INVOKABLE QString getPeer_4_keyPercentage();
-    Q_INVOKABLE QString getPeer_5_keyPercentage();
-    Q_INVOKABLE QString getPeer_6_keyPercentage();
-    Q_INVOKABLE QString getPeer_7_keyPercentage();
-    Q_INVOKABLE QString getPeer_8_keyPercentage();
-    Q_INVOKABLE QString getPeer_9_keyPercentage();
     Q_INVOKABLE QString getLockScreenPinCode();
 
     Q_INVOKABLE void wifiScanButton();
     Q_INVOKABLE void wifiConnectButton(QString ssid, QString psk);
     Q_INVOKABLE QString getWifiStatusText();
-    Q_INVOKABLE QStringList getWifiNetworks();
     Q_INVOKABLE void wifiEraseAllConnection();
     Q_INVOKABLE QString getWifiNotifyText();
     Q_INVOKABLE QString getWifiNotifyColor();
 
     Q_INVOKABLE QString getAboutTextContent();
+    Q_INVOKABLE QString getStartupTimeline();
     Q_INVOKABLE void getWifiStatus();
     Q_INVOKABLE void registerTouch();
 
@@ -360,60 +259,7 @@ public:
 
 
 private:
-    QString m_peer_0_CallSign="";
-    QString m_peer_1_CallSign="";
-    QString m_peer_2_CallSign="";
-    QString m_peer_3_CallSign="";
-    QString m_peer_4_CallSign="";
-    QString m_peer_5_CallSign="";
-    QString m_peer_6_CallSign="";
-    QString m_peer_7_CallSign="";
-    QString m_peer_8_CallSign="";
-    QString m_peer_9_CallSign="";
-
-    QString m_peer_0_CallSignColor="";
-    QString m_peer_1_CallSignColor="";
-    QString m_peer_2_CallSignColor="";
-    QString m_peer_3_CallSignColor="";
-    QString m_peer_4_CallSignColor="";
-    QString m_peer_5_CallSignColor="";
-    QString m_peer_6_CallSignColor="";
-    QString m_peer_7_CallSignColor="";
-    QString m_peer_8_CallSignColor="";
-    QString m_peer_9_CallSignColor="";
-
-    bool m_peer_0_connection_label = false;
-    bool m_peer_1_connection_label = false;
-    bool m_peer_2_connection_label = false;
-    bool m_peer_3_connection_label = false;
-    bool m_peer_4_connection_label = false;
-    bool m_peer_5_connection_label = false;
-    bool m_peer_6_connection_label = false;
-    bool m_peer_7_connection_label = false;
-    bool m_peer_8_connection_label = false;
-    bool m_peer_9_connection_label = false;
-
-    QString m_peer_0_connection_label_color = "green";
-    QString m_peer_1_connection_label_color = "green";
-    QString m_peer_2_connection_label_color = "green";
-    QString m_peer_3_connection_label_color = "green";
-    QString m_peer_4_connection_label_color = "green";
-    QString m_peer_5_connection_label_color = "green";
-    QString m_peer_6_connection_label_color = "green";
-    QString m_peer_7_connection_label_color = "green";
-    QString m_peer_8_connection_label_color = "green";
-    QString m_peer_9_connection_label_color = "green";
-
-    bool m_button_0_active=false;
-    bool m_button_1_active=false;
-    bool m_button_2_active=false;
-    bool m_button_3_active=false;
-    bool m_button_4_active=false;
-    bool m_button_5_active=false;
-    bool m_button_6_active=false;
-    bool m_button_7_active=false;
-    bool m_button_8_active=false;
-    bool m_button_9_active=false;
+
 
     bool m_goSecureButton_active=false;
     bool m_callDialogVisible=false;
@@ -421,20 +267,37 @@ private:
     QString m_callSignInsigniaImage="";
     QString m_insigniaLabelText="";
     QString m_insigniaLabelStateText="";
-    QString m_textMsgDisplay="";
     int m_SwipeViewIndex=0;
-    QString mVoltage;
-    QString mvoltageNotifyColor="#00FF00";
-    QString mnetworkStatusLabelValue="";
-    QString mnetworkStatusLabelColor="#00FF00";
+    PropertyCell<QString> mVoltage;
+    PropertyCell<QString> mvoltageNotifyColor=QString("#00FF00");
+    PropertyCell<QString> mnetworkStatusLabelValue;
+    PropertyCell<QString> mnetworkStatusLabelColor=QString("#00FF00");
+    /* Sensors and status files, last raw readings */
+    SensorSampler m_sensors;
+    HardwareControl m_hardware;
+    MixerControl m_mixer;
+    QTimer *volumeSaveTimer;
+    ProcessExecutor *m_processExecutor;
+    int m_wifiScanJob=0;
+    QString m_envVoltage;
+    int m_batteryPercent=-1;
+    BatteryState m_batteryState=BATTERY_UNKNOWN;
+    int m_networkLatencyMs=-1;
+    int m_networkLossPercent=-1;
+    LatencyProber *m_latencyProber;
+    StatusWatcher *m_statusWatcher;
+    int m_envWatchId=-1;
+    int m_networkWatchId=-1;
+    QVector<int> m_peerWatchIds;
+    KeyUsage *m_keyUsage;
     QString m_lockScreenPinCode;
 
     /* System preferences */
     struct SPreferences
     {
-        QString node_name[NODECOUNT];
-        QString node_ip[NODECOUNT];
-        QString node_id[NODECOUNT];
+        QStringList node_name;
+        QStringList node_ip;
+        QStringList node_id;
         QString myNodeId;
         QString myNodeIp;
         QString myNodeName;
@@ -445,21 +308,51 @@ private:
 
     };
     SPreferences nodes;
-    bool g_connectState;
+    static SPreferences readNodeSettings();
+    static QString readAboutText();
+    static QString readApnName();
+    void loadVaultSettings();
+    void applyNodeSettings(const SPreferences &settings);
+    void loadPeers();
+    void initEngine();
+    StartupPipeline *m_startup;
+    AssetCache m_assetCache;
+    void prewarmLockScreen();
+    bool g_connectState=false;
     QString g_connectedNodeId;
     QString g_connectedNodeIp;
     QString g_remoteOtpPeerIp;
-    QString g_fifoReply;
     double rxKeyRemaining;
     double txKeyRemaining;
     QString txKeyRemainingString;
     QString rxKeyRemainingString;
 
     /* FIFO */
-    QFile fifoIn;
-    QFile msgFifoIn;
-    QFileSystemWatcher *watcher;
-    QTimer *envTimer;
+    FifoReader *m_telemetryFifoReader;
+    FifoReader *m_messageFifoReader;
+    FifoRecorder *m_fifoRecorder=nullptr;
+    quint64 m_malformedFrameCount=0;
+    /* FIFO command handlers, status table of fifoChanged() and fifoMessageCommand() switch of msgFifoChanged() */
+    typedef int (engineClass::*FifoHandler)(const FifoFrame &frame);
+    int msgMacsecKeyedCommand(const FifoFrame &frame);
+    int msgHsmInsertCommand(const FifoFrame &frame);
+    int msgRingCommand(const FifoFrame &frame);
+    int msgRemoteHangupCommand(const FifoFrame &frame);
+    int msgAnswerSuccessCommand(const FifoFrame &frame);
+    int msgInitiatorDisconnectCommand(const FifoFrame &frame);
+    int msgClientConnectedCommand(const FifoFrame &frame);
+    int msgPingCommand(const FifoFrame &frame);
+    int msgLedCommand(const FifoFrame &frame);
+    int msgSonarPingCommand(const FifoFrame &frame);
+    int msgTextMessage(const FifoFrame &frame);
+    int telemetryAvailableStatus(const FifoFrame &frame);
+    int telemetryOfflineStatus(const FifoFrame &frame);
+    int telemetryTerminateReadyStatus(const FifoFrame &frame);
+    int telemetryBusyStatus(const FifoFrame &frame);
+    int nodeIndexForIp(std::string_view ip);
+    int nodeIndexForIp(const QString &ip);
+    bool isFifoReply(const FifoFrame &frame) const;
+    FifoWriter *m_fifoWriter;
 
     /* GPIO Notifier */
     QSocketNotifier * m_pwrButtonNotify;
@@ -469,27 +362,58 @@ private:
     int m_volButtonFileHandle;
     int m_hfPlugFileHandle;
     bool m_deviceLocked=false;
-    bool m_touchBlock_active=false;
+    PropertyCell<bool> m_touchBlock_active=false;
     bool m_lockScreen_active=true;
     bool m_camoScreen_active=false;
-    int m_screenTimeoutCounter=DEVICE_LOCK_TIME;
-    QString m_keyPersentage_incount[NODECOUNT];
-    QString m_keyPersentage_outcount[NODECOUNT];
-    QString m_peerLatencyValue[NODECOUNT];
+    TickScheduler *m_scheduler;
+    int m_envJob;
+    int m_proximityJob;
+    int m_probeJob;
+    int m_screenLockJob;
+    int m_shutdownJob;
+    QElapsedTimer m_touchClock;
+    QElapsedTimer m_shutdownClock;
+    qint64 m_shutdownLimit=0;       // ms, 0 when automatic shutdown is not armed
+    bool m_powerStateInCall=false;
+    void updatePowerState();
+    void armScreenLock();
+    void screenLockTimeout();
+    void armAutomaticShutdown(qint64 limit);
+    void disarmAutomaticShutdown();
+    PeerModel *m_peerModel;
+    MessageModel *m_messageModel;
+    WifiNetworkModel *m_wifiNetworkModel;
+    IwdClient *m_iwdClient;
     bool m_vaultModeActive=false;
     QString m_vaultNotifyText;
     QString m_vaultNotifyColor;
     QString m_vaultNotifyTextColor;
     /* Vault open */
     QProcess vaultOpenProcess;
+    /* Call control: every step waits one telemetry FIFO reply without blocking */
+    enum CallControlState {
+        CALL_IDLE,
+        CALL_CONNECT_PREPARED,
+        CALL_CONNECT_INFORMED,
+        CALL_DISCONNECT_TERMINATED,
+        CALL_DISCONNECT_INFORMED,
+        CALL_RING_READY,
+        CALL_ANSWER_INDICATED,
+        CALL_ANSWERED,
+        CALL_DENY_HANGUP,
+        CALL_INITIATOR_HANGUP
+    };
+    CallControlState m_callControlState=CALL_IDLE;
+    QString m_callControlNodeIp;
+    QString m_callControlNodeId;
+    QString m_callControlReplyIp;
+    QByteArray m_callControlReplyCode;
     QTimer *fifoReplyTimer;
-    bool g_fifoCheckInProgress;
     int m_SpeakerVolumeRuntimeValue=70;
     QString m_wifiStatusText;
 
-    QStringList m_wifiNetworks;
-    QString m_wifiNotifyText;
-    QString m_wifiNotifyColor;
+    PropertyCell<QString> m_wifiNotifyText;
+    PropertyCell<QString> m_wifiNotifyColor;
     QString m_aboutText;
 
     /* User preferences */
@@ -512,26 +436,23 @@ private:
     bool m_messageEraseEnabled=false;
     bool m_automaticShutdownEnabled=false;
 
-    QString mPlmn;
-    QString mTa;
-    QString mGc;
-    QString mSc;
-    QString mAc;
-    QString mRssi;
-    QString mRsrq;
-    QString mRsrp;
-    QString mSnr;
+    PropertyCell<QString> mPlmn;
+    PropertyCell<QString> mTa;
+    PropertyCell<QString> mGc;
+    PropertyCell<QString> mSc;
+    PropertyCell<QString> mAc;
+    PropertyCell<QString> mRssi;
+    PropertyCell<QString> mRsrq;
+    PropertyCell<QString> mRsrp;
+    PropertyCell<QString> mSnr;
 
     bool mPwrButtonReleased=false;
     bool mPwrButtonCycle=false;
     bool mPowerOffDialog=false;
-    QTimer *proximityTimer;
     int mBacklightLevel=50;
     QString mMainColor;
     QString mHighColor;
     QString mDimColor;
-    QString mMessageColorLocal;
-    QString mMessageColorRemote;
     bool mAudioDeviceBusy;
     bool mNukeCounterVisible;
     QString mNukeCounterText;
@@ -540,7 +461,7 @@ private:
     QTimer *nukeCountDownTimer;
     int nukeCountDownValue;
     QString mDefaultRouteInterface;
-    QString mMixerNameSpeaker;
+    NetlinkMonitor *m_netlinkMonitor;
     bool mHfIndicatorVisible;
     bool m_lteCellDisplayEnabled;
     QString mApnName;
@@ -548,21 +469,31 @@ private:
     QString mMacsecKeyed;
     bool mLayer2WifiEnabled;
     bool mMacsecKeyValid;
-    QTimer *automaticShutdownTimer;
-
 
 
 public slots:
-    void initEngine();
-    void loadSettings();
     void setVaultMode(bool vaultModeActive);
 
 private slots:
-    int fifoChanged();
-    int msgFifoChanged();
+    void startup();
+    void wifiScanFinished(int count);
+    void wifiStateChanged(const QString &state);
+    void wifiConnectFailed(const QString &error);
+    int fifoChanged(const QByteArray &line);
+    int msgFifoChanged(const QByteArray &line);
     void fifoWrite(QString message);
+    void fifoBackpressureChanged(bool active);
     void connectAsClient(QString nodeIp, QString nodeId);
+    void connectAsClientPrepared();
     void disconnectAsClient(QString nodeIp, QString nodeId);
+    void disconnectAsClientTerminated();
+    void disconnectAsClientInformed();
+    void goSecureRingReady();
+    void answerIndicated();
+    void answerAccepted();
+    void denyHangupReady();
+    void initiatorHangupReady();
+    void resetCallState();
     void updateCallStatusIndicator(QString text, QString fontColor, QString backgroundColor, int logMethod );
     void touchLocalFile(QString filename);
     void removeLocalFile(QString filename);
@@ -570,6 +501,11 @@ private slots:
     void eraseConnectionLabels();
     void activateInsignia(int node_id, QString stateText);
     void envTimerTick();
+    void updateEnvStatus();
+    void updateBatteryStatus();
+    void updateNetworkStatus();
+    void defaultRouteChanged(const QString &interfaceName);
+    void updateRouteIndicator();
     void readPwrGpioButton();
     void readPwrGpioButtonTimer();
     void readVolGpioButton();
@@ -577,92 +513,38 @@ private slots:
     void runExternalCmd(QString command, QStringList parameters );
     void runExternalCmdCaptureOutput(QString command, QStringList parameters);
     void lockDevice(bool state);
-    long int get_file_size(QString keyFilename);
-    long int get_key_index(QString counterFilename);
-    void reloadKeyUsage();
     void onVaultProcessReadyReadStdOutput();
     void onVaultProcessFinished();
     void exitVaultOpenProcess();
     void exitVaultOpenProcessWithFail();
     void peerLatency();
-    int waitForFifoReply();
-    int checkFifoReplyTimeout();
+    void updatePeerLatency(int index);
+    void peerLinkStatsChanged(int index);
+    void statusFileChanged(int id);
+    void keyUsageChanged(int index);
+    void expectFifoReply(CallControlState nextState, const QString &peerIp, const char *replyCode);
+    void fifoReplyReceived();
+    void fifoReplyTimeout();
     void setSystemVolume(int volume);
     void setMicrophoneVolume(int volume);
     void scanAvailableWifiNetworks(QString command, QStringList parameters);
+    void wifiScanReady(const QString &result);
     void connectWifiNetwork(QString command, QStringList parameters);
-    void getKnownWifiNetworks();
-    void loadAboutText();
     void proximityTimerTick();
     void readNukeTimer();
     void countNukeTimer();
     QString getDefaultRoute();
-    void loadApnName();
     void automaticShutdownTimeout();
 
 signals:
-    void peer_0_NameChanged();
-    void peer_1_NameChanged();
-    void peer_2_NameChanged();
-    void peer_3_NameChanged();
-    void peer_4_NameChanged();
-    void peer_5_NameChanged();
-    void peer_6_NameChanged();
-    void peer_7_NameChanged();
-    void peer_8_NameChanged();
-    void peer_9_NameChanged();
-
-    void peer_0_NameColorChanged();
-    void peer_1_NameColorChanged();
-    void peer_2_NameColorChanged();
-    void peer_3_NameColorChanged();
-    void peer_4_NameColorChanged();
-    void peer_5_NameColorChanged();
-    void peer_6_NameColorChanged();
-    void peer_7_NameColorChanged();
-    void peer_8_NameColorChanged();
-    void peer_9_NameColorChanged();
-
-    void peer_0_LabelChanged();
-    void peer_1_LabelChanged();
-    void peer_2_LabelChanged();
-    void peer_3_LabelChanged();
-    void peer_4_LabelChanged();
-    void peer_5_LabelChanged();
-    void peer_6_LabelChanged();
-    void peer_7_LabelChanged();
-    void peer_8_LabelChanged();
-    void peer_9_LabelChanged();
-
-    void peer_0_LabelColorChanged();
-    void peer_1_LabelColorChanged();
-    void peer_2_LabelColorChanged();
-    void peer_3_LabelColorChanged();
-    void peer_4_LabelColorChanged();
-    void peer_5_LabelColorChanged();
-    void peer_6_LabelColorChanged();
-    void peer_7_LabelColorChanged();
-    void peer_8_LabelColorChanged();
-    void peer_9_LabelColorChanged();
-
-    void button_0_activeChanged();
-    void button_1_activeChanged();
-    void button_2_activeChanged();
-    void button_3_activeChanged();
-    void button_4_activeChanged();
-    void button_5_activeChanged();
-    void button_6_activeChanged();
-    void button_7_activeChanged();
-    void button_8_activeChanged();
-    void button_9_activeChanged();
-
+    void startupTimelineChanged();
+    void startupFinished();
     void goSecureButton_activeChanged();
     void statusMessageChanged();
     void myCallSignChanged();
     void callSignInsigniaImageChanged();
     void insigniaLabelTextChanged();
     void insigniaLabelStateTextChanged();
-    void textMsgDisplayChanged();
     void swipeViewIndexChanged();
     void callDialogVisibleChanged();
     void voltageValueChanged();
@@ -670,18 +552,6 @@ signals:
     void networkStatusLabelChanged();
     void networkStatusLabelColorChanged();
     void touchBlock_activeChanged();
-
-    void peer_0_keyPercentageChanged();
-    void peer_1_keyPercentageChanged();
-    void peer_2_keyPercentageChanged();
-    void peer_3_keyPercentageChanged();
-    void peer_4_keyPercentageChanged();
-    void peer_5_keyPercentageChanged();
-    void peer_6_keyPercentageChanged();
-    void peer_7_keyPercentageChanged();
-    void peer_8_keyPercentageChanged();
-    void peer_9_keyPercentageChanged();
-
     void lockScreen_activeChanged();
     void lockScreenPinCodeChanged();
     void camoScreen_activeChanged();
@@ -690,7 +560,6 @@ signals:
     void vaultScreenNotifyColorChanged();
     void vaultScreenNotifyTextColorChanged();
     void wifiStatusTextChanged();
-    void wifiNetworksChanged();
     void wifiNotifyTextChanged();
     void wifiNotifyColorChanged();
     void aboutTextContentChanged();
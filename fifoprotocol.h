@@ -0,0 +1,249 @@
+/*  Small Pine phone QML interface for Out-Of-Band communication.
+
+    Copyright (C) 2023 Resilience Theatre
+
+    This program is free software; you can redistribute it and/or
+    modify it under the terms of the GNU General Public License
+    as published by the Free Software Foundation; either version 2
+    of the License, or (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; If not, see <http://www.gnu.org/licenses/>.
+
+    FIFO frame format:  [peer ip],[command][;arg;arg...]
+
+    Command field is everything up to next ',' and is matched as a
+    whole, ';' arguments included. Message FIFO text shares the field
+    (its ',' substituted by sender), so "ring;..." typed as chat is
+    never taken for ring.
+
+    Frames are tokenized as views into received line, nothing is
+    copied or allocated. Commands are routed with a dispatch table
+    which finds a collision free hash seed at compile time, so adding
+    a command is one new table entry.
+*/
+#ifndef FIFOPROTOCOL_H
+#define FIFOPROTOCOL_H
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+#define FIFO_DISPATCH_MAX_SEED  4096
+#define FIFO_DISPATCH_EMPTY     0xFF
+
+struct FifoFrame
+{
+    std::string_view peer;      // before first ','
+    std::string_view payload;   // everything after first ','
+    std::string_view command;   // payload up to next ',', arguments included
+    std::string_view args;      // command field after first ';'
+};
+
+enum FifoParseResult {
+    FIFO_FRAME_OK,
+    FIFO_FRAME_EMPTY,
+    FIFO_FRAME_NO_SEPARATOR,
+    FIFO_FRAME_NO_PEER,
+    FIFO_FRAME_NO_COMMAND
+};
+
+inline FifoParseResult parseFifoFrame(std::string_view line, FifoFrame &frame)
+{
+    while ( !line.empty() && ( line.back() == '\n' || line.back() == '\r' ) )
+        line.remove_suffix(1);
+    if ( line.empty() )
+        return FIFO_FRAME_EMPTY;
+    std::size_t comma = line.find(',');
+    if ( comma == std::string_view::npos )
+        return FIFO_FRAME_NO_SEPARATOR;
+    frame.peer = line.substr(0, comma);
+    frame.payload = line.substr(comma + 1);
+    if ( frame.peer.empty() )
+        return FIFO_FRAME_NO_PEER;
+    frame.command = frame.payload.substr(0, frame.payload.find(','));
+    std::size_t separator = frame.command.find(';');
+    if ( separator == std::string_view::npos )
+        frame.args = std::string_view();
+    else
+        frame.args = frame.command.substr(separator + 1);
+    if ( frame.command.empty() )
+        return FIFO_FRAME_NO_COMMAND;
+    return FIFO_FRAME_OK;
+}
+
+inline const char *fifoParseErrorString(FifoParseResult result)
+{
+    switch ( result ) {
+    case FIFO_FRAME_OK:
+        return "ok";
+    case FIFO_FRAME_EMPTY:
+        return "empty frame";
+    case FIFO_FRAME_NO_SEPARATOR:
+        return "missing ',' separator";
+    case FIFO_FRAME_NO_PEER:
+        return "missing peer";
+    case FIFO_FRAME_NO_COMMAND:
+        return "missing command";
+    }
+    return "unknown";
+}
+
+/* Next ';' separated field from args, returns false when none left */
+inline bool nextFifoField(std::string_view &args, std::string_view &field)
+{
+    if ( args.empty() )
+        return false;
+    std::size_t separator = args.find(';');
+    field = args.substr(0, separator);
+    if ( separator == std::string_view::npos )
+        args = std::string_view();
+    else
+        args = args.substr(separator + 1);
+    return true;
+}
+
+/* FNV-1a with seed */
+constexpr std::uint32_t fifoCommandHash(std::string_view command, std::uint32_t seed)
+{
+    std::uint32_t hash = 2166136261u ^ seed;
+    for (char c : command) {
+        hash ^= static_cast<unsigned char>(c);
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+/*
+    Compile time perfect hash table from command name to handler.
+    Declare as constexpr and static_assert(table.isPerfect()).
+    Handler{} (null or zero) is not found.
+*/
+template <typename Handler, std::size_t N, std::size_t Slots = 4 * N>
+class FifoDispatchTable
+{
+    static_assert(N < FIFO_DISPATCH_EMPTY, "Too many FIFO commands");
+
+public:
+    struct Entry
+    {
+        std::string_view command;
+        Handler handler;
+    };
+
+    constexpr explicit FifoDispatchTable(const std::array<Entry, N> &entries)
+        : m_entries(entries)
+    {
+        for (std::uint32_t seed = 1; seed < FIFO_DISPATCH_MAX_SEED; seed++) {
+            if ( build(seed) ) {
+                m_seed = seed;
+                return;
+            }
+        }
+    }
+
+    constexpr bool isPerfect() const
+    {
+        return m_seed != 0;
+    }
+
+    constexpr Handler find(std::string_view command) const
+    {
+        std::uint8_t index = m_slots[fifoCommandHash(command, m_seed) % Slots];
+        if ( index == FIFO_DISPATCH_EMPTY )
+            return Handler{};
+        if ( m_entries[index].command != command )
+            return Handler{};
+        return m_entries[index].handler;
+    }
+
+private:
+    constexpr bool build(std::uint32_t seed)
+    {
+        for (std::size_t x=0; x < Slots; x++)
+            m_slots[x] = FIFO_DISPATCH_EMPTY;
+        for (std::size_t x=0; x < N; x++) {
+            if ( m_entries[x].command.empty() || m_entries[x].handler == Handler{} )
+                return false;
+            std::size_t slot = fifoCommandHash(m_entries[x].command, seed) % Slots;
+            if ( m_slots[slot] != FIFO_DISPATCH_EMPTY )
+                return false;
+            m_slots[slot] = static_cast<std::uint8_t>(x);
+        }
+        return true;
+    }
+
+    std::array<Entry, N> m_entries;
+    std::array<std::uint8_t, Slots> m_slots {};
+    std::uint32_t m_seed = 0;
+};
+
+/* Message FIFO field classes, FIFO_MESSAGE_TEXT is chat text to show */
+enum FifoMessageCommand {
+    FIFO_MESSAGE_TEXT,
+    FIFO_MESSAGE_MACSEC_KEYED,
+    FIFO_MESSAGE_HSM_INSERT,
+    FIFO_MESSAGE_RING,
+    FIFO_MESSAGE_REMOTE_HANGUP,
+    FIFO_MESSAGE_ANSWER_SUCCESS,
+    FIFO_MESSAGE_INITIATOR_DISCONNECT,
+    FIFO_MESSAGE_CLIENT_CONNECTED,
+    FIFO_MESSAGE_PING,
+    FIFO_MESSAGE_LED,
+    FIFO_MESSAGE_SONAR_PING
+};
+
+inline bool fifoFieldContains(std::string_view field, std::string_view keyword, bool ignoreCase = false)
+{
+    if ( !ignoreCase )
+        return field.find(keyword) != std::string_view::npos;
+    for (std::size_t x=0; x + keyword.size() <= field.size(); x++) {
+        std::size_t y = 0;
+        while ( y < keyword.size() && ( field[x + y] | 0x20 ) == ( keyword[y] | 0x20 ) )
+            y++;
+        if ( y == keyword.size() )
+            return true;
+    }
+    return false;
+}
+
+/*
+    Plain commands must match whole command field, so chat text
+    starting with a command word stays text. macsec_keyed, hsm_insert
+    and client_connected (";id;ip;name" arguments) are matched anywhere
+    in field, as telemetryclient has always been read.
+*/
+inline FifoMessageCommand fifoMessageCommand(std::string_view command)
+{
+    static constexpr FifoDispatchTable<FifoMessageCommand, 10> exactCommands({{
+        { "ring",                   FIFO_MESSAGE_RING },
+        { "remote_hangup",          FIFO_MESSAGE_REMOTE_HANGUP },
+        { "answer_success",         FIFO_MESSAGE_ANSWER_SUCCESS },
+        { "initiator_disconnect",   FIFO_MESSAGE_INITIATOR_DISCONNECT },
+        { "Ping",                   FIFO_MESSAGE_PING },
+        { "Ledredon",               FIFO_MESSAGE_LED },
+        { "Ledredoff",              FIFO_MESSAGE_LED },
+        { "Ledgreenon",             FIFO_MESSAGE_LED },
+        { "Ledgreenoff",            FIFO_MESSAGE_LED },
+        { "SonarPing",              FIFO_MESSAGE_SONAR_PING }
+    }});
+    static_assert(exactCommands.isPerfect(), "Message FIFO command table has hash collisions");
+
+    if ( fifoFieldContains(command, "macsec_keyed") )
+        return FIFO_MESSAGE_MACSEC_KEYED;
+    if ( fifoFieldContains(command, "hsm_insert") )
+        return FIFO_MESSAGE_HSM_INSERT;
+    FifoMessageCommand exact = exactCommands.find(command);
+    if ( exact != FIFO_MESSAGE_TEXT )
+        return exact;
+    if ( fifoFieldContains(command, "client_connected", true) )
+        return FIFO_MESSAGE_CLIENT_CONNECTED;
+    return FIFO_MESSAGE_TEXT;
+}
+
+#endif // FIFOPROTOCOL_H
@@ -0,0 +1,151 @@
+/*
+    small Pinephone QML interface for Out-Of-Band communication.
+
+    Copyright (C) 2023 Resilience Theatre
+
+    This program is free software; you can redistribute it and/or
+    modify it under the terms of the GNU General Public License
+    as published by the Free Software Foundation; either version 2
+    of the License, or (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; If not, see <http://www.gnu.org/licenses/>.
+
+    NOTE:   Linux does not report POLLHUP for a freshly opened FIFO
+            which has not seen a writer yet, so after writer goes away
+            we simply close and reopen and wait for next writer.
+*/
+
+#include "fiforeader.h"
+#include <QDebug>
+#include <fcntl.h>
+#include <unistd.h>
+#include <errno.h>
+
+FifoReader::FifoReader(const QString &path, QObject *parent)
+    : QObject{parent}
+{
+    m_path = path.toLocal8Bit();
+    m_retryTimer = new QTimer(this);
+    m_retryTimer->setSingleShot(true);
+    m_retryTimer->setInterval(FIFO_READER_RETRY_INTERVAL);
+    connect(m_retryTimer, SIGNAL(timeout()), this, SLOT(openFifo()));
+    openFifo();
+}
+
+FifoReader::~FifoReader()
+{
+    closeFifo();
+}
+
+bool FifoReader::openFifo()
+{
+    if ( m_fd >= 0 )
+        return true;
+    m_fd = open(m_path.constData(), O_RDONLY | O_NONBLOCK | O_CLOEXEC);
+    if ( m_fd < 0 ) {
+        /* FIFO not created yet, try again later */
+        if ( !m_openWarned )
+            qErrnoWarning(errno, "Cannot open FIFO %s", m_path.constData());
+        m_openWarned = true;
+        m_retryTimer->start();
+        return false;
+    }
+    m_openWarned = false;
+    m_notifier = new QSocketNotifier(m_fd, QSocketNotifier::Read, this);
+    connect(m_notifier, SIGNAL(activated(int)), this, SLOT(readFifo()));
+    return true;
+}
+
+void FifoReader::closeFifo()
+{
+    if ( m_notifier ) {
+        m_notifier->setEnabled(false);
+        delete m_notifier;
+        m_notifier = nullptr;
+    }
+    if ( m_fd >= 0 ) {
+        close(m_fd);
+        m_fd = -1;
+    }
+}
+
+void FifoReader::readFifo()
+{
+    char chunk[FIFO_READER_CHUNK];
+
+    for (;;) {
+        ssize_t len = read(m_fd, chunk, sizeof(chunk));
+        if ( len > 0 ) {
+            m_buffer.append(chunk, len);
+            continue;
+        }
+        if ( len < 0 && errno == EINTR )
+            continue;
+        if ( len < 0 && ( errno == EAGAIN || errno == EWOULDBLOCK ) )
+            break;
+        if ( len < 0 )
+            qErrnoWarning(errno, "FIFO read error %s", m_path.constData());
+        /* Writer closed (or error): flush unterminated frame and reopen */
+        deliverLines();
+        if ( !m_buffer.isEmpty() ) {
+            deliverLine(m_buffer.constData(), m_buffer.size());
+            m_buffer.clear();
+        }
+        closeFifo();
+        openFifo();
+        return;
+    }
+    deliverLines();
+}
+
+/* Split reassembly buffer to complete lines, keep partial tail */
+void FifoReader::deliverLines()
+{
+    int start = 0;
+    int end;
+    while ( ( end = m_buffer.indexOf('\n', start) ) >= 0 ) {
+        deliverLine(m_buffer.constData() + start, end - start);
+        start = end + 1;
+    }
+    m_buffer.remove(0, start);
+    if ( m_buffer.size() > FIFO_READER_MAX_LINE ) {
+        qWarning() << "FIFO" << m_path << "line too long, dropped" << m_buffer.size() << "bytes";
+        m_buffer.clear();
+    }
+}
+
+/* setRawData() reuses m_line header unless receiver kept a copy */
+void FifoReader::deliverLine(const char *data, int size)
+{
+    if ( size > 0 && data[size - 1] == '\r' )
+        size--;
+    if ( size == 0 )
+        return;
+    m_line.setRawData(data, uint(size));
+    if ( m_recorder )
+        m_recorder->record(m_channel, m_line);
+    emit lineReceived(m_line);
+}
+
+bool FifoReader::isOpen() const
+{
+    return m_fd >= 0;
+}
+
+QString FifoReader::path() const
+{
+    return QString::fromLocal8Bit(m_path);
+}
+
+/* Record every delivered line, recorder is not owned */
+void FifoReader::setRecorder(FifoRecorder *recorder, FifoChannel channel)
+{
+    m_recorder = recorder;
+    m_channel = channel;
+}
@@ -0,0 +1,75 @@
+/*  Small Pine phone QML interface for Out-Of-Band communication.
+
+    Copyright (C) 2023 Resilience Theatre
+
+    This program is free software; you can redistribute it and/or
+    modify it under the terms of the GNU General Public License
+    as published by the Free Software Foundation; either version 2
+    of the License, or (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; If not, see <http://www.gnu.org/licenses/>.
+
+*/
+#ifndef FIFOREADER_H
+#define FIFOREADER_H
+#include <QObject>
+#include <QByteArray>
+#include <QSocketNotifier>
+#include <QTimer>
+#include "fiforecorder.h"
+
+#define FIFO_READER_CHUNK           4096
+#define FIFO_READER_MAX_LINE        (64 * 1024)
+#define FIFO_READER_RETRY_INTERVAL  1000
+
+/*
+    Inbound FIFO reader, one instance per FIFO. Reads are driven by
+    QSocketNotifier on a non-blocking fd and every complete line is
+    delivered separately with lineReceived(). When writer closes its
+    end, pending partial line is delivered and FIFO is reopened.
+
+    Delivered line is a raw data view to reassembly buffer, it is
+    valid only during lineReceived() and receivers copy what they
+    keep. No heap allocation is made per line.
+*/
+class FifoReader : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit FifoReader(const QString &path, QObject *parent = nullptr);
+    ~FifoReader();
+    bool isOpen() const;
+    QString path() const;
+    void setRecorder(FifoRecorder *recorder, FifoChannel channel);
+
+signals:
+    void lineReceived(const QByteArray &line);
+
+private slots:
+    void readFifo();
+    bool openFifo();
+
+private:
+    void closeFifo();
+    void deliverLines();
+    void deliverLine(const char *data, int size);
+
+    QByteArray m_path;
+    int m_fd=-1;
+    QSocketNotifier *m_notifier=nullptr;
+    QTimer *m_retryTimer;
+    bool m_openWarned=false;
+    QByteArray m_buffer;
+    QByteArray m_line;
+    FifoRecorder *m_recorder=nullptr;
+    FifoChannel m_channel=FIFO_CHANNEL_TELEMETRY;
+};
+
+#endif // FIFOREADER_H
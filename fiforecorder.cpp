@@ -0,0 +1,143 @@
+/*
+    small Pinephone QML interface for Out-Of-Band communication.
+
+    Copyright (C) 2023 Resilience Theatre
+
+    This program is free software; you can redistribute it and/or
+    modify it under the terms of the GNU General Public License
+    as published by the Free Software Foundation; either version 2
+    of the License, or (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "fiforecorder.h"
+#include <QDebug>
+
+static void appendVarint(QByteArray &buffer, quint64 value)
+{
+    while ( value >= 0x80 ) {
+        buffer.append(char(value | 0x80));
+        value >>= 7;
+    }
+    buffer.append(char(value));
+}
+
+FifoRecorder::FifoRecorder(const QString &path, QObject *parent)
+    : QObject{parent}, m_file(path)
+{
+    m_flushTimer = new QTimer(this);
+    m_flushTimer->setSingleShot(true);
+    m_flushTimer->setInterval(FIFO_RECORD_FLUSH_INTERVAL);
+    connect(m_flushTimer, &QTimer::timeout, this, &FifoRecorder::flush);
+    if ( !m_file.open(QIODevice::WriteOnly | QIODevice::Truncate | QIODevice::Unbuffered) ) {
+        qWarning() << "Cannot open FIFO recording" << path << m_file.errorString();
+        return;
+    }
+    m_buffer.reserve(FIFO_RECORD_FLUSH_BYTES);
+    m_buffer.append(FIFO_RECORD_MAGIC);
+    m_buffer.append(char(FIFO_RECORD_VERSION));
+    m_clock.start();
+    qDebug() << "Recording FIFO frames to" << path;
+}
+
+FifoRecorder::~FifoRecorder()
+{
+    flush();
+}
+
+bool FifoRecorder::isOpen() const
+{
+    return m_file.isOpen();
+}
+
+void FifoRecorder::record(FifoChannel channel, const QByteArray &line)
+{
+    if ( !m_file.isOpen() )
+        return;
+    qint64 now = m_clock.nsecsElapsed();
+    appendVarint(m_buffer, quint64(now - m_lastNsecs));
+    m_lastNsecs = now;
+    m_buffer.append(char(channel));
+    appendVarint(m_buffer, quint64(line.size()));
+    m_buffer.append(line);
+    m_frames++;
+    if ( m_buffer.size() >= FIFO_RECORD_FLUSH_BYTES )
+        flush();
+    else if ( !m_flushTimer->isActive() )
+        m_flushTimer->start();
+}
+
+quint64 FifoRecorder::frames() const
+{
+    return m_frames;
+}
+
+void FifoRecorder::flush()
+{
+    m_flushTimer->stop();
+    if ( !m_file.isOpen() || m_buffer.isEmpty() )
+        return;
+    if ( m_file.write(m_buffer) != m_buffer.size() )
+        qWarning() << "FIFO recording write failed:" << m_file.errorString();
+    m_buffer.clear();
+}
+
+FifoRecording::FifoRecording(const QString &path)
+{
+    QFile file(path);
+    if ( !file.open(QIODevice::ReadOnly) ) {
+        qWarning() << "Cannot open FIFO recording" << path << file.errorString();
+        return;
+    }
+    m_data = file.readAll();
+    int headerSize = int(sizeof(FIFO_RECORD_MAGIC) - 1) + 1;
+    if ( m_data.size() < headerSize || !m_data.startsWith(FIFO_RECORD_MAGIC)
+         || m_data.at(headerSize - 1) != char(FIFO_RECORD_VERSION) ) {
+        qWarning() << "Not a FIFO recording:" << path;
+        return;
+    }
+    m_offset = headerSize;
+    m_valid = true;
+}
+
+bool FifoRecording::isValid() const
+{
+    return m_valid;
+}
+
+/* False at end or on truncated frame, a log cut by power loss replays up to the cut */
+bool FifoRecording::next(FifoRecord &record)
+{
+    quint64 delta;
+    quint64 length;
+    if ( !m_valid || !readVarint(delta) || m_offset >= m_data.size() )
+        return false;
+    int channel = quint8(m_data.at(m_offset++));
+    if ( channel >= FIFO_CHANNEL_COUNT || !readVarint(length) || length > quint64(m_data.size() - m_offset) )
+        return false;
+    m_nsecs += qint64(delta);
+    record.nsecs = m_nsecs;
+    record.channel = FifoChannel(channel);
+    record.line = m_data.mid(m_offset, int(length));
+    m_offset += int(length);
+    return true;
+}
+
+bool FifoRecording::readVarint(quint64 &value)
+{
+    value = 0;
+    for (int shift=0; shift < 64 && m_offset < m_data.size(); shift += 7) {
+        quint8 byte = quint8(m_data.at(m_offset++));
+        value |= quint64(byte & 0x7f) << shift;
+        if ( !(byte & 0x80) )
+            return true;
+    }
+    return false;
+}
@@ -0,0 +1,96 @@
+/*  Small Pine phone QML interface for Out-Of-Band communication.
+
+    Copyright (C) 2023 Resilience Theatre
+
+    This program is free software; you can redistribute it and/or
+    modify it under the terms of the GNU General Public License
+    as published by the Free Software Foundation; either version 2
+    of the License, or (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; If not, see <http://www.gnu.org/licenses/>.
+
+*/
+#ifndef FIFORECORDER_H
+#define FIFORECORDER_H
+#include <QObject>
+#include <QFile>
+#include <QByteArray>
+#include <QElapsedTimer>
+#include <QTimer>
+
+#define FIFO_RECORD_ENV             "QTUI_FIFO_RECORD"  // log path, recording is off when unset
+#define FIFO_RECORD_MAGIC           "QTFR"
+#define FIFO_RECORD_VERSION         1
+#define FIFO_RECORD_FLUSH_BYTES     (64 * 1024)
+#define FIFO_RECORD_FLUSH_INTERVAL  1000
+
+enum FifoChannel {
+    FIFO_CHANNEL_TELEMETRY,
+    FIFO_CHANNEL_MESSAGE,
+    FIFO_CHANNEL_COUNT
+};
+
+/*
+    Inbound FIFO frames to a compact binary log for replay:
+
+        header  "QTFR", u8 version
+        frame   varint ns since previous frame, u8 channel,
+                varint length, line bytes without '\n'
+
+    Time is monotonic (QElapsedTimer), first frame is relative to
+    recorder creation. Frames are buffered and written in blocks.
+*/
+class FifoRecorder : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit FifoRecorder(const QString &path, QObject *parent = nullptr);
+    ~FifoRecorder();
+    bool isOpen() const;
+    void record(FifoChannel channel, const QByteArray &line);
+    quint64 frames() const;
+
+public slots:
+    void flush();
+
+private:
+    QFile m_file;
+    QByteArray m_buffer;
+    QElapsedTimer m_clock;
+    qint64 m_lastNsecs=0;
+    QTimer *m_flushTimer;
+    quint64 m_frames=0;
+};
+
+struct FifoRecord
+{
+    qint64 nsecs=0;     // since recording start
+    FifoChannel channel=FIFO_CHANNEL_TELEMETRY;
+    QByteArray line;
+};
+
+/* Sequential reader of a recorder log */
+class FifoRecording
+{
+public:
+    explicit FifoRecording(const QString &path);
+    bool isValid() const;
+    bool next(FifoRecord &record);
+
+private:
+    bool readVarint(quint64 &value);
+
+    QByteArray m_data;
+    int m_offset=0;
+    qint64 m_nsecs=0;
+    bool m_valid=false;
+};
+
+#endif // FIFORECORDER_H
@@ -0,0 +1,152 @@
+/*
+    small Pinephone QML interface for Out-Of-Band communication.
+
+    Copyright (C) 2023 Resilience Theatre
+
+    This program is free software; you can redistribute it and/or
+    modify it under the terms of the GNU General Public License
+    as published by the Free Software Foundation; either version 2
+    of the License, or (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; If not, see <http://www.gnu.org/licenses/>.
+
+    NOTE:   FIFO is opened O_RDWR like the old QFile ReadWrite did. Open
+            never fails with ENXIO when daemon is not (yet) reading and
+            we never get SIGPIPE when daemon restarts.
+*/
+
+#include "fifowriter.h"
+#include <QDebug>
+#include <fcntl.h>
+#include <unistd.h>
+#include <errno.h>
+#include <sys/uio.h>
+
+FifoWriter::FifoWriter(const QString &path, QObject *parent)
+    : QObject{parent}
+{
+    m_path = path.toLocal8Bit();
+    openFifo();
+}
+
+FifoWriter::~FifoWriter()
+{
+    closeFifo();
+}
+
+bool FifoWriter::openFifo()
+{
+    if ( m_fd >= 0 )
+        return true;
+    m_fd = open(m_path.constData(), O_RDWR | O_NONBLOCK | O_CLOEXEC);
+    if ( m_fd < 0 ) {
+        qErrnoWarning(errno, "Cannot open FIFO %s", m_path.constData());
+        return false;
+    }
+    m_notifier = new QSocketNotifier(m_fd, QSocketNotifier::Write, this);
+    m_notifier->setEnabled(!m_queue.isEmpty());
+    connect(m_notifier, SIGNAL(activated(int)), this, SLOT(flush()));
+    return true;
+}
+
+void FifoWriter::closeFifo()
+{
+    if ( m_notifier ) {
+        m_notifier->setEnabled(false);
+        delete m_notifier;
+        m_notifier = nullptr;
+    }
+    if ( m_fd >= 0 ) {
+        close(m_fd);
+        m_fd = -1;
+    }
+}
+
+/* Queue one line, actual write happens in flush() on next writable event */
+bool FifoWriter::write(const QByteArray &line)
+{
+    if ( m_queuedBytes + line.size() + 1 > FIFO_WRITER_QUEUE_LIMIT ) {
+        qWarning() << "FIFO" << m_path << "queue full, dropping:" << line;
+        return false;
+    }
+    m_queue.enqueue(line + '\n');
+    m_queuedBytes += line.size() + 1;
+    updateBackpressure();
+    if ( openFifo() )
+        m_notifier->setEnabled(true);
+    return true;
+}
+
+void FifoWriter::flush()
+{
+    struct iovec iov[FIFO_WRITER_BATCH];
+
+    while ( !m_queue.isEmpty() ) {
+        int count = 0;
+        for (int x=0; x < m_queue.size() && count < FIFO_WRITER_BATCH; x++) {
+            const QByteArray &entry = m_queue.at(x);
+            qint64 offset = ( x == 0 ) ? m_headOffset : 0;
+            iov[count].iov_base = const_cast<char *>(entry.constData() + offset);
+            iov[count].iov_len = entry.size() - offset;
+            count++;
+        }
+        ssize_t written = writev(m_fd, iov, count);
+        if ( written < 0 ) {
+            if ( errno == EINTR )
+                continue;
+            if ( errno == EAGAIN || errno == EWOULDBLOCK ) {
+                /* Reader is behind, wait for next writable notification */
+                m_notifier->setEnabled(true);
+                updateBackpressure();
+                return;
+            }
+            qErrnoWarning(errno, "FIFO write error %s", m_path.constData());
+            closeFifo();
+            return;
+        }
+        m_queuedBytes -= written;
+        /* Consume fully written entries, remember offset of partial head */
+        while ( written > 0 ) {
+            qint64 remaining = m_queue.head().size() - m_headOffset;
+            if ( written >= remaining ) {
+                written -= remaining;
+                m_queue.dequeue();
+                m_headOffset = 0;
+            } else {
+                m_headOffset += written;
+                written = 0;
+            }
+        }
+    }
+    m_notifier->setEnabled(false);
+    updateBackpressure();
+}
+
+void FifoWriter::updateBackpressure()
+{
+    bool active = m_backpressure;
+    if ( m_queuedBytes > FIFO_WRITER_HIGH_WATERMARK )
+        active = true;
+    if ( m_queuedBytes < FIFO_WRITER_LOW_WATERMARK )
+        active = false;
+    if ( active == m_backpressure )
+        return;
+    m_backpressure = active;
+    emit backpressureChanged(m_backpressure);
+}
+
+qint64 FifoWriter::queuedBytes() const
+{
+    return m_queuedBytes;
+}
+
+bool FifoWriter::backpressure() const
+{
+    return m_backpressure;
+}
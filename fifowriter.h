@@ -0,0 +1,68 @@
+/*  Small Pine phone QML interface for Out-Of-Band communication.
+
+    Copyright (C) 2023 Resilience Theatre
+
+    This program is free software; you can redistribute it and/or
+    modify it under the terms of the GNU General Public License
+    as published by the Free Software Foundation; either version 2
+    of the License, or (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; If not, see <http://www.gnu.org/licenses/>.
+
+*/
+#ifndef FIFOWRITER_H
+#define FIFOWRITER_H
+#include <QObject>
+#include <QByteArray>
+#include <QQueue>
+#include <QSocketNotifier>
+
+#define FIFO_WRITER_HIGH_WATERMARK  (32 * 1024)
+#define FIFO_WRITER_LOW_WATERMARK   (8 * 1024)
+#define FIFO_WRITER_QUEUE_LIMIT     (256 * 1024)
+#define FIFO_WRITER_BATCH           64
+
+/*
+    Outbound FIFO with persistent non-blocking fd. Lines are queued
+    and flushed in batches with writev() when fd becomes writable,
+    so bursts of commands cost one syscall instead of open/write/close
+    per line. backpressureChanged() tells when reader falls behind.
+*/
+class FifoWriter : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit FifoWriter(const QString &path, QObject *parent = nullptr);
+    ~FifoWriter();
+    bool write(const QByteArray &line);
+    qint64 queuedBytes() const;
+    bool backpressure() const;
+
+signals:
+    void backpressureChanged(bool active);
+
+private slots:
+    void flush();
+
+private:
+    bool openFifo();
+    void closeFifo();
+    void updateBackpressure();
+
+    QByteArray m_path;
+    int m_fd=-1;
+    QSocketNotifier *m_notifier=nullptr;
+    QQueue<QByteArray> m_queue;
+    qint64 m_headOffset=0;
+    qint64 m_queuedBytes=0;
+    bool m_backpressure=false;
+};
+
+#endif // FIFOWRITER_H
@@ -0,0 +1,205 @@
+/*
+    small Pinephone QML interface for Out-Of-Band communication.
+
+    Copyright (C) 2023 Resilience Theatre
+
+    This program is free software; you can redistribute it and/or
+    modify it under the terms of the GNU General Public License
+    as published by the Free Software Foundation; either version 2
+    of the License, or (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "hardwarecontrol.h"
+#include <QDebug>
+#include <fcntl.h>
+#include <unistd.h>
+#include <errno.h>
+#include <dirent.h>
+#include <string.h>
+#include <sys/ioctl.h>
+#include <linux/input.h>
+
+#define BACKLIGHT_CLASS_PATH    "/class/backlight"
+#define LEDS_CLASS_PATH         "/class/leds"
+
+static const char *ledNameHint[LED_COUNT] = { "red", "green", "blue" };
+
+HardwareControl::HardwareControl(const QByteArray &sysfsRoot, const QByteArray &vibratorDevice)
+{
+    /* Backlight: first device of class, brightness kept open for writes */
+    QByteArray backlight = findClassDevice(sysfsRoot + BACKLIGHT_CLASS_PATH, nullptr);
+    if ( !backlight.isEmpty() ) {
+        char buffer[32] = {};
+        int fd = ::open((backlight + "/max_brightness").constData(), O_RDONLY | O_CLOEXEC);
+        if ( fd >= 0 ) {
+            if ( read(fd, buffer, sizeof(buffer) - 1) > 0 )
+                m_backlightMax = strtol(buffer, nullptr, 10);
+            ::close(fd);
+        }
+        m_backlightPath = backlight + "/brightness";
+        m_backlightFd = ::open(m_backlightPath.constData(), O_WRONLY | O_CLOEXEC);
+        if ( m_backlightFd < 0 )
+            qErrnoWarning(errno, "Cannot open backlight %s", m_backlightPath.constData());
+    } else {
+        qDebug() << "No backlight under" << sysfsRoot;
+    }
+    for (int color=0; color < LED_COUNT; color++) {
+        m_ledPath[color] = findClassDevice(sysfsRoot + LEDS_CLASS_PATH, ledNameHint[color]);
+        if ( m_ledPath[color].isEmpty() )
+            qDebug() << "No" << ledNameHint[color] << "led under" << sysfsRoot;
+    }
+    /* Vibrator, effect upload needs write access */
+    m_vibratorFd = ::open(vibratorDevice.constData(), O_RDWR | O_CLOEXEC);
+    if ( m_vibratorFd >= 0 ) {
+        unsigned long features[(FF_MAX + 8 * sizeof(long)) / (8 * sizeof(long))] = {};
+        if ( ioctl(m_vibratorFd, EVIOCGBIT(EV_FF, sizeof(features)), features) < 0
+             || !(features[FF_RUMBLE / (8 * sizeof(long))] & (1UL << (FF_RUMBLE % (8 * sizeof(long))))) ) {
+            qDebug() << "Vibrator has no FF_RUMBLE:" << vibratorDevice;
+            ::close(m_vibratorFd);
+            m_vibratorFd = -1;
+        }
+    } else {
+        qErrnoWarning(errno, "Cannot open vibrator %s", vibratorDevice.constData());
+    }
+}
+
+HardwareControl::~HardwareControl()
+{
+    if ( m_vibratorFd >= 0 ) {
+        if ( m_effectId >= 0 )
+            ioctl(m_vibratorFd, EVIOCRMFF, m_effectId);
+        ::close(m_vibratorFd);
+    }
+    if ( m_backlightFd >= 0 )
+        ::close(m_backlightFd);
+}
+
+/* Directory under class path whose name contains hint, first one without hint */
+QByteArray HardwareControl::findClassDevice(const QByteArray &classPath, const char *nameHint)
+{
+    QByteArray found;
+    DIR *dir = opendir(classPath.constData());
+    if ( !dir )
+        return found;
+    while ( struct dirent *entry = readdir(dir) ) {
+        if ( entry->d_name[0] == '.' )
+            continue;
+        if ( nameHint && !strstr(entry->d_name, nameHint) )
+            continue;
+        found = classPath + "/" + entry->d_name;
+        break;
+    }
+    closedir(dir);
+    return found;
+}
+
+bool HardwareControl::writeFile(const QByteArray &path, const QByteArray &value)
+{
+    int fd = ::open(path.constData(), O_WRONLY | O_CLOEXEC);
+    if ( fd < 0 ) {
+        qErrnoWarning(errno, "Cannot open %s", path.constData());
+        return false;
+    }
+    bool ok = write(fd, value.constData(), size_t(value.size())) == value.size();
+    if ( !ok )
+        qErrnoWarning(errno, "Cannot write %s", path.constData());
+    ::close(fd);
+    return ok;
+}
+
+bool HardwareControl::setBacklightPercent(int percent)
+{
+    percent = qBound(0, percent, 100);
+    if ( m_backlightFd < 0 || m_backlightMax <= 0 )
+        return false;
+    QByteArray value = QByteArray::number(m_backlightMax * percent / 100);
+    if ( pwrite(m_backlightFd, value.constData(), size_t(value.size()), 0) != value.size() ) {
+        qErrnoWarning(errno, "Cannot write %s", m_backlightPath.constData());
+        return false;
+    }
+    m_backlightPercent = percent;
+    return true;
+}
+
+int HardwareControl::backlightPercent() const
+{
+    return m_backlightPercent;
+}
+
+bool HardwareControl::setLed(LedColor color, bool on)
+{
+    if ( m_ledPath[color].isEmpty() )
+        return false;
+    /* Writing brightness 0 also clears trigger, blink state stops here */
+    if ( m_ledBlinking[color] ) {
+        writeFile(m_ledPath[color] + "/trigger", "none");
+        m_ledBlinking[color] = false;
+    }
+    return writeFile(m_ledPath[color] + "/brightness", on ? "1" : "0");
+}
+
+/* Kernel 'timer' trigger blinks led until next setLed() */
+bool HardwareControl::blinkLed(LedColor color, int onMs, int offMs)
+{
+    if ( m_ledPath[color].isEmpty() )
+        return false;
+    if ( !writeFile(m_ledPath[color] + "/trigger", "timer") )
+        return false;
+    m_ledBlinking[color] = true;
+    return writeFile(m_ledPath[color] + "/delay_on", QByteArray::number(onMs))
+        && writeFile(m_ledPath[color] + "/delay_off", QByteArray::number(offMs));
+}
+
+/* Effect is uploaded once and updated only when pattern changes */
+bool HardwareControl::uploadRumble(int durationMs, int strengthPercent, int gapMs)
+{
+    if ( m_effectId >= 0 && durationMs == m_effectDuration
+         && strengthPercent == m_effectStrength && gapMs == m_effectGap )
+        return true;
+    struct ff_effect effect;
+    memset(&effect, 0, sizeof(effect));
+    effect.type = FF_RUMBLE;
+    effect.id = short(m_effectId);
+    effect.u.rumble.strong_magnitude = quint16(0xFFFF * qBound(0, strengthPercent, 100) / 100);
+    effect.u.rumble.weak_magnitude = effect.u.rumble.strong_magnitude;
+    effect.replay.length = quint16(durationMs);
+    effect.replay.delay = quint16(gapMs);
+    if ( ioctl(m_vibratorFd, EVIOCSFF, &effect) < 0 ) {
+        qErrnoWarning(errno, "Cannot upload vibrator effect");
+        m_effectId = -1;
+        return false;
+    }
+    m_effectId = effect.id;
+    m_effectDuration = durationMs;
+    m_effectStrength = strengthPercent;
+    m_effectGap = gapMs;
+    return true;
+}
+
+/* Same arguments as pptk-vibrate: pulse length, strength and pulse count */
+bool HardwareControl::vibrate(int durationMs, int strengthPercent, int count)
+{
+    if ( m_vibratorFd < 0 || count <= 0 )
+        return false;
+    /* Repeated pulses are separated by pause of pulse length */
+    if ( !uploadRumble(durationMs, strengthPercent, count > 1 ? durationMs : 0) )
+        return false;
+    struct input_event play;
+    memset(&play, 0, sizeof(play));
+    play.type = EV_FF;
+    play.code = quint16(m_effectId);
+    play.value = count;
+    if ( write(m_vibratorFd, &play, sizeof(play)) != sizeof(play) ) {
+        qErrnoWarning(errno, "Cannot play vibrator effect");
+        return false;
+    }
+    return true;
+}
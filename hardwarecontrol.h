@@ -0,0 +1,73 @@
+/*  Small Pine phone QML interface for Out-Of-Band communication.
+
+    Copyright (C) 2023 Resilience Theatre
+
+    This program is free software; you can redistribute it and/or
+    modify it under the terms of the GNU General Public License
+    as published by the Free Software Foundation; either version 2
+    of the License, or (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; If not, see <http://www.gnu.org/licenses/>.
+
+*/
+#ifndef HARDWARECONTROL_H
+#define HARDWARECONTROL_H
+#include <QByteArray>
+
+#define HARDWARE_SYSFS_ROOT     "/sys"
+#define HARDWARE_ROOT_ENV       "QTUI_SYSFS_ROOT"   // fake sysfs root for testing
+#define VIBRATOR_INPUT_PATH     "/dev/input/by-path/platform-vibrator-event"
+
+enum LedColor {
+    LED_RED,
+    LED_GREEN,
+    LED_BLUE,
+    LED_COUNT
+};
+
+/*
+    Backlight, indicator LEDs and vibrator without helper binaries.
+    Backlight and LEDs are written through sysfs class files under
+    root, blinking is left to kernel 'timer' trigger and vibration
+    is an uploaded FF_RUMBLE effect played on vibrator input device.
+*/
+class HardwareControl
+{
+public:
+    explicit HardwareControl(const QByteArray &sysfsRoot = HARDWARE_SYSFS_ROOT,
+                             const QByteArray &vibratorDevice = VIBRATOR_INPUT_PATH);
+    ~HardwareControl();
+    HardwareControl(const HardwareControl &) = delete;
+    HardwareControl &operator=(const HardwareControl &) = delete;
+
+    bool setBacklightPercent(int percent);
+    int backlightPercent() const;
+    bool setLed(LedColor color, bool on);
+    bool blinkLed(LedColor color, int onMs, int offMs);
+    bool vibrate(int durationMs, int strengthPercent, int count);
+
+private:
+    static bool writeFile(const QByteArray &path, const QByteArray &value);
+    static QByteArray findClassDevice(const QByteArray &classPath, const char *nameHint);
+    bool uploadRumble(int durationMs, int strengthPercent, int gapMs);
+
+    QByteArray m_backlightPath;
+    int m_backlightFd=-1;
+    long m_backlightMax=0;
+    int m_backlightPercent=-1;
+    QByteArray m_ledPath[LED_COUNT];
+    bool m_ledBlinking[LED_COUNT]={};
+    int m_vibratorFd=-1;
+    int m_effectId=-1;
+    int m_effectDuration=-1;
+    int m_effectStrength=-1;
+    int m_effectGap=-1;
+};
+
+#endif // HARDWARECONTROL_H
@@ -0,0 +1,361 @@
+/*
+    small Pinephone QML interface for Out-Of-Band communication.
+
+    Copyright (C) 2023 Resilience Theatre
+
+    This program is free software; you can redistribute it and/or
+    modify it under the terms of the GNU General Public License
+    as published by the Free Software Foundation; either version 2
+    of the License, or (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "iwdclient.h"
+#include <QDebug>
+#include <QDBusMessage>
+#include <QDBusMetaType>
+#include <QDBusPendingCallWatcher>
+#include <QDBusPendingReply>
+#include <QDBusServiceWatcher>
+
+#define IWD_MANAGER_PATH        "/net/connman/iwd"
+#define IWD_STATION_INTERFACE   "net.connman.iwd.Station"
+#define IWD_NETWORK_INTERFACE   "net.connman.iwd.Network"
+#define IWD_AGENT_MANAGER       "net.connman.iwd.AgentManager"
+#define DBUS_OBJECT_MANAGER     "org.freedesktop.DBus.ObjectManager"
+#define DBUS_PROPERTIES         "org.freedesktop.DBus.Properties"
+#define IWD_CONNECT_TIMEOUT     60000
+
+QDBusArgument &operator<<(QDBusArgument &argument, const IwdOrderedNetwork &network)
+{
+    argument.beginStructure();
+    argument << network.path << network.signal;
+    argument.endStructure();
+    return argument;
+}
+
+const QDBusArgument &operator>>(const QDBusArgument &argument, IwdOrderedNetwork &network)
+{
+    argument.beginStructure();
+    argument >> network.path >> network.signal;
+    argument.endStructure();
+    return argument;
+}
+
+/* iwd reports 100 * dBm, -100 dBm is 0 % and -50 dBm or better 100 % */
+static int signalPercent(qint16 signal)
+{
+    return qBound(0, 2 * (signal / 100 + 100), 100);
+}
+
+IwdAgent::IwdAgent(IwdClient *client)
+    : QObject{client}, m_client(client)
+{
+}
+
+void IwdAgent::Release()
+{
+}
+
+QString IwdAgent::RequestPassphrase(const QDBusObjectPath &network)
+{
+    QString passphrase = m_client->passphraseFor(network.path());
+    if ( passphrase.isEmpty() )
+        sendErrorReply("net.connman.iwd.Agent.Error.Canceled", "No passphrase");
+    return passphrase;
+}
+
+void IwdAgent::Cancel(const QString &reason)
+{
+    qDebug() << "iwd agent request cancelled:" << reason;
+}
+
+IwdClient::IwdClient(WifiNetworkModel *model, const QDBusConnection &bus, QObject *parent)
+    : QObject{parent}, m_bus(bus), m_model(model)
+{
+    qDBusRegisterMetaType<IwdInterfaceMap>();
+    qDBusRegisterMetaType<IwdObjectMap>();
+    qDBusRegisterMetaType<IwdOrderedNetwork>();
+    qDBusRegisterMetaType<IwdOrderedNetworkList>();
+
+    m_agent = new IwdAgent(this);
+    /* QTUI_IWD_BUS=none: no bus, client stays unavailable */
+    if ( !m_bus.isConnected() ) {
+        qDebug() << "No iwd bus connection, Wi-Fi not available";
+        return;
+    }
+    if ( !m_bus.registerObject(IWD_AGENT_PATH, m_agent, QDBusConnection::ExportScriptableSlots) )
+        qWarning() << "Cannot register iwd agent:" << m_bus.lastError().message();
+
+    m_bus.connect(IWD_SERVICE, "/", DBUS_OBJECT_MANAGER, "InterfacesAdded",
+                  this, SLOT(interfacesAdded(QDBusObjectPath,IwdInterfaceMap)));
+    m_bus.connect(IWD_SERVICE, "/", DBUS_OBJECT_MANAGER, "InterfacesRemoved",
+                  this, SLOT(interfacesRemoved(QDBusObjectPath,QStringList)));
+    m_bus.connect(IWD_SERVICE, QString(), DBUS_PROPERTIES, "PropertiesChanged",
+                  this, SLOT(propertiesChanged(QString,QVariantMap,QStringList,QDBusMessage)));
+
+    /* iwd may start after UI or be restarted */
+    m_serviceWatcher = new QDBusServiceWatcher(IWD_SERVICE, m_bus,
+            QDBusServiceWatcher::WatchForRegistration | QDBusServiceWatcher::WatchForUnregistration, this);
+    connect(m_serviceWatcher, &QDBusServiceWatcher::serviceRegistered, this, &IwdClient::serviceRegistered);
+    connect(m_serviceWatcher, &QDBusServiceWatcher::serviceUnregistered, this, &IwdClient::serviceUnregistered);
+    loadObjects();
+}
+
+bool IwdClient::isAvailable() const
+{
+    return !m_stationPath.isEmpty();
+}
+
+bool IwdClient::isScanning() const
+{
+    return m_scanning;
+}
+
+QString IwdClient::state() const
+{
+    return m_state;
+}
+
+QString IwdClient::connectedSsid() const
+{
+    int row = m_model->indexOf(m_connectedNetwork);
+    return row < 0 ? QString() : m_model->network(row).ssid;
+}
+
+bool IwdClient::scan()
+{
+    if ( m_stationPath.isEmpty() )
+        return false;
+    QDBusMessage call = QDBusMessage::createMethodCall(IWD_SERVICE, m_stationPath, IWD_STATION_INTERFACE, "Scan");
+    QDBusPendingCallWatcher *watcher = new QDBusPendingCallWatcher(m_bus.asyncCall(call), this);
+    connect(watcher, &QDBusPendingCallWatcher::finished, this, [this](QDBusPendingCallWatcher *watcher) {
+        QDBusPendingReply<> reply = *watcher;
+        /* Busy: scan already running, its results arrive as well */
+        if ( reply.isError() && reply.error().name() != "net.connman.iwd.Busy" ) {
+            qWarning() << "iwd scan failed:" << reply.error().message();
+            emit scanFinished(m_model->count());
+        }
+        watcher->deleteLater();
+    });
+    return true;
+}
+
+/* Passphrase is handed to iwd only through agent request for this network */
+bool IwdClient::connectNetwork(const QString &ssid, const QString &passphrase)
+{
+    int row = m_model->indexOfSsid(ssid);
+    if ( row < 0 ) {
+        emit connectFailed("Network not found");
+        return false;
+    }
+    m_pendingNetwork = m_model->network(row).id;
+    m_pendingPassphrase = passphrase;
+    QDBusMessage call = QDBusMessage::createMethodCall(IWD_SERVICE, m_pendingNetwork, IWD_NETWORK_INTERFACE, "Connect");
+    QDBusPendingCallWatcher *watcher = new QDBusPendingCallWatcher(m_bus.asyncCall(call, IWD_CONNECT_TIMEOUT), this);
+    connect(watcher, &QDBusPendingCallWatcher::finished, this, [this](QDBusPendingCallWatcher *watcher) {
+        QDBusPendingReply<> reply = *watcher;
+        m_pendingNetwork.clear();
+        m_pendingPassphrase.clear();
+        if ( reply.isError() )
+            emit connectFailed(reply.error().message());
+        watcher->deleteLater();
+    });
+    return true;
+}
+
+QString IwdClient::passphraseFor(const QString &networkPath)
+{
+    if ( networkPath != m_pendingNetwork )
+        return QString();
+    return m_pendingPassphrase;
+}
+
+void IwdClient::serviceRegistered()
+{
+    loadObjects();
+}
+
+void IwdClient::serviceUnregistered()
+{
+    qDebug() << "iwd left bus";
+    reset();
+}
+
+void IwdClient::reset()
+{
+    bool wasAvailable = isAvailable();
+    m_stationPath.clear();
+    m_connectedNetwork.clear();
+    m_model->clear();
+    if ( m_scanning ) {
+        m_scanning = false;
+        emit scanningChanged(false);
+    }
+    if ( !m_state.isEmpty() ) {
+        m_state.clear();
+        emit stateChanged(m_state);
+    }
+    if ( wasAvailable )
+        emit availableChanged(false);
+}
+
+void IwdClient::loadObjects()
+{
+    QDBusMessage call = QDBusMessage::createMethodCall(IWD_SERVICE, "/", DBUS_OBJECT_MANAGER, "GetManagedObjects");
+    QDBusPendingCallWatcher *watcher = new QDBusPendingCallWatcher(m_bus.asyncCall(call), this);
+    connect(watcher, &QDBusPendingCallWatcher::finished, this, &IwdClient::managedObjectsReady);
+}
+
+void IwdClient::registerAgent()
+{
+    QDBusMessage call = QDBusMessage::createMethodCall(IWD_SERVICE, IWD_MANAGER_PATH, IWD_AGENT_MANAGER, "RegisterAgent");
+    call << QVariant::fromValue(QDBusObjectPath(IWD_AGENT_PATH));
+    m_bus.asyncCall(call);
+}
+
+/* Station first, networks of other devices are skipped */
+void IwdClient::managedObjectsReady(QDBusPendingCallWatcher *watcher)
+{
+    QDBusPendingReply<IwdObjectMap> reply = *watcher;
+    watcher->deleteLater();
+    if ( reply.isError() ) {
+        qDebug() << "iwd not available:" << reply.error().message();
+        return;
+    }
+    const IwdObjectMap objects = reply.value();
+    for (auto it = objects.constBegin(); it != objects.constEnd(); ++it) {
+        if ( it.value().contains(IWD_STATION_INTERFACE) ) {
+            setStation(it.key().path(), it.value().value(IWD_STATION_INTERFACE));
+            break;
+        }
+    }
+    for (auto it = objects.constBegin(); it != objects.constEnd(); ++it) {
+        if ( it.value().contains(IWD_NETWORK_INTERFACE) )
+            updateNetwork(it.key().path(), it.value().value(IWD_NETWORK_INTERFACE));
+    }
+    requestOrderedNetworks();
+}
+
+void IwdClient::setStation(const QString &path, const QVariantMap &properties)
+{
+    bool wasAvailable = isAvailable();
+    m_stationPath = path;
+    registerAgent();
+    updateStation(properties);
+    if ( !wasAvailable )
+        emit availableChanged(true);
+}
+
+void IwdClient::updateStation(const QVariantMap &properties)
+{
+    if ( properties.contains("ConnectedNetwork") ) {
+        QString network = qvariant_cast<QDBusObjectPath>(properties.value("ConnectedNetwork")).path();
+        if ( network != m_connectedNetwork ) {
+            m_model->setConnected(m_connectedNetwork, false);
+            m_connectedNetwork = network;
+            m_model->setConnected(m_connectedNetwork, true);
+        }
+    }
+    if ( properties.contains("State") ) {
+        QString state = properties.value("State").toString();
+        if ( state != m_state ) {
+            m_state = state;
+            emit stateChanged(m_state);
+        }
+    }
+    if ( properties.contains("Scanning") ) {
+        bool scanning = properties.value("Scanning").toBool();
+        if ( scanning != m_scanning ) {
+            m_scanning = scanning;
+            emit scanningChanged(m_scanning);
+            if ( !m_scanning )
+                requestOrderedNetworks();
+        }
+    }
+}
+
+/* Partial property sets from PropertiesChanged are merged into existing row */
+void IwdClient::updateNetwork(const QString &path, const QVariantMap &properties)
+{
+    if ( properties.contains("Device") && !m_stationPath.isEmpty()
+         && qvariant_cast<QDBusObjectPath>(properties.value("Device")).path() != m_stationPath )
+        return;
+    int row = m_model->indexOf(path);
+    WifiNetworkModel::Network network;
+    if ( row >= 0 )
+        network = m_model->network(row);
+    else if ( !properties.contains("Name") )
+        return;
+    network.id = path;
+    if ( properties.contains("Name") )
+        network.ssid = properties.value("Name").toString();
+    if ( properties.contains("Type") )
+        network.security = properties.value("Type").toString();
+    if ( properties.contains("Connected") )
+        network.connected = properties.value("Connected").toBool();
+    if ( properties.contains("KnownNetwork") )
+        network.known = !qvariant_cast<QDBusObjectPath>(properties.value("KnownNetwork")).path().isEmpty();
+    m_model->update(network);
+}
+
+void IwdClient::requestOrderedNetworks()
+{
+    if ( m_stationPath.isEmpty() )
+        return;
+    QDBusMessage call = QDBusMessage::createMethodCall(IWD_SERVICE, m_stationPath, IWD_STATION_INTERFACE, "GetOrderedNetworks");
+    QDBusPendingCallWatcher *watcher = new QDBusPendingCallWatcher(m_bus.asyncCall(call), this);
+    connect(watcher, &QDBusPendingCallWatcher::finished, this, &IwdClient::orderedNetworksReady);
+}
+
+void IwdClient::orderedNetworksReady(QDBusPendingCallWatcher *watcher)
+{
+    QDBusPendingReply<IwdOrderedNetworkList> reply = *watcher;
+    watcher->deleteLater();
+    if ( reply.isError() ) {
+        qWarning() << "iwd GetOrderedNetworks failed:" << reply.error().message();
+        return;
+    }
+    for (const IwdOrderedNetwork &network : reply.value())
+        m_model->setStrength(network.path.path(), signalPercent(network.signal));
+    emit scanFinished(m_model->count());
+}
+
+void IwdClient::interfacesAdded(const QDBusObjectPath &path, const IwdInterfaceMap &interfaces)
+{
+    if ( interfaces.contains(IWD_STATION_INTERFACE) && m_stationPath.isEmpty() )
+        setStation(path.path(), interfaces.value(IWD_STATION_INTERFACE));
+    if ( interfaces.contains(IWD_NETWORK_INTERFACE) )
+        updateNetwork(path.path(), interfaces.value(IWD_NETWORK_INTERFACE));
+}
+
+void IwdClient::interfacesRemoved(const QDBusObjectPath &path, const QStringList &interfaces)
+{
+    if ( interfaces.contains(IWD_STATION_INTERFACE) && path.path() == m_stationPath ) {
+        reset();
+        return;
+    }
+    if ( interfaces.contains(IWD_NETWORK_INTERFACE) )
+        m_model->remove(path.path());
+}
+
+void IwdClient::propertiesChanged(const QString &interface, const QVariantMap &changed,
+                                  const QStringList &invalidated, const QDBusMessage &message)
+{
+    if ( interface == IWD_STATION_INTERFACE && message.path() == m_stationPath ) {
+        QVariantMap properties = changed;
+        /* ConnectedNetwork disappears when station disconnects */
+        if ( invalidated.contains("ConnectedNetwork") )
+            properties.insert("ConnectedNetwork", QVariant::fromValue(QDBusObjectPath()));
+        updateStation(properties);
+    } else if ( interface == IWD_NETWORK_INTERFACE ) {
+        updateNetwork(message.path(), changed);
+    }
+}
@@ -0,0 +1,135 @@
+/*  Small Pine phone QML interface for Out-Of-Band communication.
+
+    Copyright (C) 2023 Resilience Theatre
+
+    This program is free software; you can redistribute it and/or
+    modify it under the terms of the GNU General Public License
+    as published by the Free Software Foundation; either version 2
+    of the License, or (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; If not, see <http://www.gnu.org/licenses/>.
+
+*/
+#ifndef IWDCLIENT_H
+#define IWDCLIENT_H
+#include <QObject>
+#include <QDBusConnection>
+#include <QDBusContext>
+#include <QDBusObjectPath>
+#include <QDBusArgument>
+#include <QVariantMap>
+#include "wifinetworkmodel.h"
+
+#define IWD_SERVICE             "net.connman.iwd"
+#define IWD_BUS_ENV             "QTUI_IWD_BUS"      // "session", bus address for mock iwd or "none"
+#define IWD_BUS_NONE            "none"
+#define IWD_AGENT_PATH          "/qtui/iwd/agent"
+
+class QDBusPendingCallWatcher;
+class QDBusServiceWatcher;
+class IwdClient;
+
+typedef QMap<QString, QVariantMap> IwdInterfaceMap;
+typedef QMap<QDBusObjectPath, IwdInterfaceMap> IwdObjectMap;
+
+/* Station.GetOrderedNetworks() entry, signal is 100 * dBm */
+struct IwdOrderedNetwork
+{
+    QDBusObjectPath path;
+    qint16 signal=0;
+};
+typedef QList<IwdOrderedNetwork> IwdOrderedNetworkList;
+
+QDBusArgument &operator<<(QDBusArgument &argument, const IwdOrderedNetwork &network);
+const QDBusArgument &operator>>(const QDBusArgument &argument, IwdOrderedNetwork &network);
+
+Q_DECLARE_METATYPE(IwdInterfaceMap)
+Q_DECLARE_METATYPE(IwdObjectMap)
+Q_DECLARE_METATYPE(IwdOrderedNetwork)
+Q_DECLARE_METATYPE(IwdOrderedNetworkList)
+
+/* Answers iwd passphrase requests for network being connected */
+class IwdAgent : public QObject, protected QDBusContext
+{
+    Q_OBJECT
+    Q_CLASSINFO("D-Bus Interface", "net.connman.iwd.Agent")
+
+public:
+    explicit IwdAgent(IwdClient *client);
+
+public slots:
+    Q_SCRIPTABLE void Release();
+    Q_SCRIPTABLE QString RequestPassphrase(const QDBusObjectPath &network);
+    Q_SCRIPTABLE void Cancel(const QString &reason);
+
+private:
+    IwdClient *m_client;
+};
+
+/*
+    Wi-Fi through iwd D-Bus API. Objects are loaded once with
+    GetManagedObjects() and then followed with InterfacesAdded,
+    InterfacesRemoved and PropertiesChanged signals, so networks
+    stream into WifiNetworkModel and connection state changes are
+    seen as soon as iwd reports them. Bus is a constructor argument
+    to run against a mock service on a private bus (tests/iwd).
+*/
+class IwdClient : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit IwdClient(WifiNetworkModel *model, const QDBusConnection &bus, QObject *parent = nullptr);
+    bool isAvailable() const;
+    bool isScanning() const;
+    QString state() const;
+    QString connectedSsid() const;
+    bool scan();
+    bool connectNetwork(const QString &ssid, const QString &passphrase);
+    QString passphraseFor(const QString &networkPath);
+
+signals:
+    void availableChanged(bool available);
+    void stateChanged(const QString &state);
+    void scanningChanged(bool scanning);
+    void scanFinished(int count);
+    void connectFailed(const QString &error);
+
+private slots:
+    void serviceRegistered();
+    void serviceUnregistered();
+    void managedObjectsReady(QDBusPendingCallWatcher *watcher);
+    void orderedNetworksReady(QDBusPendingCallWatcher *watcher);
+    void interfacesAdded(const QDBusObjectPath &path, const IwdInterfaceMap &interfaces);
+    void interfacesRemoved(const QDBusObjectPath &path, const QStringList &interfaces);
+    void propertiesChanged(const QString &interface, const QVariantMap &changed,
+                           const QStringList &invalidated, const QDBusMessage &message);
+
+private:
+    void loadObjects();
+    void registerAgent();
+    void setStation(const QString &path, const QVariantMap &properties);
+    void updateStation(const QVariantMap &properties);
+    void updateNetwork(const QString &path, const QVariantMap &properties);
+    void requestOrderedNetworks();
+    void reset();
+
+    QDBusConnection m_bus;
+    WifiNetworkModel *m_model;
+    IwdAgent *m_agent;
+    QDBusServiceWatcher *m_serviceWatcher;
+    QString m_stationPath;
+    QString m_state;
+    QString m_connectedNetwork;
+    bool m_scanning=false;
+    QString m_pendingNetwork;
+    QString m_pendingPassphrase;
+};
+
+#endif // IWDCLIENT_H
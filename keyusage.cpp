@@ -0,0 +1,309 @@
+/*
+    small Pinephone QML interface for Out-Of-Band communication.
+
+    Copyright (C) 2023 Resilience Theatre
+
+    This program is free software; you can redistribute it and/or
+    modify it under the terms of the GNU General Public License
+    as published by the Free Software Foundation; either version 2
+    of the License, or (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "keyusage.h"
+#include "trace.h"
+#include <QDebug>
+#include <fcntl.h>
+#include <unistd.h>
+#include <errno.h>
+#include <limits.h>
+#include <sys/stat.h>
+
+static const char *keySuffix[KeyUsage::KEY_DIRECTION_COUNT] = { ".inkey", ".outkey" };
+static const char *counterSuffix[KeyUsage::KEY_DIRECTION_COUNT] = { ".incount", ".outcount" };
+
+KeyUsage::KeyUsage(const QString &directory, QObject *parent)
+    : QObject{parent}, m_directory(directory.toLocal8Bit())
+{
+    /* Counters may be rewritten in place without close, IN_MODIFY catches those */
+    m_watcher = new StatusWatcher(directory, this, IN_MODIFY | IN_CLOSE_WRITE | IN_MOVED_TO);
+    connect(m_watcher, &StatusWatcher::fileChanged, this, &KeyUsage::counterFileChanged);
+    m_publishTimer = new QTimer(this);
+    m_publishTimer->setSingleShot(true);
+    m_publishTimer->setInterval(KEY_USAGE_COALESCE);
+    connect(m_publishTimer, &QTimer::timeout, this, &KeyUsage::publish);
+    m_clock.start();
+}
+
+KeyUsage::~KeyUsage()
+{
+    for (Node &node : m_nodes) {
+        for (Pad &pad : node.pad)
+            closeCounter(pad);
+    }
+}
+
+/*
+    Pair keys are named by both node ids, lower roster index first.
+    Own node has no pads.
+*/
+void KeyUsage::setNodes(const QStringList &nodeIds, const QString &myNodeId)
+{
+    for (Node &node : m_nodes) {
+        for (Pad &pad : node.pad)
+            closeCounter(pad);
+    }
+    m_nodes.clear();
+    m_nodes.resize(nodeIds.size());
+    m_watchNode.clear();
+    int tippingPoint = qMax(0, nodeIds.lastIndexOf(myNodeId));
+    for (int x=0; x < nodeIds.size(); x++) {
+        if ( nodeIds.at(x) == myNodeId )
+            continue;
+        QString pairName = x < tippingPoint ? nodeIds.at(x) + myNodeId : myNodeId + nodeIds.at(x);
+        QByteArray pairFile = pairName.toLocal8Bit();
+        QByteArray base = m_directory + "/" + pairFile;
+        for (int direction=0; direction < KEY_DIRECTION_COUNT; direction++) {
+            Pad &pad = m_nodes[x].pad[direction];
+            pad.keyPath = base + keySuffix[direction];
+            pad.counterPath = base + counterSuffix[direction];
+            struct stat st;
+            pad.keySize = stat(pad.keyPath.constData(), &st) == 0 ? qint64(st.st_size) : -1;
+            if ( pad.keySize < 0 )
+                qDebug() << "Key not available:" << pad.keyPath;
+            openCounter(pad);
+            readCounter(pad);
+            updatePercent(pad);
+            sample(pad);
+            int id = m_watcher->watch(pairFile + counterSuffix[direction]);
+            if ( id >= m_watchNode.size() )
+                m_watchNode.resize(id + 1);
+            m_watchNode[id] = x;
+        }
+    }
+    for (int x=0; x < m_nodes.size(); x++)
+        emit usageChanged(x);
+}
+
+/* Keys may be replaced between calls, re-read sizes and counters */
+void KeyUsage::refresh()
+{
+    TRACE_SCOPE("keyusage::refresh");
+    for (int x=0; x < m_nodes.size(); x++) {
+        bool changed = false;
+        for (Pad &pad : m_nodes[x].pad) {
+            if ( pad.keyPath.isEmpty() )
+                continue;
+            struct stat st;
+            pad.keySize = stat(pad.keyPath.constData(), &st) == 0 ? qint64(st.st_size) : -1;
+            openCounter(pad);
+            readCounter(pad);
+            changed |= sample(pad);
+            changed |= updatePercent(pad);
+        }
+        if ( changed )
+            emit usageChanged(x);
+    }
+}
+
+int KeyUsage::nodeCount() const
+{
+    return m_nodes.size();
+}
+
+/* -1 when key or counter is missing */
+int KeyUsage::remainingPercent(int node, Direction direction) const
+{
+    if ( node < 0 || node >= m_nodes.size() )
+        return -1;
+    return m_nodes.at(node).pad[direction].percent;
+}
+
+qint64 KeyUsage::keySize(int node, Direction direction) const
+{
+    if ( node < 0 || node >= m_nodes.size() )
+        return -1;
+    return m_nodes.at(node).pad[direction].keySize;
+}
+
+qint64 KeyUsage::used(int node, Direction direction) const
+{
+    if ( node < 0 || node >= m_nodes.size() )
+        return -1;
+    return m_nodes.at(node).pad[direction].counter;
+}
+
+/* Deltas up to now belong to previous state, in call time starts here */
+void KeyUsage::setInCall(bool inCall)
+{
+    if ( inCall == m_inCall )
+        return;
+    sampleAll();
+    m_inCall = inCall;
+}
+
+/* Talk time until first direction of pad runs out, -1 unknown */
+int KeyUsage::talkSecondsLeft(int node) const
+{
+    if ( node < 0 || node >= m_nodes.size() )
+        return -1;
+    double seconds = -1;
+    for (const Pad &pad : m_nodes.at(node).pad) {
+        if ( pad.keySize < 0 || pad.lastUsed < 0 || pad.audioRate <= 0 )
+            continue;
+        double left = qMax(qint64(0), pad.keySize - pad.lastUsed) / pad.audioRate;
+        if ( seconds < 0 || left < seconds )
+            seconds = left;
+    }
+    return seconds < 0 ? -1 : int(qMin(seconds, double(INT_MAX)));
+}
+
+/* Messages until first direction of pad runs out, -1 unknown */
+int KeyUsage::messagesLeft(int node) const
+{
+    if ( node < 0 || node >= m_nodes.size() )
+        return -1;
+    double messages = -1;
+    for (const Pad &pad : m_nodes.at(node).pad) {
+        if ( pad.keySize < 0 || pad.lastUsed < 0 || pad.messageBytes <= 0 )
+            continue;
+        double left = qMax(qint64(0), pad.keySize - pad.lastUsed) / pad.messageBytes;
+        if ( messages < 0 || left < messages )
+            messages = left;
+    }
+    return messages < 0 ? -1 : int(qMin(messages, double(INT_MAX)));
+}
+
+void KeyUsage::counterFileChanged(int id)
+{
+    if ( id < 0 || id >= m_watchNode.size() )
+        return;
+    m_nodes[m_watchNode.at(id)].dirty = true;
+    if ( !m_publishTimer->isActive() )
+        m_publishTimer->start();
+}
+
+/* Coalesced counter updates, reopen if counter file was replaced */
+void KeyUsage::publish()
+{
+    for (int x=0; x < m_nodes.size(); x++) {
+        Node &node = m_nodes[x];
+        if ( !node.dirty )
+            continue;
+        node.dirty = false;
+        bool changed = false;
+        for (Pad &pad : node.pad) {
+            if ( pad.counterPath.isEmpty() )
+                continue;
+            struct stat st;
+            if ( pad.counterFd < 0 || stat(pad.counterPath.constData(), &st) < 0
+                 || st.st_ino != pad.inode || st.st_dev != pad.device )
+                openCounter(pad);
+            readCounter(pad);
+            changed |= sample(pad);
+            changed |= updatePercent(pad);
+        }
+        if ( changed )
+            emit usageChanged(x);
+    }
+}
+
+void KeyUsage::openCounter(Pad &pad)
+{
+    closeCounter(pad);
+    pad.counterFd = ::open(pad.counterPath.constData(), O_RDONLY | O_CLOEXEC);
+    struct stat st;
+    if ( pad.counterFd >= 0 && fstat(pad.counterFd, &st) == 0 ) {
+        pad.device = st.st_dev;
+        pad.inode = st.st_ino;
+    }
+}
+
+void KeyUsage::closeCounter(Pad &pad)
+{
+    if ( pad.counterFd >= 0 )
+        ::close(pad.counterFd);
+    pad.counterFd = -1;
+    pad.counter = -1;
+}
+
+/*
+    Counter may be truncated and rewritten in place by tunnel, a short
+    read in that window is unknown until next change notification.
+*/
+void KeyUsage::readCounter(Pad &pad)
+{
+    long value;
+    if ( pad.counterFd >= 0 && pread(pad.counterFd, &value, sizeof(value), 0) == ssize_t(sizeof(value)) )
+        pad.counter = value;
+    else
+        pad.counter = -1;
+}
+
+/* Same rounding as before: 100 - used share of key, true on change */
+bool KeyUsage::updatePercent(Pad &pad)
+{
+    int percent = -1;
+    if ( pad.counter >= 0 && pad.keySize > 0 ) {
+        qint64 usedBytes = pad.counter;
+        percent = qBound(0, qRound(100.0 - (100.0 * double(usedBytes)) / double(pad.keySize)), 100);
+    }
+    if ( percent == pad.percent )
+        return false;
+    pad.percent = percent;
+    return true;
+}
+
+/*
+    Counter delta since previous sample into depletion rate. A counter
+    going backwards is a new pad, only the baseline is reset then.
+    True when counter moved.
+*/
+bool KeyUsage::sample(Pad &pad)
+{
+    qint64 now = m_clock.elapsed();
+    if ( pad.counter < 0 ) {
+        pad.lastUsed = -1;
+        return false;
+    }
+    qint64 usedBytes = pad.counter;
+    qint64 previous = pad.lastUsed;
+    qint64 interval = now - pad.lastSampleMs;
+    pad.lastUsed = usedBytes;
+    pad.lastSampleMs = now;
+    if ( previous < 0 || usedBytes <= previous )
+        return usedBytes != previous;
+    double delta = double(usedBytes - previous);
+    if ( m_inCall ) {
+        if ( interval <= 0 )
+            return true;
+        double rate = delta * 1000.0 / double(interval);
+        pad.audioRate = pad.audioRate > 0 ? pad.audioRate + KEY_RATE_WEIGHT * (rate - pad.audioRate) : rate;
+    } else {
+        pad.messageBytes = pad.messageBytes > 0 ? pad.messageBytes + KEY_RATE_WEIGHT * (delta - pad.messageBytes) : delta;
+    }
+    return true;
+}
+
+void KeyUsage::sampleAll()
+{
+    for (int x=0; x < m_nodes.size(); x++) {
+        bool changed = false;
+        for (Pad &pad : m_nodes[x].pad) {
+            if ( pad.counterPath.isEmpty() )
+                continue;
+            readCounter(pad);
+            changed |= sample(pad);
+            changed |= updatePercent(pad);
+        }
+        if ( changed )
+            emit usageChanged(x);
+    }
+}
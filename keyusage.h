@@ -0,0 +1,113 @@
+/*  Small Pine phone QML interface for Out-Of-Band communication.
+
+    Copyright (C) 2023 Resilience Theatre
+
+    This program is free software; you can redistribute it and/or
+    modify it under the terms of the GNU General Public License
+    as published by the Free Software Foundation; either version 2
+    of the License, or (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; If not, see <http://www.gnu.org/licenses/>.
+
+*/
+#ifndef KEYUSAGE_H
+#define KEYUSAGE_H
+#include <QObject>
+#include <QVector>
+#include <QTimer>
+#include <QElapsedTimer>
+#include <sys/types.h>
+#include "statuswatcher.h"
+
+#define KEY_DIRECTORY           "/opt/tunnel"
+#define KEY_USAGE_COALESCE      500     // ms, counter writes within are published once
+#define KEY_RATE_WEIGHT         0.25    // EWMA weight of newest consumption sample
+
+/*
+    Remaining one-time pad per peer. Key file paths are resolved and
+    immutable .inkey/.outkey sizes read once per roster. Counters
+    (.incount/.outcount, one native long) are kept open and read with
+    pread() and key directory is watched, so percentages are pushed
+    while calls and messages consume pad. Missing files and short
+    reads (counter being rewritten) read as unknown.
+
+    Counter deltas also feed depletion estimators: in call as audio
+    bytes per second, otherwise as bytes per message (one coalesced
+    delta is one message). Forecasts use the direction running out
+    first and are -1 until a rate has been seen. Rates are not kept
+    over restarts.
+*/
+class KeyUsage : public QObject
+{
+    Q_OBJECT
+
+public:
+    enum Direction {
+        KEY_IN,
+        KEY_OUT,
+        KEY_DIRECTION_COUNT
+    };
+
+    explicit KeyUsage(const QString &directory = KEY_DIRECTORY, QObject *parent = nullptr);
+    ~KeyUsage();
+    void setNodes(const QStringList &nodeIds, const QString &myNodeId);
+    void refresh();
+    int nodeCount() const;
+    int remainingPercent(int node, Direction direction) const;
+    qint64 keySize(int node, Direction direction) const;
+    qint64 used(int node, Direction direction) const;
+    void setInCall(bool inCall);
+    int talkSecondsLeft(int node) const;
+    int messagesLeft(int node) const;
+
+signals:
+    void usageChanged(int node);
+
+private slots:
+    void counterFileChanged(int id);
+    void publish();
+
+private:
+    struct Pad
+    {
+        QByteArray keyPath;
+        QByteArray counterPath;
+        qint64 keySize=-1;
+        int counterFd=-1;
+        qint64 counter=-1;      // last read value, -1 unknown
+        dev_t device=0;
+        ino_t inode=0;
+        int percent=-1;
+        qint64 lastUsed=-1;
+        qint64 lastSampleMs=0;
+        double audioRate=0;     // bytes/s in call
+        double messageBytes=0;  // bytes per message
+    };
+    struct Node
+    {
+        Pad pad[KEY_DIRECTION_COUNT];
+        bool dirty=false;
+    };
+    static void openCounter(Pad &pad);
+    static void closeCounter(Pad &pad);
+    static void readCounter(Pad &pad);
+    static bool updatePercent(Pad &pad);
+    bool sample(Pad &pad);
+    void sampleAll();
+
+    QByteArray m_directory;
+    StatusWatcher *m_watcher;
+    QTimer *m_publishTimer;
+    QVector<Node> m_nodes;
+    QVector<int> m_watchNode;       // watch id -> node index
+    QElapsedTimer m_clock;
+    bool m_inCall=false;
+};
+
+#endif // KEYUSAGE_H
@@ -0,0 +1,243 @@
+/*
+    small Pinephone QML interface for Out-Of-Band communication.
+
+    Copyright (C) 2023 Resilience Theatre
+
+    This program is free software; you can redistribute it and/or
+    modify it under the terms of the GNU General Public License
+    as published by the Free Software Foundation; either version 2
+    of the License, or (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "latencyprober.h"
+#include <QDebug>
+#include <algorithm>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <netinet/ip.h>
+#include <netinet/ip_icmp.h>
+#include <arpa/inet.h>
+#include <unistd.h>
+#include <errno.h>
+#include <string.h>
+
+#define PROBE_RECEIVE_BUFFER    512
+
+LatencyProber::LatencyProber(QObject *parent)
+    : QObject{parent}
+{
+    m_clock.start();
+    /* Ping socket needs net.ipv4.ping_group_range, raw socket needs CAP_NET_RAW */
+    m_fd = socket(AF_INET, SOCK_DGRAM | SOCK_NONBLOCK | SOCK_CLOEXEC, IPPROTO_ICMP);
+    if ( m_fd < 0 ) {
+        m_fd = socket(AF_INET, SOCK_RAW | SOCK_NONBLOCK | SOCK_CLOEXEC, IPPROTO_ICMP);
+        m_raw = true;
+    }
+    if ( m_fd < 0 ) {
+        qErrnoWarning(errno, "Cannot open ICMP socket, peer latency from status files");
+        return;
+    }
+    m_identifier = quint16(getpid());
+    m_notifier = new QSocketNotifier(m_fd, QSocketNotifier::Read, this);
+    connect(m_notifier, SIGNAL(activated(int)), this, SLOT(readReplies()));
+}
+
+LatencyProber::~LatencyProber()
+{
+    if ( m_fd >= 0 )
+        ::close(m_fd);
+}
+
+/* False if ICMP socket is not available, caller falls back to dpinger files */
+bool LatencyProber::isActive() const
+{
+    return m_fd >= 0;
+}
+
+void LatencyProber::setPeers(const QStringList &addresses)
+{
+    m_pending.clear();
+    m_peers.clear();
+    m_peers.resize(addresses.size());
+    for (int x=0; x < addresses.size(); x++) {
+        struct in_addr address;
+        if ( inet_pton(AF_INET, addresses.at(x).toLatin1().constData(), &address) == 1 )
+            m_peers[x].address = address.s_addr;
+        else
+            qDebug() << "Not an IPv4 peer address, not probed:" << addresses.at(x);
+    }
+}
+
+int LatencyProber::peerCount() const
+{
+    return m_peers.size();
+}
+
+const LinkStats &LatencyProber::stats(int peer) const
+{
+    return m_peers.at(peer).stats;
+}
+
+/* One probe round, unanswered probes of previous rounds are counted as lost first */
+void LatencyProber::probe()
+{
+    if ( m_fd < 0 )
+        return;
+    expire(m_clock.nsecsElapsed());
+    for (int x=0; x < m_peers.size(); x++) {
+        if ( m_peers.at(x).address == 0 )
+            continue;
+        struct {
+            struct icmphdr header;
+            char payload[PROBE_PAYLOAD];
+        } packet;
+        memset(&packet, 0, sizeof(packet));
+        packet.header.type = ICMP_ECHO;
+        packet.header.un.echo.id = htons(m_identifier);
+        packet.header.un.echo.sequence = htons(++m_sequence);
+        packet.header.checksum = checksum(&packet, sizeof(packet));
+        struct sockaddr_in destination;
+        memset(&destination, 0, sizeof(destination));
+        destination.sin_family = AF_INET;
+        destination.sin_addr.s_addr = m_peers.at(x).address;
+        qint64 sentNs = m_clock.nsecsElapsed();
+        if ( sendto(m_fd, &packet, sizeof(packet), 0,
+                    reinterpret_cast<struct sockaddr *>(&destination), sizeof(destination)) < 0 ) {
+            /* No route or interface down, same as lost probe */
+            record(x, -1);
+            continue;
+        }
+        m_pending.append({x, m_sequence, sentNs});
+    }
+}
+
+void LatencyProber::readReplies()
+{
+    char buffer[PROBE_RECEIVE_BUFFER];
+    for (;;) {
+        struct sockaddr_in source;
+        socklen_t sourceLength = sizeof(source);
+        ssize_t length = recvfrom(m_fd, buffer, sizeof(buffer), 0,
+                                  reinterpret_cast<struct sockaddr *>(&source), &sourceLength);
+        if ( length < 0 ) {
+            if ( errno == EINTR )
+                continue;
+            if ( errno != EAGAIN )
+                qErrnoWarning(errno, "ICMP receive failed");
+            break;
+        }
+        qint64 nowNs = m_clock.nsecsElapsed();
+        const char *icmp = buffer;
+        /* Raw socket delivers IP header as well, and echoes of every process */
+        if ( m_raw ) {
+            if ( length < ssize_t(sizeof(struct iphdr)) )
+                continue;
+            int headerLength = reinterpret_cast<const struct iphdr *>(buffer)->ihl * 4;
+            icmp += headerLength;
+            length -= headerLength;
+        }
+        if ( length < ssize_t(sizeof(struct icmphdr)) )
+            continue;
+        const struct icmphdr *header = reinterpret_cast<const struct icmphdr *>(icmp);
+        if ( header->type != ICMP_ECHOREPLY )
+            continue;
+        if ( m_raw && ntohs(header->un.echo.id) != m_identifier )
+            continue;
+        quint16 sequence = ntohs(header->un.echo.sequence);
+        for (int x=0; x < m_pending.size(); x++) {
+            const Pending &pending = m_pending.at(x);
+            if ( pending.sequence != sequence
+                 || m_peers.value(pending.peer).address != source.sin_addr.s_addr )
+                continue;
+            int peer = pending.peer;
+            int rttUs = int((nowNs - pending.sentNs) / 1000);
+            m_pending.remove(x);
+            record(peer, rttUs);
+            break;
+        }
+    }
+    expire(m_clock.nsecsElapsed());
+}
+
+void LatencyProber::expire(qint64 nowNs)
+{
+    for (int x=m_pending.size() - 1; x >= 0; x--) {
+        if ( nowNs - m_pending.at(x).sentNs < qint64(PROBE_TIMEOUT) * 1000000 )
+            continue;
+        int peer = m_pending.at(x).peer;
+        m_pending.remove(x);
+        record(peer, -1);
+    }
+}
+
+void LatencyProber::record(int peer, int rttUs)
+{
+    if ( peer < 0 || peer >= m_peers.size() )
+        return;
+    Peer &entry = m_peers[peer];
+    entry.rttUs[entry.head] = rttUs;
+    entry.head = (entry.head + 1) % PROBE_WINDOW;
+    entry.filled = qMin(entry.filled + 1, PROBE_WINDOW);
+    computeStats(entry);
+    emit statsChanged(peer);
+}
+
+/* Nearest rank percentiles, jitter as mean difference of consecutive replies */
+void LatencyProber::computeStats(Peer &peer)
+{
+    std::array<int, PROBE_WINDOW> sorted;
+    int count = 0;
+    int lost = 0;
+    long long jitterSum = 0;
+    int jitterCount = 0;
+    int previous = -1;
+    int oldest = (peer.head - peer.filled + PROBE_WINDOW) % PROBE_WINDOW;
+    for (int x=0; x < peer.filled; x++) {
+        int rtt = peer.rttUs[(oldest + x) % PROBE_WINDOW];
+        if ( rtt < 0 ) {
+            lost++;
+            continue;
+        }
+        sorted[count++] = rtt;
+        if ( previous >= 0 ) {
+            jitterSum += qAbs(rtt - previous);
+            jitterCount++;
+        }
+        previous = rtt;
+    }
+    LinkStats &stats = peer.stats;
+    stats.samples = peer.filled;
+    stats.lost = lost;
+    stats.lossPercent = peer.filled ? lost * 100 / peer.filled : 0;
+    stats.jitterUs = jitterCount ? int(jitterSum / jitterCount) : -1;
+    if ( count == 0 ) {
+        stats.p50Us = stats.p95Us = stats.p99Us = -1;
+        return;
+    }
+    std::sort(sorted.begin(), sorted.begin() + count);
+    auto percentile = [&](int p) { return sorted[qMax(0, (p * count + 99) / 100 - 1)]; };
+    stats.p50Us = percentile(50);
+    stats.p95Us = percentile(95);
+    stats.p99Us = percentile(99);
+}
+
+quint16 LatencyProber::checksum(const void *data, int length)
+{
+    const quint8 *bytes = static_cast<const quint8 *>(data);
+    quint32 sum = 0;
+    for (int x=0; x + 1 < length; x += 2)
+        sum += quint32(bytes[x] << 8 | bytes[x + 1]);
+    if ( length & 1 )
+        sum += quint32(bytes[length - 1] << 8);
+    while ( sum >> 16 )
+        sum = (sum & 0xFFFF) + (sum >> 16);
+    return htons(quint16(~sum));
+}
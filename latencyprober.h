@@ -0,0 +1,101 @@
+/*  Small Pine phone QML interface for Out-Of-Band communication.
+
+    Copyright (C) 2023 Resilience Theatre
+
+    This program is free software; you can redistribute it and/or
+    modify it under the terms of the GNU General Public License
+    as published by the Free Software Foundation; either version 2
+    of the License, or (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; If not, see <http://www.gnu.org/licenses/>.
+
+*/
+#ifndef LATENCYPROBER_H
+#define LATENCYPROBER_H
+#include <QObject>
+#include <QVector>
+#include <QElapsedTimer>
+#include <QSocketNotifier>
+#include <array>
+
+#define PROBE_WINDOW            32      // samples kept per peer
+#define PROBE_TIMEOUT           2000    // ms, unanswered probe is lost
+#define PROBE_PAYLOAD           16
+#define LATENCY_PROBE_ENV       "QTUI_LATENCY_PROBE"    // "off" sends no probes (tests/bench)
+
+/* Link quality of one peer over last PROBE_WINDOW probes, -1 when no replies */
+struct LinkStats
+{
+    int samples=0;
+    int lost=0;
+    int p50Us=-1;
+    int p95Us=-1;
+    int p99Us=-1;
+    int jitterUs=-1;
+    int lossPercent=0;
+};
+
+/*
+    ICMP echo prober for peer nodes. All peers share one non-blocking
+    socket (unprivileged ping socket, raw socket as fallback), probe()
+    sends one echo to every peer and replies are matched by source
+    address and sequence number. Each peer keeps a sliding window of
+    round trip times from which percentiles, jitter and loss are
+    computed after every reply or timeout.
+*/
+class LatencyProber : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit LatencyProber(QObject *parent = nullptr);
+    ~LatencyProber();
+    bool isActive() const;
+    void setPeers(const QStringList &addresses);
+    int peerCount() const;
+    const LinkStats &stats(int peer) const;
+    void probe();
+
+signals:
+    void statsChanged(int peer);
+
+private slots:
+    void readReplies();
+
+private:
+    struct Peer
+    {
+        quint32 address=0;      // network byte order, 0 if not IPv4
+        std::array<int, PROBE_WINDOW> rttUs{};  // -1 lost
+        int head=0;
+        int filled=0;
+        LinkStats stats;
+    };
+    struct Pending
+    {
+        int peer;
+        quint16 sequence;
+        qint64 sentNs;
+    };
+    void expire(qint64 nowNs);
+    void record(int peer, int rttUs);
+    static void computeStats(Peer &peer);
+    static quint16 checksum(const void *data, int length);
+
+    int m_fd=-1;
+    bool m_raw=false;
+    quint16 m_identifier=0;
+    quint16 m_sequence=0;
+    QSocketNotifier *m_notifier=nullptr;
+    QVector<Peer> m_peers;
+    QVector<Pending> m_pending;
+    QElapsedTimer m_clock;
+};
+
+#endif // LATENCYPROBER_H
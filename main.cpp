@@ -4,18 +4,100 @@
 #include <QQmlContext>
 #include <QGuiApplication> // added
 #include "engineclass.h"
+#include "assetimageprovider.h"
+#include "trace.h"
+#include <QElapsedTimer>
+#include <QQuickWindow>
+#include <QTimer>
+#include <QSettings>
+#include <QFile>
+#include <memory>
+
+#define BENCH_STARTUP_TIMEOUT   30000   // ms, bench fails if startup is not done by then
+
+/*
+    QTUI_BENCH_STARTUP=1: print time from main() to first frame and to
+    startup pipeline done, then quit. When value is a baseline file,
+    times are checked against its [startup] limits. Exit code is 1 on
+    timeout or regression. make bench_startup runs this through
+    "bench --startup" in an isolated root with a fake daemon.
+*/
+static bool checkStartupBaseline(const QString &baselineFile, qint64 firstFrame, qint64 ready)
+{
+    QSettings baseline(baselineFile, QSettings::IniFormat);
+    struct Metric { const char *name; qint64 value; const char *limitKey; };
+    const Metric metrics[] = {
+        { "first_frame_ms",     firstFrame,     "startup/first_frame_ms_max" },
+        { "ready_ms",           ready,          "startup/ready_ms_max" }
+    };
+    bool pass = true;
+    for (const Metric &metric : metrics) {
+        QVariant limit = baseline.value(metric.limitKey);
+        bool ok = !limit.isValid() || metric.value <= limit.toLongLong();
+        qInfo().noquote() << QString("bench_startup: %1 %2 limit %3 %4").arg(metric.name, -16)
+                             .arg(metric.value)
+                             .arg(limit.isValid() ? limit.toString() : "-")
+                             .arg(ok ? "ok" : "REGRESSION");
+        pass &= ok;
+    }
+    return pass;
+}
+
+static void benchStartup(QGuiApplication &app, QQmlApplicationEngine &engine, engineClass &eClass,
+                         const QElapsedTimer &clock)
+{
+    struct Marks { qint64 firstFrame=-1; qint64 ready=-1; bool reported=false; };
+    std::shared_ptr<Marks> marks = std::make_shared<Marks>();
+    auto report = [&app, &eClass, marks]() {
+        if ( marks->reported || marks->firstFrame < 0 || marks->ready < 0 )
+            return;
+        marks->reported = true;
+        qInfo().noquote() << "bench_startup: first frame" << marks->firstFrame << "ms, ready"
+                          << marks->ready << "ms\n" + eClass.getStartupTimeline();
+        QString baselineFile = qEnvironmentVariable(BENCH_STARTUP_ENV);
+        bool pass = !QFile::exists(baselineFile)
+                    || checkStartupBaseline(baselineFile, marks->firstFrame, marks->ready);
+        app.exit(pass ? 0 : 1);
+    };
+    QQuickWindow *window = qobject_cast<QQuickWindow *>(engine.rootObjects().value(0));
+    if ( !window ) {
+        qWarning() << "bench_startup: no root window";
+        marks->firstFrame = clock.elapsed();
+    } else {
+        QObject::connect(window, &QQuickWindow::frameSwapped, &app, [=, &clock]() {
+            if ( marks->firstFrame >= 0 )
+                return;
+            marks->firstFrame = clock.elapsed();
+            report();
+        });
+    }
+    QObject::connect(&eClass, &engineClass::startupFinished, &app, [=, &clock]() {
+        marks->ready = clock.elapsed();
+        report();
+    });
+    QTimer::singleShot(BENCH_STARTUP_TIMEOUT, &app, [&app]() {
+        qWarning() << "bench_startup: startup not done in" << BENCH_STARTUP_TIMEOUT << "ms";
+        app.exit(1);
+    });
+}
 
 int main(int argc, char *argv[])
 {
+    QElapsedTimer startupClock;
+    startupClock.start();
     qputenv("QT_IM_MODULE", QByteArray("qtvirtualkeyboard"));
     qputenv("QT_VIRTUALKEYBOARD_STYLE", "pineroot");
     qputenv("QT_QPA_FONTDIR", "/usr/share/fonts/");
     QCoreApplication::setAttribute(Qt::AA_EnableHighDpiScaling);
     QGuiApplication app(argc, argv);
+#ifdef QTUI_TRACING
+    TraceDumper traceDumper(qEnvironmentVariable(TRACE_FILE_ENV, TRACE_DEFAULT_FILE));
+#endif
     engineClass eClass;
     QQmlApplicationEngine engine;
     engine.rootContext()->setContextProperty("eClass",&eClass);
     engine.addImportPath(QStringLiteral("qrc:/"));
+    engine.addImageProvider(ASSET_PROVIDER_ID, new AssetImageProvider(eClass.assetCache()));
     engine.load(QUrl(QStringLiteral("qrc:/main.qml")));
 
     // Vault mode
@@ -31,5 +113,7 @@ int main(int argc, char *argv[])
     } else {
         eClass.setVaultMode(false);
     }
+    if ( qEnvironmentVariableIsSet(BENCH_STARTUP_ENV) )
+        benchStartup(app, engine, eClass, startupClock);
     return app.exec();
 }
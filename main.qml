@@ -207,12 +207,25 @@ ApplicationWindow {
             id: pageOne
         }
 
-        Page2Form {
-            id: pageTwo
+        // Messaging and settings pages are created when first swiped to, then kept
+        Loader {
+            id: pageTwoLoader
+            property bool used: false
+            active: used || SwipeView.isCurrentItem
+                    || (swipeView.contentItem.moving && (SwipeView.isNextItem || SwipeView.isPreviousItem))
+            asynchronous: !SwipeView.isCurrentItem
+            source: "Page2Form.qml"
+            onLoaded: used = true
         }
 
-        Page3Form {
-            id: pageThree
+        Loader {
+            id: pageThreeLoader
+            property bool used: false
+            active: used || SwipeView.isCurrentItem
+                    || (swipeView.contentItem.moving && (SwipeView.isNextItem || SwipeView.isPreviousItem))
+            asynchronous: !SwipeView.isCurrentItem
+            source: "Page3Form.qml"
+            onLoaded: used = true
         }
         onCurrentIndexChanged: {
             eClass.registerTouch()
@@ -243,7 +256,10 @@ ApplicationWindow {
             id: camoScreenImage
             anchors.centerIn: parent
             anchors.fill: parent
-            source: "mainscreen.png"
+            // decoded off-thread at screen size only while shown, asset cache keeps it
+            source: camoScreenFrame.visible ? "image://assets/mainscreen.png" : ""
+            sourceSize: Qt.size(Screen.width, Screen.height)
+            cache: false
         }
     }
 
@@ -266,7 +282,10 @@ ApplicationWindow {
             id: lockScreenImage
             anchors.centerIn: parent
             anchors.fill: parent
-            source: "lockscreen.png"
+            // prewarmed by engine before device locks
+            source: lockScreenFrame.visible ? "image://assets/lockscreen.png" : ""
+            sourceSize: Qt.size(Screen.width, Screen.height)
+            cache: false
         }
 
         // Vault pin indication
@@ -560,33 +579,49 @@ ApplicationWindow {
     }
 
     // Input panel
-    InputPanel {
-        id: inputPanel
+    // Keyboard is built once first frame is on screen, not before anyone can type
+    Loader {
+        id: inputPanelLoader
         z: 99
-        x: 0
-        y: window.height
-        width: window.width
-        Component.onCompleted: {
-        }
-        states: State {
-            name: "visible"
-            when: (swipeView.currentIndex == "1" || inputPanel.active )
-            PropertyChanges {
-                target: inputPanel
-                y: window.height - inputPanel.height
-            }
-        }
-        transitions: Transition {
-            from: ""
-            to: "visible"
-            reversible: true
-            ParallelAnimation {
-                NumberAnimation {
-                    properties: "y"
-                    duration: 250
-                    easing.type: Easing.InOutQuad
+        active: false
+        asynchronous: true
+        sourceComponent: Component {
+            InputPanel {
+                id: inputPanel
+                z: 99
+                x: 0
+                y: window.height
+                width: window.width
+                Component.onCompleted: {
+                }
+                states: State {
+                    name: "visible"
+                    when: (swipeView.currentIndex == "1" || inputPanel.active )
+                    PropertyChanges {
+                        target: inputPanel
+                        y: window.height - inputPanel.height
+                    }
+                }
+                transitions: Transition {
+                    from: ""
+                    to: "visible"
+                    reversible: true
+                    ParallelAnimation {
+                        NumberAnimation {
+                            properties: "y"
+                            duration: 250
+                            easing.type: Easing.InOutQuad
+                        }
+                    }
                 }
             }
         }
     }
+    Connections {
+        target: window
+        enabled: !inputPanelLoader.active
+        function onFrameSwapped() {
+            inputPanelLoader.active = true
+        }
+    }
 }
@@ -0,0 +1,114 @@
+/*
+    small Pinephone QML interface for Out-Of-Band communication.
+
+    Copyright (C) 2023 Resilience Theatre
+
+    This program is free software; you can redistribute it and/or
+    modify it under the terms of the GNU General Public License
+    as published by the Free Software Foundation; either version 2
+    of the License, or (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "messagemodel.h"
+#include <QDateTime>
+
+MessageModel::MessageModel(QObject *parent, int capacity)
+    : QAbstractListModel{parent}
+{
+    m_ring.resize(qMax(1, capacity));
+}
+
+int MessageModel::rowCount(const QModelIndex &parent) const
+{
+    if ( parent.isValid() )
+        return 0;
+    return m_count;
+}
+
+QVariant MessageModel::data(const QModelIndex &index, int role) const
+{
+    if ( !index.isValid() || index.row() >= m_count )
+        return QVariant();
+    const Message &message = at(index.row());
+    switch ( role ) {
+    case Qt::DisplayRole:
+    case TextRole:
+        return message.text;
+    case DirectionRole:
+        if ( message.direction == MESSAGE_LOCAL )
+            return QStringLiteral("local");
+        if ( message.direction == MESSAGE_REMOTE )
+            return QStringLiteral("remote");
+        return QStringLiteral("notice");
+    case TimestampRole:
+        return QDateTime::fromMSecsSinceEpoch(message.timestamp);
+    }
+    return QVariant();
+}
+
+QHash<int, QByteArray> MessageModel::roleNames() const
+{
+    QHash<int, QByteArray> roles;
+    roles[TextRole] = "text";
+    roles[DirectionRole] = "direction";
+    roles[TimestampRole] = "timestamp";
+    return roles;
+}
+
+int MessageModel::count() const
+{
+    return m_count;
+}
+
+int MessageModel::capacity() const
+{
+    return m_ring.size();
+}
+
+void MessageModel::append(Direction direction, const QString &text)
+{
+    int capacity = m_ring.size();
+    int previousCount = m_count;
+    /* Full: drop oldest row, its slot is reused below */
+    if ( m_count == capacity ) {
+        beginRemoveRows(QModelIndex(), 0, 0);
+        m_head = (m_head + 1) % capacity;
+        m_count--;
+        endRemoveRows();
+    }
+    beginInsertRows(QModelIndex(), m_count, m_count);
+    Message &message = m_ring[(m_head + m_count) % capacity];
+    message.direction = direction;
+    message.timestamp = QDateTime::currentMSecsSinceEpoch();
+    message.text = text.left(MESSAGE_TEXT_MAX);
+    m_count++;
+    endInsertRows();
+    if ( m_count != previousCount )
+        emit countChanged();
+}
+
+void MessageModel::clear()
+{
+    if ( m_count == 0 )
+        return;
+    beginResetModel();
+    for (int x=0; x < m_ring.size(); x++)
+        m_ring[x].text.clear();
+    m_head = 0;
+    m_count = 0;
+    endResetModel();
+    emit countChanged();
+}
+
+const MessageModel::Message &MessageModel::at(int row) const
+{
+    return m_ring.at((m_head + row) % m_ring.size());
+}
@@ -0,0 +1,78 @@
+/*  Small Pine phone QML interface for Out-Of-Band communication.
+
+    Copyright (C) 2023 Resilience Theatre
+
+    This program is free software; you can redistribute it and/or
+    modify it under the terms of the GNU General Public License
+    as published by the Free Software Foundation; either version 2
+    of the License, or (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; If not, see <http://www.gnu.org/licenses/>.
+
+*/
+#ifndef MESSAGEMODEL_H
+#define MESSAGEMODEL_H
+#include <QAbstractListModel>
+#include <QVector>
+
+#define MESSAGE_HISTORY_CAPACITY    200
+#define MESSAGE_TEXT_MAX            1024    // chars, longer remote messages are cut
+
+/*
+    Message history of messaging page. Messages live in a ring buffer
+    allocated once for MESSAGE_HISTORY_CAPACITY entries, when it is
+    full the oldest message is dropped. Appending is O(1).
+*/
+class MessageModel : public QAbstractListModel
+{
+    Q_OBJECT
+    Q_PROPERTY(int count READ count NOTIFY countChanged)
+
+public:
+    enum Direction {
+        MESSAGE_LOCAL,
+        MESSAGE_REMOTE,
+        MESSAGE_NOTICE
+    };
+
+    enum MessageRoles {
+        TextRole = Qt::UserRole + 1,
+        DirectionRole,
+        TimestampRole
+    };
+
+    struct Message
+    {
+        Direction direction=MESSAGE_NOTICE;
+        qint64 timestamp=0;     // ms since epoch
+        QString text;
+    };
+
+    explicit MessageModel(QObject *parent = nullptr, int capacity = MESSAGE_HISTORY_CAPACITY);
+    int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
+    QHash<int, QByteArray> roleNames() const override;
+
+    int count() const;
+    int capacity() const;
+    void append(Direction direction, const QString &text);
+    void clear();
+
+signals:
+    void countChanged();
+
+private:
+    const Message &at(int row) const;
+
+    QVector<Message> m_ring;
+    int m_head=0;       // slot of oldest message
+    int m_count=0;
+};
+
+#endif // MESSAGEMODEL_H
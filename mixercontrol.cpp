@@ -0,0 +1,132 @@
+/*
+    small Pinephone QML interface for Out-Of-Band communication.
+
+    Copyright (C) 2023 Resilience Theatre
+
+    This program is free software; you can redistribute it and/or
+    modify it under the terms of the GNU General Public License
+    as published by the Free Software Foundation; either version 2
+    of the License, or (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "mixercontrol.h"
+#include <QDebug>
+#include <QtGlobal>
+#include <alsa/asoundlib.h>
+
+MixerControl::MixerControl(const char *card)
+{
+    if ( qstrcmp(card, MIXER_CARD_NONE) == 0 )
+        return;
+    int rc = snd_mixer_open(&m_mixer, 0);
+    if ( rc < 0 ) {
+        qWarning() << "Cannot open mixer:" << snd_strerror(rc);
+        m_mixer = nullptr;
+        return;
+    }
+    if ( (rc = snd_mixer_attach(m_mixer, card)) < 0
+         || (rc = snd_mixer_selem_register(m_mixer, nullptr, nullptr)) < 0
+         || (rc = snd_mixer_load(m_mixer)) < 0 ) {
+        qWarning() << "Cannot load mixer" << card << ":" << snd_strerror(rc);
+        snd_mixer_close(m_mixer);
+        m_mixer = nullptr;
+        return;
+    }
+    m_earpiece = findElement(MIXER_EARPIECE);
+    m_headphone = findElement(MIXER_HEADPHONE);
+    m_internalMic = findElement(MIXER_INTERNAL_MIC);
+    m_headsetMic = findElement(MIXER_HEADSET_MIC);
+    m_capture = findElement(MIXER_CAPTURE);
+}
+
+MixerControl::~MixerControl()
+{
+    if ( m_mixer )
+        snd_mixer_close(m_mixer);
+}
+
+bool MixerControl::isOpen() const
+{
+    return m_mixer != nullptr;
+}
+
+snd_mixer_elem_t *MixerControl::findElement(const char *name)
+{
+    snd_mixer_selem_id_t *id;
+    snd_mixer_selem_id_alloca(&id);
+    snd_mixer_selem_id_set_index(id, 0);
+    snd_mixer_selem_id_set_name(id, name);
+    snd_mixer_elem_t *element = snd_mixer_find_selem(m_mixer, id);
+    if ( !element )
+        qDebug() << "Mixer element not found:" << name;
+    return element;
+}
+
+/* Same scale as 'amixer sset NAME Playback N%' */
+bool MixerControl::setPlaybackPercent(snd_mixer_elem_t *element, int percent)
+{
+    if ( !element || !snd_mixer_selem_has_playback_volume(element) )
+        return false;
+    long min, max;
+    snd_mixer_selem_get_playback_volume_range(element, &min, &max);
+    long value = min + (max - min) * qBound(0, percent, 100) / 100;
+    return snd_mixer_selem_set_playback_volume_all(element, value) == 0;
+}
+
+void MixerControl::setPlaybackSwitch(snd_mixer_elem_t *element, bool on)
+{
+    if ( element && snd_mixer_selem_has_playback_switch(element) )
+        snd_mixer_selem_set_playback_switch_all(element, on ? 1 : 0);
+}
+
+void MixerControl::setCaptureSwitch(snd_mixer_elem_t *element, bool on)
+{
+    if ( element && snd_mixer_selem_has_capture_switch(element) )
+        snd_mixer_selem_set_capture_switch_all(element, on ? 1 : 0);
+}
+
+/* Earpiece and internal mic, or headphone and headset mic. Volume follows route. */
+void MixerControl::setRoute(Route route)
+{
+    m_route = route;
+    if ( !m_mixer )
+        return;
+    bool headphone = route == ROUTE_HEADPHONE;
+    setPlaybackSwitch(m_headphone, headphone);
+    setPlaybackSwitch(m_earpiece, !headphone);
+    setCaptureSwitch(m_headsetMic, headphone);
+    setCaptureSwitch(m_internalMic, !headphone);
+    if ( m_playbackPercent >= 0 )
+        setPlaybackPercent(headphone ? m_headphone : m_earpiece, m_playbackPercent);
+}
+
+MixerControl::Route MixerControl::route() const
+{
+    return m_route;
+}
+
+bool MixerControl::setPlaybackVolume(int percent)
+{
+    m_playbackPercent = percent;
+    if ( !m_mixer )
+        return false;
+    return setPlaybackPercent(m_route == ROUTE_HEADPHONE ? m_headphone : m_earpiece, percent);
+}
+
+bool MixerControl::setCaptureVolume(int percent)
+{
+    if ( !m_mixer || !m_capture || !snd_mixer_selem_has_capture_volume(m_capture) )
+        return false;
+    long min, max;
+    snd_mixer_selem_get_capture_volume_range(m_capture, &min, &max);
+    long value = min + (max - min) * qBound(0, percent, 100) / 100;
+    return snd_mixer_selem_set_capture_volume_all(m_capture, value) == 0;
+}
@@ -0,0 +1,75 @@
+/*  Small Pine phone QML interface for Out-Of-Band communication.
+
+    Copyright (C) 2023 Resilience Theatre
+
+    This program is free software; you can redistribute it and/or
+    modify it under the terms of the GNU General Public License
+    as published by the Free Software Foundation; either version 2
+    of the License, or (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; If not, see <http://www.gnu.org/licenses/>.
+
+*/
+#ifndef MIXERCONTROL_H
+#define MIXERCONTROL_H
+
+#define MIXER_CARD              "default"
+#define MIXER_CARD_ENV          "QTUI_MIXER_CARD"   // ALSA card, "none" for no mixer (tests/bench)
+#define MIXER_CARD_NONE         "none"
+#define MIXER_EARPIECE          "Earpiece"
+#define MIXER_HEADPHONE         "Headphone"
+#define MIXER_INTERNAL_MIC      "Mic1"
+#define MIXER_HEADSET_MIC       "Mic2"
+#define MIXER_CAPTURE           "Mic"
+
+typedef struct _snd_mixer snd_mixer_t;
+typedef struct _snd_mixer_elem snd_mixer_elem_t;
+
+/*
+    libasound simple mixer kept open for process lifetime. Elements
+    are looked up once, volume and routing changes are plain control
+    writes without spawning amixer or routing scripts. Card "none"
+    leaves mixer closed and every change is ignored.
+*/
+class MixerControl
+{
+public:
+    enum Route {
+        ROUTE_EARPIECE,
+        ROUTE_HEADPHONE
+    };
+
+    explicit MixerControl(const char *card = MIXER_CARD);
+    ~MixerControl();
+    MixerControl(const MixerControl &) = delete;
+    MixerControl &operator=(const MixerControl &) = delete;
+
+    bool isOpen() const;
+    void setRoute(Route route);
+    Route route() const;
+    bool setPlaybackVolume(int percent);
+    bool setCaptureVolume(int percent);
+
+private:
+    snd_mixer_elem_t *findElement(const char *name);
+    static bool setPlaybackPercent(snd_mixer_elem_t *element, int percent);
+    static void setPlaybackSwitch(snd_mixer_elem_t *element, bool on);
+    static void setCaptureSwitch(snd_mixer_elem_t *element, bool on);
+
+    snd_mixer_t *m_mixer=nullptr;
+    snd_mixer_elem_t *m_earpiece=nullptr;
+    snd_mixer_elem_t *m_headphone=nullptr;
+    snd_mixer_elem_t *m_internalMic=nullptr;
+    snd_mixer_elem_t *m_headsetMic=nullptr;
+    snd_mixer_elem_t *m_capture=nullptr;
+    Route m_route=ROUTE_EARPIECE;
+    int m_playbackPercent=-1;
+};
+
+#endif // MIXERCONTROL_H
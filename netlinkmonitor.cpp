@@ -0,0 +1,217 @@
+/*
+    small Pinephone QML interface for Out-Of-Band communication.
+
+    Copyright (C) 2023 Resilience Theatre
+
+    This program is free software; you can redistribute it and/or
+    modify it under the terms of the GNU General Public License
+    as published by the Free Software Foundation; either version 2
+    of the License, or (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "netlinkmonitor.h"
+#include <QDebug>
+#include <sys/socket.h>
+#include <linux/netlink.h>
+#include <linux/rtnetlink.h>
+#include <net/if.h>
+#include <unistd.h>
+#include <errno.h>
+#include <string.h>
+
+NetlinkMonitor::NetlinkMonitor(QObject *parent)
+    : QObject{parent}
+{
+    m_fd = socket(AF_NETLINK, SOCK_RAW | SOCK_NONBLOCK | SOCK_CLOEXEC, NETLINK_ROUTE);
+    if ( m_fd < 0 ) {
+        qErrnoWarning(errno, "netlink socket failed");
+        return;
+    }
+    struct sockaddr_nl address;
+    memset(&address, 0, sizeof(address));
+    address.nl_family = AF_NETLINK;
+    address.nl_groups = RTMGRP_LINK | RTMGRP_IPV4_ROUTE;
+    if ( bind(m_fd, reinterpret_cast<struct sockaddr *>(&address), sizeof(address)) < 0 ) {
+        qErrnoWarning(errno, "netlink bind failed");
+        ::close(m_fd);
+        m_fd = -1;
+        return;
+    }
+    m_notifier = new QSocketNotifier(m_fd, QSocketNotifier::Read, this);
+    connect(m_notifier, SIGNAL(activated(int)), this, SLOT(readMessages()));
+    /* Links first so route ifindexes resolve to names, routes after NLMSG_DONE */
+    requestDump(RTM_GETLINK);
+}
+
+NetlinkMonitor::~NetlinkMonitor()
+{
+    if ( m_fd >= 0 )
+        ::close(m_fd);
+}
+
+/* False if netlink is not available, caller has to poll */
+bool NetlinkMonitor::isActive() const
+{
+    return m_fd >= 0;
+}
+
+QString NetlinkMonitor::defaultRouteInterface() const
+{
+    return m_defaultRouteInterface;
+}
+
+bool NetlinkMonitor::isLinkUp(const QString &name) const
+{
+    for (const Link &link : m_links) {
+        if ( link.name == name )
+            return link.up;
+    }
+    return false;
+}
+
+bool NetlinkMonitor::requestDump(int type)
+{
+    struct {
+        struct nlmsghdr header;
+        struct rtgenmsg message;
+    } request;
+    memset(&request, 0, sizeof(request));
+    request.header.nlmsg_len = NLMSG_LENGTH(sizeof(struct rtgenmsg));
+    request.header.nlmsg_type = quint16(type);
+    request.header.nlmsg_flags = NLM_F_REQUEST | NLM_F_DUMP;
+    request.header.nlmsg_seq = ++m_sequence;
+    request.message.rtgen_family = type == RTM_GETROUTE ? AF_INET : AF_UNSPEC;
+    if ( send(m_fd, &request, request.header.nlmsg_len, 0) < 0 ) {
+        qErrnoWarning(errno, "netlink dump request failed");
+        return false;
+    }
+    return true;
+}
+
+void NetlinkMonitor::readMessages()
+{
+    alignas(struct nlmsghdr) char buffer[NETLINK_BUFFER];
+    for (;;) {
+        ssize_t length = recv(m_fd, buffer, sizeof(buffer), 0);
+        if ( length < 0 ) {
+            if ( errno == EINTR )
+                continue;
+            if ( errno == ENOBUFS ) {
+                /* Multicasts lost, rebuild state from fresh dumps */
+                qWarning() << "netlink overrun, reloading links and routes";
+                m_dumpState = DUMP_LINKS;
+                requestDump(RTM_GETLINK);
+                continue;
+            }
+            if ( errno != EAGAIN )
+                qErrnoWarning(errno, "netlink read failed");
+            break;
+        }
+        if ( length == 0 )
+            break;
+        int remaining = int(length);
+        for (const struct nlmsghdr *message = reinterpret_cast<const struct nlmsghdr *>(buffer);
+             NLMSG_OK(message, remaining); message = NLMSG_NEXT(message, remaining))
+            handleMessage(message);
+    }
+}
+
+void NetlinkMonitor::handleMessage(const struct nlmsghdr *message)
+{
+    switch ( message->nlmsg_type ) {
+    case NLMSG_DONE:
+        if ( m_dumpState == DUMP_LINKS ) {
+            m_dumpState = DUMP_ROUTES;
+            m_defaultRoutes.clear();
+            requestDump(RTM_GETROUTE);
+        } else if ( m_dumpState == DUMP_ROUTES ) {
+            m_dumpState = DUMP_DONE;
+            updateDefaultRoute();
+        }
+        break;
+    case NLMSG_ERROR:
+        qWarning() << "netlink error reply";
+        break;
+    case RTM_NEWLINK:
+    case RTM_DELLINK:
+        handleLink(message);
+        break;
+    case RTM_NEWROUTE:
+    case RTM_DELROUTE:
+        handleRoute(message);
+        break;
+    }
+}
+
+void NetlinkMonitor::handleLink(const struct nlmsghdr *message)
+{
+    const struct ifinfomsg *info = static_cast<const struct ifinfomsg *>(NLMSG_DATA(message));
+    if ( message->nlmsg_type == RTM_DELLINK ) {
+        Link link = m_links.take(info->ifi_index);
+        if ( link.up )
+            emit linkChanged(link.name, false);
+        return;
+    }
+    Link link = m_links.value(info->ifi_index);
+    bool wasUp = link.up;
+    int attributeLength = int(IFLA_PAYLOAD(message));
+    for (const struct rtattr *attribute = IFLA_RTA(info); RTA_OK(attribute, attributeLength);
+         attribute = RTA_NEXT(attribute, attributeLength)) {
+        if ( attribute->rta_type == IFLA_IFNAME )
+            link.name = QString::fromLatin1(static_cast<const char *>(RTA_DATA(attribute)));
+    }
+    link.up = (info->ifi_flags & IFF_UP) && (info->ifi_flags & IFF_RUNNING);
+    m_links.insert(info->ifi_index, link);
+    if ( link.up != wasUp )
+        emit linkChanged(link.name, link.up);
+}
+
+/* Only IPv4 default routes of main table are kept */
+void NetlinkMonitor::handleRoute(const struct nlmsghdr *message)
+{
+    const struct rtmsg *route = static_cast<const struct rtmsg *>(NLMSG_DATA(message));
+    if ( route->rtm_family != AF_INET || route->rtm_dst_len != 0 || route->rtm_table != RT_TABLE_MAIN )
+        return;
+    DefaultRoute entry;
+    int attributeLength = int(RTM_PAYLOAD(message));
+    for (const struct rtattr *attribute = RTM_RTA(route); RTA_OK(attribute, attributeLength);
+         attribute = RTA_NEXT(attribute, attributeLength)) {
+        if ( attribute->rta_type == RTA_OIF )
+            entry.ifindex = *static_cast<const int *>(RTA_DATA(attribute));
+        else if ( attribute->rta_type == RTA_PRIORITY )
+            entry.priority = *static_cast<const quint32 *>(RTA_DATA(attribute));
+    }
+    for (int x=0; x < m_defaultRoutes.size(); x++) {
+        if ( m_defaultRoutes.at(x).ifindex == entry.ifindex
+             && m_defaultRoutes.at(x).priority == entry.priority ) {
+            m_defaultRoutes.remove(x);
+            break;
+        }
+    }
+    if ( message->nlmsg_type == RTM_NEWROUTE )
+        m_defaultRoutes.append(entry);
+    if ( m_dumpState == DUMP_DONE )
+        updateDefaultRoute();
+}
+
+void NetlinkMonitor::updateDefaultRoute()
+{
+    const DefaultRoute *best = nullptr;
+    for (const DefaultRoute &route : m_defaultRoutes) {
+        if ( !best || route.priority < best->priority )
+            best = &route;
+    }
+    QString name = best ? m_links.value(best->ifindex).name : QString();
+    if ( name == m_defaultRouteInterface )
+        return;
+    m_defaultRouteInterface = name;
+    emit defaultRouteChanged(m_defaultRouteInterface);
+}
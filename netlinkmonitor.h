@@ -0,0 +1,83 @@
+/*  Small Pine phone QML interface for Out-Of-Band communication.
+
+    Copyright (C) 2023 Resilience Theatre
+
+    This program is free software; you can redistribute it and/or
+    modify it under the terms of the GNU General Public License
+    as published by the Free Software Foundation; either version 2
+    of the License, or (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; If not, see <http://www.gnu.org/licenses/>.
+
+*/
+#ifndef NETLINKMONITOR_H
+#define NETLINKMONITOR_H
+#include <QObject>
+#include <QHash>
+#include <QVector>
+#include <QSocketNotifier>
+
+#define NETLINK_BUFFER          8192
+
+/*
+    rtnetlink subscriber for IPv4 routes and links. Initial state
+    comes from link and route dumps, after that kernel multicasts
+    keep interface names, link states and IPv4 default routes in
+    memory. Default route interface is the one with lowest metric.
+*/
+class NetlinkMonitor : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit NetlinkMonitor(QObject *parent = nullptr);
+    ~NetlinkMonitor();
+    bool isActive() const;
+    QString defaultRouteInterface() const;
+    bool isLinkUp(const QString &name) const;
+
+signals:
+    void defaultRouteChanged(const QString &interfaceName);
+    void linkChanged(const QString &interfaceName, bool up);
+
+private slots:
+    void readMessages();
+
+private:
+    struct Link
+    {
+        QString name;
+        bool up=false;
+    };
+    struct DefaultRoute
+    {
+        int ifindex=0;
+        quint32 priority=0;
+    };
+    enum DumpState {
+        DUMP_LINKS,
+        DUMP_ROUTES,
+        DUMP_DONE
+    };
+    bool requestDump(int type);
+    void handleMessage(const struct nlmsghdr *message);
+    void handleLink(const struct nlmsghdr *message);
+    void handleRoute(const struct nlmsghdr *message);
+    void updateDefaultRoute();
+
+    int m_fd=-1;
+    quint32 m_sequence=0;
+    DumpState m_dumpState=DUMP_LINKS;
+    QSocketNotifier *m_notifier=nullptr;
+    QHash<int, Link> m_links;
+    QVector<DefaultRoute> m_defaultRoutes;
+    QString m_defaultRouteInterface;
+};
+
+#endif // NETLINKMONITOR_H
@@ -0,0 +1,256 @@
+/*
+    small Pinephone QML interface for Out-Of-Band communication.
+
+    Copyright (C) 2023 Resilience Theatre
+
+    This program is free software; you can redistribute it and/or
+    modify it under the terms of the GNU General Public License
+    as published by the Free Software Foundation; either version 2
+    of the License, or (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "peermodel.h"
+
+PeerModel::PeerModel(QObject *parent)
+    : QAbstractListModel{parent}
+{
+}
+
+int PeerModel::rowCount(const QModelIndex &parent) const
+{
+    if ( parent.isValid() )
+        return 0;
+    return m_peers.size();
+}
+
+QVariant PeerModel::data(const QModelIndex &index, int role) const
+{
+    if ( !index.isValid() || index.row() >= m_peers.size() )
+        return QVariant();
+    const Peer &peer = m_peers.at(index.row());
+    switch ( role ) {
+    case Qt::DisplayRole:
+    case NameRole:
+        return peer.name;
+    case NameColorRole:
+        return peer.nameColor;
+    case LabelRole:
+        return peer.label;
+    case LabelColorRole:
+        return peer.labelColor;
+    case ActiveRole:
+        return peer.active;
+    case KeyPercentageRole:
+        if ( peer.keyPercentageIn.isEmpty() )
+            return QString();
+        return peer.keyPercentageIn + "/" + peer.keyPercentageOut;
+    case LatencyRole:
+        return peer.latency;
+    case LatencyP95Role:
+        return peer.latencyP95;
+    case JitterRole:
+        return peer.jitter;
+    case LossRole:
+        return peer.loss;
+    case LinkQualityRole:
+        if ( peer.loss < 0 )
+            return QString();
+        if ( peer.loss == 100 )
+            return QStringLiteral("offline");
+        if ( peer.latencyP95 < 0 )
+            return QString::number(peer.latency) + "ms " + QString::number(peer.loss) + "%";
+        return QString::number(peer.latency) + "/" + QString::number(peer.latencyP95)
+                + "ms " + QString::number(peer.loss) + "%";
+    case TalkTimeLeftRole:
+        return peer.talkTimeLeft;
+    case MessagesLeftRole:
+        return peer.messagesLeft;
+    case KeyForecastRole: {
+        QStringList parts;
+        if ( peer.talkTimeLeft >= 3600 )
+            parts << QString::number(peer.talkTimeLeft / 3600) + "h";
+        else if ( peer.talkTimeLeft >= 0 )
+            parts << QString::number(peer.talkTimeLeft / 60) + "min";
+        if ( peer.messagesLeft >= 0 )
+            parts << QString::number(peer.messagesLeft) + "msg";
+        return parts.join(" ");
+    }
+    }
+    return QVariant();
+}
+
+QHash<int, QByteArray> PeerModel::roleNames() const
+{
+    QHash<int, QByteArray> roles;
+    roles[NameRole] = "name";
+    roles[NameColorRole] = "nameColor";
+    roles[LabelRole] = "label";
+    roles[LabelColorRole] = "labelColor";
+    roles[ActiveRole] = "active";
+    roles[KeyPercentageRole] = "keyPercentage";
+    roles[LatencyRole] = "latency";
+    roles[LatencyP95Role] = "latencyP95";
+    roles[JitterRole] = "jitter";
+    roles[LossRole] = "loss";
+    roles[LinkQualityRole] = "linkQuality";
+    roles[TalkTimeLeftRole] = "talkTimeLeft";
+    roles[MessagesLeftRole] = "messagesLeft";
+    roles[KeyForecastRole] = "keyForecast";
+    return roles;
+}
+
+int PeerModel::count() const
+{
+    return m_peers.size();
+}
+
+const PeerModel::Peer &PeerModel::peer(int row) const
+{
+    return m_peers.at(row);
+}
+
+/* New roster from settings, only time whole model is reset */
+void PeerModel::setPeers(const QStringList &names)
+{
+    bool countChange = names.size() != m_peers.size();
+    beginResetModel();
+    m_peers.clear();
+    m_peers.resize(names.size());
+    for (int x=0; x < names.size(); x++)
+        m_peers[x].name = names.at(x);
+    endResetModel();
+    if ( countChange )
+        emit countChanged();
+}
+
+void PeerModel::setNameColor(int row, const QString &color)
+{
+    if ( row < 0 || row >= m_peers.size() || m_peers.at(row).nameColor == color )
+        return;
+    m_peers[row].nameColor = color;
+    notify(row, {NameColorRole});
+}
+
+void PeerModel::setAllNameColors(const QString &color)
+{
+    for (int x=0; x < m_peers.size(); x++)
+        setNameColor(x, color);
+}
+
+void PeerModel::setLabel(int row, bool visible, const QString &color)
+{
+    if ( row < 0 || row >= m_peers.size() )
+        return;
+    QVector<int> roles;
+    Peer &peer = m_peers[row];
+    if ( peer.label != visible ) {
+        peer.label = visible;
+        roles << LabelRole;
+    }
+    if ( peer.labelColor != color ) {
+        peer.labelColor = color;
+        roles << LabelColorRole;
+    }
+    if ( !roles.isEmpty() )
+        notify(row, roles);
+}
+
+void PeerModel::clearLabels()
+{
+    for (int x=0; x < m_peers.size(); x++) {
+        if ( !m_peers.at(x).label )
+            continue;
+        m_peers[x].label = false;
+        notify(x, {LabelRole});
+    }
+}
+
+void PeerModel::setActive(int row, bool active)
+{
+    if ( row < 0 || row >= m_peers.size() || m_peers.at(row).active == active )
+        return;
+    m_peers[row].active = active;
+    notify(row, {ActiveRole});
+}
+
+void PeerModel::setAllActive(bool active)
+{
+    for (int x=0; x < m_peers.size(); x++)
+        setActive(x, active);
+}
+
+void PeerModel::setKeyPercentage(int row, const QString &in, const QString &out)
+{
+    if ( row < 0 || row >= m_peers.size() )
+        return;
+    Peer &peer = m_peers[row];
+    if ( peer.keyPercentageIn == in && peer.keyPercentageOut == out )
+        return;
+    peer.keyPercentageIn = in;
+    peer.keyPercentageOut = out;
+    notify(row, {KeyPercentageRole});
+}
+
+/* Prober or dpinger statistics, link quality text follows any change */
+void PeerModel::setLinkStats(int row, int latency, int latencyP95, int jitter, int loss)
+{
+    if ( row < 0 || row >= m_peers.size() )
+        return;
+    QVector<int> roles;
+    Peer &peer = m_peers[row];
+    if ( peer.latency != latency ) {
+        peer.latency = latency;
+        roles << LatencyRole;
+    }
+    if ( peer.latencyP95 != latencyP95 ) {
+        peer.latencyP95 = latencyP95;
+        roles << LatencyP95Role;
+    }
+    if ( peer.jitter != jitter ) {
+        peer.jitter = jitter;
+        roles << JitterRole;
+    }
+    if ( peer.loss != loss ) {
+        peer.loss = loss;
+        roles << LossRole;
+    }
+    if ( roles.isEmpty() )
+        return;
+    roles << LinkQualityRole;
+    notify(row, roles);
+}
+
+/* Pad depletion forecast, forecast text follows any change */
+void PeerModel::setKeyForecast(int row, int talkTimeLeft, int messagesLeft)
+{
+    if ( row < 0 || row >= m_peers.size() )
+        return;
+    QVector<int> roles;
+    Peer &peer = m_peers[row];
+    if ( peer.talkTimeLeft != talkTimeLeft ) {
+        peer.talkTimeLeft = talkTimeLeft;
+        roles << TalkTimeLeftRole;
+    }
+    if ( peer.messagesLeft != messagesLeft ) {
+        peer.messagesLeft = messagesLeft;
+        roles << MessagesLeftRole;
+    }
+    if ( roles.isEmpty() )
+        return;
+    roles << KeyForecastRole;
+    notify(row, roles);
+}
+
+void PeerModel::notify(int row, const QVector<int> &roles)
+{
+    QModelIndex changed = index(row);
+    emit dataChanged(changed, changed, roles);
+}
@@ -0,0 +1,96 @@
+/*  Small Pine phone QML interface for Out-Of-Band communication.
+
+    Copyright (C) 2023 Resilience Theatre
+
+    This program is free software; you can redistribute it and/or
+    modify it under the terms of the GNU General Public License
+    as published by the Free Software Foundation; either version 2
+    of the License, or (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; If not, see <http://www.gnu.org/licenses/>.
+
+*/
+#ifndef PEERMODEL_H
+#define PEERMODEL_H
+#include <QAbstractListModel>
+#include <QVector>
+
+/*
+    Peer roster for contact buttons and key status. One row per
+    node in settings, setters emit dataChanged() only for the row
+    and role which actually changed.
+*/
+class PeerModel : public QAbstractListModel
+{
+    Q_OBJECT
+    Q_PROPERTY(int count READ count NOTIFY countChanged)
+
+public:
+    enum PeerRoles {
+        NameRole = Qt::UserRole + 1,
+        NameColorRole,
+        LabelRole,
+        LabelColorRole,
+        ActiveRole,
+        KeyPercentageRole,
+        LatencyRole,
+        LatencyP95Role,
+        JitterRole,
+        LossRole,
+        LinkQualityRole,
+        TalkTimeLeftRole,
+        MessagesLeftRole,
+        KeyForecastRole
+    };
+
+    struct Peer
+    {
+        QString name;
+        QString nameColor;
+        bool label=false;
+        QString labelColor="green";
+        bool active=false;
+        QString keyPercentageIn;
+        QString keyPercentageOut;
+        int latency=0;          // ms, median when probed
+        int latencyP95=-1;      // ms, -1 unknown
+        int jitter=-1;          // ms, -1 unknown
+        int loss=-1;            // %, -1 unknown
+        int talkTimeLeft=-1;    // s until pad runs out in call, -1 unknown
+        int messagesLeft=-1;    // messages until pad runs out, -1 unknown
+    };
+
+    explicit PeerModel(QObject *parent = nullptr);
+    int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
+    QHash<int, QByteArray> roleNames() const override;
+
+    int count() const;
+    const Peer &peer(int row) const;
+    void setPeers(const QStringList &names);
+    void setNameColor(int row, const QString &color);
+    void setAllNameColors(const QString &color);
+    void setLabel(int row, bool visible, const QString &color);
+    void clearLabels();
+    void setActive(int row, bool active);
+    void setAllActive(bool active);
+    void setKeyPercentage(int row, const QString &in, const QString &out);
+    void setLinkStats(int row, int latency, int latencyP95, int jitter, int loss);
+    void setKeyForecast(int row, int talkTimeLeft, int messagesLeft);
+
+signals:
+    void countChanged();
+
+private:
+    void notify(int row, const QVector<int> &roles);
+
+    QVector<Peer> m_peers;
+};
+
+#endif // PEERMODEL_H
@@ -0,0 +1,171 @@
+/*
+    small Pinephone QML interface for Out-Of-Band communication.
+
+    Copyright (C) 2023 Resilience Theatre
+
+    This program is free software; you can redistribute it and/or
+    modify it under the terms of the GNU General Public License
+    as published by the Free Software Foundation; either version 2
+    of the License, or (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "processexecutor.h"
+#include "trace.h"
+#include <QDebug>
+
+ProcessExecutor::ProcessExecutor(int maxRunning, QObject *parent)
+    : QObject{parent}, m_maxRunning(qMax(1, maxRunning))
+{
+    qRegisterMetaType<ProcessResult>();
+}
+
+/*
+    Running helpers are killed, queued ones never start. Killed
+    QProcess is detached and deletes itself once reaped, its own
+    destructor would block in waitForFinished() on GUI thread.
+*/
+ProcessExecutor::~ProcessExecutor()
+{
+    for (Job &job : m_running) {
+        job.process->disconnect(this);
+        job.process->setParent(nullptr);
+        connect(job.process, QOverload<int, QProcess::ExitStatus>::of(&QProcess::finished),
+                job.process, &QObject::deleteLater);
+        job.process->kill();
+    }
+}
+
+int ProcessExecutor::run(const QString &program, const QStringList &arguments,
+                         ProcessCallback callback, int timeoutMs)
+{
+    Job job;
+    job.id = m_nextId++;
+    job.program = program;
+    job.arguments = arguments;
+    job.callback = callback;
+    job.timeoutMs = timeoutMs;
+    m_queue.enqueue(job);
+    startNext();
+    return job.id;
+}
+
+/* Queued job is dropped, running one is killed. Callback gets cancelled result. */
+void ProcessExecutor::cancel(int id)
+{
+    for (int i=0; i < m_queue.size(); i++) {
+        if ( m_queue.at(i).id == id ) {
+            Job job = m_queue.takeAt(i);
+            ProcessResult result;
+            result.id = id;
+            result.cancelled = true;
+            deliver(result, job.callback);
+            return;
+        }
+    }
+    auto it = m_running.find(id);
+    if ( it != m_running.end() ) {
+        it->cancelled = true;
+        it->process->kill();
+    }
+}
+
+bool ProcessExecutor::isPending(int id) const
+{
+    if ( m_running.contains(id) )
+        return true;
+    for (const Job &job : m_queue) {
+        if ( job.id == id )
+            return true;
+    }
+    return false;
+}
+
+int ProcessExecutor::runningCount() const
+{
+    return m_running.size();
+}
+
+int ProcessExecutor::queuedCount() const
+{
+    return m_queue.size();
+}
+
+void ProcessExecutor::startNext()
+{
+    while ( m_running.size() < m_maxRunning && !m_queue.isEmpty() ) {
+        Job job = m_queue.dequeue();
+        int id = job.id;
+        job.process = new QProcess(this);
+        job.process->setProgram(job.program);
+        job.process->setArguments(job.arguments);
+        connect(job.process, QOverload<int, QProcess::ExitStatus>::of(&QProcess::finished),
+                this, [this, id] { processFinished(id); });
+        connect(job.process, &QProcess::errorOccurred, this, [this, id](QProcess::ProcessError error) {
+            if ( error == QProcess::FailedToStart )
+                processFinished(id);
+        });
+        if ( job.timeoutMs > 0 ) {
+            job.timer = new QTimer(this);
+            job.timer->setSingleShot(true);
+            connect(job.timer, &QTimer::timeout, this, [this, id] {
+                auto it = m_running.find(id);
+                if ( it == m_running.end() )
+                    return;
+                qWarning() << "Process timeout, killing" << it->program;
+                it->timedOut = true;
+                it->process->kill();
+            });
+            job.timer->start(job.timeoutMs);
+        }
+        TRACE_SCOPE("process::start");
+        job.traceStart = TRACE_NOW();
+        m_running.insert(id, job);
+        job.process->start();
+    }
+}
+
+void ProcessExecutor::processFinished(int id)
+{
+    auto it = m_running.find(id);
+    if ( it == m_running.end() )
+        return;
+    Job job = *it;
+    m_running.erase(it);
+    TRACE_COMPLETE(Trace::intern("process " + job.program), job.traceStart);
+
+    ProcessResult result;
+    result.id = id;
+    result.timedOut = job.timedOut;
+    result.cancelled = job.cancelled;
+    result.failed = job.process->error() == QProcess::FailedToStart
+                    || (!job.timedOut && !job.cancelled && job.process->exitStatus() == QProcess::CrashExit);
+    if ( result.failed )
+        qWarning() << "Process failed:" << job.program << job.process->errorString();
+    result.exitCode = job.process->exitCode();
+    result.output = job.process->readAllStandardOutput();
+    result.errorOutput = job.process->readAllStandardError();
+    job.process->disconnect(this);
+    job.process->deleteLater();
+    if ( job.timer )
+        job.timer->deleteLater();
+    deliver(result, job.callback);
+    startNext();
+}
+
+/* Always through event loop, so callers never re-enter from run() or cancel() */
+void ProcessExecutor::deliver(const ProcessResult &result, const ProcessCallback &callback)
+{
+    QMetaObject::invokeMethod(this, [this, result, callback] {
+        if ( callback )
+            callback(result);
+        emit finished(result);
+    }, Qt::QueuedConnection);
+}
@@ -0,0 +1,94 @@
+/*  Small Pine phone QML interface for Out-Of-Band communication.
+
+    Copyright (C) 2023 Resilience Theatre
+
+    This program is free software; you can redistribute it and/or
+    modify it under the terms of the GNU General Public License
+    as published by the Free Software Foundation; either version 2
+    of the License, or (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; If not, see <http://www.gnu.org/licenses/>.
+
+*/
+#ifndef PROCESSEXECUTOR_H
+#define PROCESSEXECUTOR_H
+#include <QObject>
+#include <QProcess>
+#include <QQueue>
+#include <QHash>
+#include <QTimer>
+#include <functional>
+
+#define PROCESS_POOL_SIZE       2
+#define PROCESS_TIMEOUT         30000   // ms
+
+struct ProcessResult
+{
+    int id=0;
+    int exitCode=-1;
+    bool failed=false;      // did not start or crashed
+    bool timedOut=false;
+    bool cancelled=false;
+    QByteArray output;
+    QByteArray errorOutput;
+    bool ok() const { return !failed && !timedOut && !cancelled && exitCode == 0; }
+};
+Q_DECLARE_METATYPE(ProcessResult)
+
+typedef std::function<void(const ProcessResult &)> ProcessCallback;
+
+/*
+    Runs helper scripts without blocking GUI thread. At most
+    maxRunning processes run at once, others wait in FIFO order.
+    Each job has a timeout after which process is killed. Callback
+    and finished() are delivered through event loop (queued), never
+    from inside run() or cancel().
+*/
+class ProcessExecutor : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit ProcessExecutor(int maxRunning = PROCESS_POOL_SIZE, QObject *parent = nullptr);
+    ~ProcessExecutor();
+    int run(const QString &program, const QStringList &arguments,
+            ProcessCallback callback = nullptr, int timeoutMs = PROCESS_TIMEOUT);
+    void cancel(int id);
+    bool isPending(int id) const;
+    int runningCount() const;
+    int queuedCount() const;
+
+signals:
+    void finished(const ProcessResult &result);
+
+private:
+    struct Job
+    {
+        int id=0;
+        QString program;
+        QStringList arguments;
+        ProcessCallback callback;
+        int timeoutMs=PROCESS_TIMEOUT;
+        QProcess *process=nullptr;
+        QTimer *timer=nullptr;
+        bool timedOut=false;
+        bool cancelled=false;
+        qint64 traceStart=0;
+    };
+    void startNext();
+    void processFinished(int id);
+    void deliver(const ProcessResult &result, const ProcessCallback &callback);
+
+    int m_maxRunning;
+    int m_nextId=1;
+    QQueue<Job> m_queue;
+    QHash<int, Job> m_running;
+};
+
+#endif // PROCESSEXECUTOR_H
@@ -0,0 +1,74 @@
+/*  Small Pine phone QML interface for Out-Of-Band communication.
+
+    Copyright (C) 2023 Resilience Theatre
+
+    This program is free software; you can redistribute it and/or
+    modify it under the terms of the GNU General Public License
+    as published by the Free Software Foundation; either version 2
+    of the License, or (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; If not, see <http://www.gnu.org/licenses/>.
+
+*/
+#ifndef PROPERTYCELL_H
+#define PROPERTYCELL_H
+#include <QtGlobal>
+
+/* Process wide NOTIFY counters of all property cells, logged on device lock */
+struct PropertyCellStats
+{
+    static inline quint64 emitted = 0;
+    static inline quint64 suppressed = 0;
+};
+
+/*
+    Value behind a Q_PROPERTY. set() compares against previous value
+    and calls the NOTIFY signal only when value really changed, so
+    periodic timers can store same reading again without waking QML
+    bindings.
+
+        m_voltage.set(text, this, &engineClass::voltageValueChanged);
+*/
+template <typename T>
+class PropertyCell
+{
+public:
+    PropertyCell() = default;
+    PropertyCell(const T &value) : m_value(value) {}
+
+    const T &value() const { return m_value; }
+    operator const T &() const { return m_value; }
+
+    /* Store value, true if it differs from previous one */
+    bool set(const T &value)
+    {
+        if ( m_value == value ) {
+            PropertyCellStats::suppressed++;
+            return false;
+        }
+        m_value = value;
+        PropertyCellStats::emitted++;
+        return true;
+    }
+
+    /* Store value and emit NOTIFY signal of object on change */
+    template <typename Object, typename Signal>
+    bool set(const T &value, Object *object, Signal signal)
+    {
+        if ( !set(value) )
+            return false;
+        emit (object->*signal)();
+        return true;
+    }
+
+private:
+    T m_value{};
+};
+
+#endif // PROPERTYCELL_H
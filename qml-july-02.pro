@@ -1,12 +1,12 @@
 QT += virtualkeyboard quickcontrols2
-QT += qml
 
 # You can make your code fail to compile if it uses deprecated APIs.
 # In order to do so, uncomment the following line.
 #DEFINES += QT_DISABLE_DEPRECATED_BEFORE=0x060000    # disables all the APIs deprecated before Qt 6.0.0
 
-SOURCES += engineclass.cpp \
-            main.cpp
+include(engine.pri)
+
+SOURCES += main.cpp
 
 RESOURCES += qml.qrc
 
@@ -19,14 +19,29 @@ RESOURCES += qml.qrc
 VERSION = v0.71
 DEFINES += APP_VERSION=\\\"$$VERSION\\\"
 
-CONFIG += qml_debug
+# Release: QML compiled ahead of time into binary, no QML debug service
+CONFIG(release, debug|release) {
+    CONFIG += qtquickcompiler
+} else {
+    CONFIG += qml_debug
+}
+
+# make check: build and run tests/ on host. Cross builds (aarch64)
+# cannot execute test binaries, there is no check target then.
+# make bench_startup: headless cold start, main() to first frame and to startup done,
+# in temporary root with fake daemon (tests/bench), fails when over [startup] limits
+# of tests/bench/baseline.ini
+!cross_compile {
+    check.commands = $(MKDIR) tests && cd tests && $(QMAKE) $$PWD/tests/tests.pro && $(MAKE) check
+    bench_startup.commands = $(MKDIR) tests && cd tests && $(QMAKE) $$PWD/tests/tests.pro && $(MAKE) sub-bench \
+        && bench/bench --startup $$OUT_PWD/$${TARGET} $$PWD/tests/bench/baseline.ini
+    bench_startup.depends = $${TARGET}
+    QMAKE_EXTRA_TARGETS += check bench_startup
+}
 
 # Default rules for deployment.
 qnx: target.path = /tmp/$${TARGET}/bin
 else: unix:!android: target.path = /opt/$${TARGET}/bin
 !isEmpty(target.path): INSTALLS += target
 
-HEADERS += \
-    engineclass.h
-
 DISTFILES +=
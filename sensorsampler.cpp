@@ -0,0 +1,280 @@
+/*
+    small Pinephone QML interface for Out-Of-Band communication.
+
+    Copyright (C) 2023 Resilience Theatre
+
+    This program is free software; you can redistribute it and/or
+    modify it under the terms of the GNU General Public License
+    as published by the Free Software Foundation; either version 2
+    of the License, or (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "sensorsampler.h"
+#include <QDebug>
+#include <fcntl.h>
+#include <unistd.h>
+#include <errno.h>
+#include <sys/stat.h>
+
+#define BATTERY_CAPACITY_PATH   "/sys/class/power_supply/axp20x-battery/capacity"
+#define BATTERY_STATUS_PATH     "/sys/class/power_supply/axp20x-battery/status"
+#define PROXIMITY_SENSOR_PATH   "/sys/devices/platform/soc/1c2b000.i2c/i2c-1/1-0048/iio:device1/in_proximity_raw"
+#define PROXIMITY_SENSOR_PATH_2 "/sys/devices/platform/soc/1c2b000.i2c/i2c-1/1-0048/iio:device2/in_proximity_raw"
+
+SensorFile::~SensorFile()
+{
+    close();
+}
+
+bool SensorFile::open(const QByteArray &path, bool followReplace)
+{
+    close();
+    m_path = path;
+    m_followReplace = followReplace;
+    m_fd = ::open(m_path.constData(), O_RDONLY | O_CLOEXEC);
+    if ( m_fd < 0 ) {
+        if ( !m_followReplace )
+            qDebug() << "Sensor not available: " << m_path;
+        return false;
+    }
+    struct stat st;
+    if ( fstat(m_fd, &st) == 0 ) {
+        m_device = st.st_dev;
+        m_inode = st.st_ino;
+    }
+    m_warned = false;
+    return true;
+}
+
+void SensorFile::close()
+{
+    if ( m_fd >= 0 )
+        ::close(m_fd);
+    m_fd = -1;
+}
+
+bool SensorFile::isOpen() const
+{
+    return m_fd >= 0;
+}
+
+QByteArray SensorFile::path() const
+{
+    return m_path;
+}
+
+/* Producer scripts may recreate the file, follow path to its current inode */
+bool SensorFile::reopenIfReplaced()
+{
+    struct stat st;
+    if ( stat(m_path.constData(), &st) < 0 ) {
+        if ( !m_warned )
+            qDebug() << "Error, no file: " << m_path;
+        m_warned = true;
+        close();
+        return false;
+    }
+    if ( m_fd >= 0 && st.st_dev == m_device && st.st_ino == m_inode )
+        return true;
+    return open(m_path, true);
+}
+
+/* Whole file from offset 0, NUL terminated. Returns length or -1 */
+int SensorFile::read(char *buffer, int size)
+{
+    if ( m_path.isEmpty() || size < 1 )
+        return -1;
+    if ( m_followReplace && !reopenIfReplaced() )
+        return -1;
+    if ( m_fd < 0 )
+        return -1;
+    ssize_t length = pread(m_fd, buffer, size - 1, 0);
+    if ( length < 0 ) {
+        if ( !m_warned )
+            qErrnoWarning(errno, "Cannot read %s", m_path.constData());
+        m_warned = true;
+        return -1;
+    }
+    buffer[length] = 0;
+    /* FNV-1a of content, tells callers if anything changed since last read */
+    quint64 hash = 14695981039346656037ull;
+    for (ssize_t x=0; x < length; x++) {
+        hash ^= static_cast<unsigned char>(buffer[x]);
+        hash *= 1099511628211ull;
+    }
+    m_changed = hash != m_contentHash;
+    m_contentHash = hash;
+    return int(length);
+}
+
+bool SensorFile::readInt(long &value)
+{
+    char buffer[32];
+    int length = read(buffer, sizeof(buffer));
+    if ( length <= 0 )
+        return false;
+    return SensorSampler::parseLong(SensorSampler::lastLine(buffer, length), value);
+}
+
+bool SensorFile::changed() const
+{
+    return m_changed;
+}
+
+SensorSampler::SensorSampler()
+{
+    m_batteryCapacity.open(BATTERY_CAPACITY_PATH);
+    m_batteryStatus.open(BATTERY_STATUS_PATH);
+    /* Proximity sensor moves between iio devices, pick the one present */
+    if ( !m_proximity.open(PROXIMITY_SENSOR_PATH) )
+        m_proximity.open(PROXIMITY_SENSOR_PATH_2);
+    m_env.open(ENV_STATUS_PATH, true);
+    m_network.open(NETWORK_STATUS_PATH, true);
+}
+
+bool SensorSampler::batteryCapacity(int &percent)
+{
+    long value;
+    if ( !m_batteryCapacity.readInt(value) )
+        return false;
+    percent = int(value);
+    return true;
+}
+
+BatteryState SensorSampler::batteryState()
+{
+    char buffer[32];
+    int length = m_batteryStatus.read(buffer, sizeof(buffer));
+    if ( length <= 0 )
+        return BATTERY_UNKNOWN;
+    std::string_view status = lastLine(buffer, length);
+    if ( status == "Charging" )
+        return BATTERY_CHARGING;
+    if ( status == "Discharging" )
+        return BATTERY_DISCHARGING;
+    return BATTERY_UNKNOWN;
+}
+
+bool SensorSampler::proximity(int &value)
+{
+    long raw;
+    if ( !m_proximity.readInt(raw) )
+        return false;
+    value = int(raw);
+    return true;
+}
+
+/* Comma separated: volts,plmn,tac,global cell,serving cell,rf channel,rssi,rsrq,rsrp,snr */
+bool SensorSampler::envSample(char *buffer, int size, EnvSample &sample)
+{
+    int length = m_env.read(buffer, size);
+    if ( length < 0 )
+        return false;
+    std::string_view line = lastLine(buffer, length);
+    sample.fieldCount = 0;
+    while ( sample.fieldCount < ENV_FIELD_COUNT ) {
+        std::size_t separator = line.find(',');
+        sample.field[sample.fieldCount++] = line.substr(0, separator);
+        if ( separator == std::string_view::npos )
+            break;
+        line.remove_prefix(separator + 1);
+    }
+    for (int x=sample.fieldCount; x < ENV_FIELD_COUNT; x++)
+        sample.field[x] = std::string_view();
+    return true;
+}
+
+bool SensorSampler::envChanged() const
+{
+    return m_env.changed();
+}
+
+/* dpinger output: <average latency us> <standard deviation us> <loss %> */
+bool SensorSampler::networkStatus(PingerSample &sample)
+{
+    char buffer[SENSOR_LINE_MAX];
+    int length = m_network.read(buffer, sizeof(buffer));
+    if ( length < 0 )
+        return false;
+    parsePinger(lastLine(buffer, length), sample);
+    return true;
+}
+
+/* One /tmp/peerN file per roster row */
+void SensorSampler::setPeerCount(int count)
+{
+    m_peers.resize(std::size_t(count));
+    for (int x=0; x < count; x++) {
+        if ( m_peers[x] )
+            continue;
+        m_peers[x].reset(new SensorFile);
+        m_peers[x]->open(PEER_STATUS_PATH + QByteArray::number(x), true);
+    }
+}
+
+/* dpinger output per peer, same format as network file */
+bool SensorSampler::peerStatus(int index, PingerSample &sample)
+{
+    if ( index < 0 || index >= int(m_peers.size()) )
+        return false;
+    char buffer[SENSOR_LINE_MAX];
+    int length = m_peers[index]->read(buffer, sizeof(buffer));
+    if ( length < 0 )
+        return false;
+    parsePinger(lastLine(buffer, length), sample);
+    return true;
+}
+
+/* Last non-empty line without line terminator */
+std::string_view SensorSampler::lastLine(const char *buffer, int length)
+{
+    std::string_view text(buffer, std::size_t(length));
+    while ( !text.empty() && (text.back() == '\n' || text.back() == '\r') )
+        text.remove_suffix(1);
+    std::size_t lineStart = text.rfind('\n');
+    if ( lineStart != std::string_view::npos )
+        text.remove_prefix(lineStart + 1);
+    return text;
+}
+
+bool SensorSampler::parseLong(std::string_view text, long &value)
+{
+    while ( !text.empty() && text.front() == ' ' )
+        text.remove_prefix(1);
+    bool negative = false;
+    if ( !text.empty() && (text.front() == '-' || text.front() == '+') ) {
+        negative = text.front() == '-';
+        text.remove_prefix(1);
+    }
+    if ( text.empty() || text.front() < '0' || text.front() > '9' )
+        return false;
+    long result = 0;
+    while ( !text.empty() && text.front() >= '0' && text.front() <= '9' ) {
+        result = result * 10 + (text.front() - '0');
+        text.remove_prefix(1);
+    }
+    value = negative ? -result : result;
+    return true;
+}
+
+/* Space separated dpinger columns, missing or broken ones read as 0 */
+void SensorSampler::parsePinger(std::string_view line, PingerSample &sample)
+{
+    long *field[] = { &sample.latencyUs, &sample.deviationUs, &sample.lossPercent };
+    for (long *value : field) {
+        while ( !line.empty() && line.front() == ' ' )
+            line.remove_prefix(1);
+        std::size_t end = line.find(' ');
+        if ( !parseLong(line.substr(0, end), *value) )
+            *value = 0;
+        line.remove_prefix(end == std::string_view::npos ? line.size() : end);
+    }
+}
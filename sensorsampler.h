@@ -0,0 +1,120 @@
+/*  Small Pine phone QML interface for Out-Of-Band communication.
+
+    Copyright (C) 2023 Resilience Theatre
+
+    This program is free software; you can redistribute it and/or
+    modify it under the terms of the GNU General Public License
+    as published by the Free Software Foundation; either version 2
+    of the License, or (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; If not, see <http://www.gnu.org/licenses/>.
+
+*/
+#ifndef SENSORSAMPLER_H
+#define SENSORSAMPLER_H
+#include <QByteArray>
+#include <memory>
+#include <vector>
+#include <string_view>
+#include <sys/types.h>
+
+#define SENSOR_LINE_MAX         512
+#define ENV_STATUS_PATH         "/tmp/env"
+#define NETWORK_STATUS_PATH     "/tmp/network"
+#define PEER_STATUS_PATH        "/tmp/peer"     // + node index
+#define ENV_FIELD_COUNT         10
+
+/*
+    One sensor or status file kept open for the lifetime of sampler.
+    Reads are pread() at offset 0 into caller's buffer. Files under
+    /tmp are rewritten by scripts, those are opened with followReplace
+    and reopened when path points to a new inode.
+*/
+class SensorFile
+{
+public:
+    SensorFile() = default;
+    ~SensorFile();
+    SensorFile(const SensorFile &) = delete;
+    SensorFile &operator=(const SensorFile &) = delete;
+
+    bool open(const QByteArray &path, bool followReplace = false);
+    void close();
+    bool isOpen() const;
+    QByteArray path() const;
+    int read(char *buffer, int size);
+    bool readInt(long &value);
+    bool changed() const;
+
+private:
+    bool reopenIfReplaced();
+
+    QByteArray m_path;
+    int m_fd=-1;
+    bool m_followReplace=false;
+    bool m_warned=false;
+    dev_t m_device=0;
+    ino_t m_inode=0;
+    quint64 m_contentHash=0;
+    bool m_changed=false;
+};
+
+enum BatteryState {
+    BATTERY_UNKNOWN,
+    BATTERY_CHARGING,
+    BATTERY_DISCHARGING
+};
+
+/* Fields of last /tmp/env line, views into caller's buffer */
+struct EnvSample
+{
+    std::string_view field[ENV_FIELD_COUNT];
+    int fieldCount=0;
+};
+
+/* dpinger line: <average latency us> <standard deviation us> <loss %> */
+struct PingerSample
+{
+    long latencyUs=0;
+    long deviationUs=0;
+    long lossPercent=0;
+};
+
+/*
+    Battery, proximity and status file readings.
+    Paths are resolved once, a sample costs one pread() per file (and
+    one stat() for /tmp files) and no heap allocations.
+*/
+class SensorSampler
+{
+public:
+    SensorSampler();
+    bool batteryCapacity(int &percent);
+    BatteryState batteryState();
+    bool proximity(int &value);
+    bool envSample(char *buffer, int size, EnvSample &sample);
+    bool envChanged() const;
+    bool networkStatus(PingerSample &sample);
+    void setPeerCount(int count);
+    bool peerStatus(int index, PingerSample &sample);
+
+    static std::string_view lastLine(const char *buffer, int length);
+    static bool parseLong(std::string_view text, long &value);
+    static void parsePinger(std::string_view line, PingerSample &sample);
+
+private:
+    SensorFile m_batteryCapacity;
+    SensorFile m_batteryStatus;
+    SensorFile m_proximity;
+    SensorFile m_env;
+    SensorFile m_network;
+    std::vector<std::unique_ptr<SensorFile>> m_peers;
+};
+
+#endif // SENSORSAMPLER_H
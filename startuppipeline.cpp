@@ -0,0 +1,163 @@
+/*
+    small Pinephone QML interface for Out-Of-Band communication.
+
+    Copyright (C) 2023 Resilience Theatre
+
+    This program is free software; you can redistribute it and/or
+    modify it under the terms of the GNU General Public License
+    as published by the Free Software Foundation; either version 2
+    of the License, or (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "startuppipeline.h"
+#include <QDebug>
+
+StartupPipeline::StartupPipeline(QObject *parent)
+    : QObject{parent}
+{
+    m_pool.setMaxThreadCount(STARTUP_POOL_SIZE);
+    m_clock.start();
+}
+
+/* Workers post results to this object, they must be gone first */
+StartupPipeline::~StartupPipeline()
+{
+    m_pool.waitForDone();
+}
+
+/* Steps may only depend on steps added before them */
+int StartupPipeline::addStep(const QString &name, Apply run, const QVector<int> &after)
+{
+    Step step;
+    step.timing.name = name;
+    step.run = run;
+    step.after = after;
+    m_steps.append(step);
+    m_timeline.append(step.timing);
+    return m_steps.size() - 1;
+}
+
+int StartupPipeline::addPoolStep(const QString &name, std::function<Apply()> work, const QVector<int> &after)
+{
+    Step step;
+    step.timing.name = name;
+    step.timing.pooled = true;
+    step.work = work;
+    step.after = after;
+    m_steps.append(step);
+    m_timeline.append(step.timing);
+    return m_steps.size() - 1;
+}
+
+void StartupPipeline::start()
+{
+    if ( m_started )
+        return;
+    m_started = true;
+    m_pending = m_steps.size();
+    if ( m_pending == 0 ) {
+        emit finished();
+        return;
+    }
+    dispatch();
+}
+
+bool StartupPipeline::isFinished() const
+{
+    return m_started && m_pending == 0;
+}
+
+qint64 StartupPipeline::elapsed() const
+{
+    return m_clock.elapsed();
+}
+
+const QVector<StartupPipeline::StepTiming> &StartupPipeline::timeline() const
+{
+    return m_timeline;
+}
+
+/* One line per step: name, wait for dependencies and run time */
+QString StartupPipeline::timelineText() const
+{
+    QString text;
+    for (const StepTiming &timing : m_timeline) {
+        text += timing.name + (timing.pooled ? " [pool]" : "");
+        if ( timing.endMs < 0 ) {
+            text += " pending\n";
+            continue;
+        }
+        text += " ready " + QString::number(timing.readyMs) + "ms"
+                + " start " + QString::number(timing.startMs) + "ms"
+                + " done " + QString::number(timing.endMs) + "ms\n";
+    }
+    return text;
+}
+
+/* Start every step whose dependencies are done */
+void StartupPipeline::dispatch()
+{
+    for (int id=0; id < m_steps.size(); id++) {
+        Step &step = m_steps[id];
+        if ( step.done || m_timeline.at(id).readyMs >= 0 )
+            continue;
+        bool ready = true;
+        for (int dependency : step.after)
+            ready &= m_steps.at(dependency).done;
+        if ( !ready )
+            continue;
+        m_timeline[id].readyMs = m_clock.elapsed();
+        if ( step.work ) {
+            /*
+                Worker only runs the read, result is applied on main
+                thread. Start is taken on worker, pool queue wait
+                shows as gap between ready and start.
+            */
+            std::function<Apply()> work = step.work;
+            QElapsedTimer clock = m_clock;
+            m_pool.start([this, id, work, clock] {
+                qint64 startMs = clock.elapsed();
+                Apply apply = work();
+                QMetaObject::invokeMethod(this, [this, id, apply, startMs] {
+                    m_timeline[id].startMs = startMs;
+                    if ( apply )
+                        apply();
+                    finishStep(id);
+                }, Qt::QueuedConnection);
+            });
+        } else {
+            QMetaObject::invokeMethod(this, [this, id] { runStep(id); }, Qt::QueuedConnection);
+        }
+    }
+}
+
+void StartupPipeline::runStep(int id)
+{
+    m_timeline[id].startMs = m_clock.elapsed();
+    Apply run = m_steps.at(id).run;
+    if ( run )
+        run();
+    finishStep(id);
+}
+
+void StartupPipeline::finishStep(int id)
+{
+    m_steps[id].done = true;
+    m_timeline[id].endMs = m_clock.elapsed();
+    m_pending--;
+    emit stepFinished(id);
+    if ( m_pending == 0 ) {
+        qDebug().noquote() << "Startup finished in" << m_clock.elapsed() << "ms\n" + timelineText();
+        emit finished();
+        return;
+    }
+    dispatch();
+}
@@ -0,0 +1,88 @@
+/*  Small Pine phone QML interface for Out-Of-Band communication.
+
+    Copyright (C) 2023 Resilience Theatre
+
+    This program is free software; you can redistribute it and/or
+    modify it under the terms of the GNU General Public License
+    as published by the Free Software Foundation; either version 2
+    of the License, or (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; If not, see <http://www.gnu.org/licenses/>.
+
+*/
+#ifndef STARTUPPIPELINE_H
+#define STARTUPPIPELINE_H
+#include <QObject>
+#include <QElapsedTimer>
+#include <QThreadPool>
+#include <QVector>
+#include <functional>
+
+#define STARTUP_POOL_SIZE       2       // worker threads for file reading steps
+
+/*
+    Startup steps with explicit dependencies. A step starts as soon
+    as every step it depends on has finished. Main thread steps run
+    from the event loop one at a time so QML can paint in between.
+    Pool steps do blocking reads on a worker and return a function
+    which is applied on main thread, only then the step counts as
+    finished. Timeline is kept for inspection at runtime.
+*/
+class StartupPipeline : public QObject
+{
+    Q_OBJECT
+
+public:
+    typedef std::function<void()> Apply;
+
+    struct StepTiming
+    {
+        QString name;
+        bool pooled=false;
+        qint64 readyMs=-1;      // ms since pipeline creation
+        qint64 startMs=-1;
+        qint64 endMs=-1;
+    };
+
+    explicit StartupPipeline(QObject *parent = nullptr);
+    ~StartupPipeline();
+    int addStep(const QString &name, Apply run, const QVector<int> &after = {});
+    int addPoolStep(const QString &name, std::function<Apply()> work, const QVector<int> &after = {});
+    void start();
+    bool isFinished() const;
+    qint64 elapsed() const;
+    const QVector<StepTiming> &timeline() const;
+    QString timelineText() const;
+
+signals:
+    void stepFinished(int id);
+    void finished();
+
+private:
+    struct Step
+    {
+        StepTiming timing;
+        Apply run;
+        std::function<Apply()> work;
+        QVector<int> after;
+        bool done=false;
+    };
+    void dispatch();
+    void runStep(int id);
+    void finishStep(int id);
+
+    QVector<Step> m_steps;
+    QVector<StepTiming> m_timeline;
+    QThreadPool m_pool;
+    QElapsedTimer m_clock;
+    int m_pending=0;
+    bool m_started=false;
+};
+
+#endif // STARTUPPIPELINE_H
@@ -0,0 +1,106 @@
+/*
+    small Pinephone QML interface for Out-Of-Band communication.
+
+    Copyright (C) 2023 Resilience Theatre
+
+    This program is free software; you can redistribute it and/or
+    modify it under the terms of the GNU General Public License
+    as published by the Free Software Foundation; either version 2
+    of the License, or (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "statuswatcher.h"
+#include <QDebug>
+#include <QVarLengthArray>
+#include <algorithm>
+#include <unistd.h>
+#include <errno.h>
+
+StatusWatcher::StatusWatcher(const QString &directory, QObject *parent, quint32 events)
+    : QObject{parent}
+{
+    m_fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if ( m_fd < 0 ) {
+        qErrnoWarning(errno, "inotify_init1 failed");
+        return;
+    }
+    QByteArray path = directory.toLocal8Bit();
+    if ( inotify_add_watch(m_fd, path.constData(), events) < 0 ) {
+        qErrnoWarning(errno, "Cannot watch %s", path.constData());
+        ::close(m_fd);
+        m_fd = -1;
+        return;
+    }
+    m_notifier = new QSocketNotifier(m_fd, QSocketNotifier::Read, this);
+    connect(m_notifier, SIGNAL(activated(int)), this, SLOT(readEvents()));
+}
+
+StatusWatcher::~StatusWatcher()
+{
+    if ( m_fd >= 0 )
+        ::close(m_fd);
+}
+
+/* False if inotify is not available, caller has to poll */
+bool StatusWatcher::isActive() const
+{
+    return m_fd >= 0;
+}
+
+/* Register file name in watched directory, returns id used in fileChanged() */
+int StatusWatcher::watch(const QByteArray &fileName)
+{
+    int id = m_fileNames.indexOf(fileName);
+    if ( id >= 0 )
+        return id;
+    m_fileNames.append(fileName);
+    return m_fileNames.size() - 1;
+}
+
+void StatusWatcher::readEvents()
+{
+    alignas(struct inotify_event) char buffer[STATUS_WATCHER_BUFFER];
+    QVarLengthArray<bool, 32> changed(m_fileNames.size());
+    std::fill(changed.begin(), changed.end(), false);
+    for (;;) {
+        ssize_t length = read(m_fd, buffer, sizeof(buffer));
+        if ( length < 0 ) {
+            if ( errno == EINTR )
+                continue;
+            if ( errno != EAGAIN )
+                qErrnoWarning(errno, "inotify read failed");
+            break;
+        }
+        if ( length == 0 )
+            break;
+        for (char *ptr = buffer; ptr < buffer + length; ) {
+            const struct inotify_event *event = reinterpret_cast<const struct inotify_event *>(ptr);
+            ptr += sizeof(struct inotify_event) + event->len;
+            if ( event->mask & IN_Q_OVERFLOW ) {
+                /* Events lost, treat every file as changed */
+                std::fill(changed.begin(), changed.end(), true);
+                continue;
+            }
+            if ( event->len == 0 )
+                continue;
+            for (int id=0; id < m_fileNames.size(); id++) {
+                if ( m_fileNames.at(id) == event->name ) {
+                    changed[id] = true;
+                    break;
+                }
+            }
+        }
+    }
+    for (int id=0; id < changed.size(); id++) {
+        if ( changed.at(id) )
+            emit fileChanged(id);
+    }
+}
@@ -0,0 +1,62 @@
+/*  Small Pine phone QML interface for Out-Of-Band communication.
+
+    Copyright (C) 2023 Resilience Theatre
+
+    This program is free software; you can redistribute it and/or
+    modify it under the terms of the GNU General Public License
+    as published by the Free Software Foundation; either version 2
+    of the License, or (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; If not, see <http://www.gnu.org/licenses/>.
+
+*/
+#ifndef STATUSWATCHER_H
+#define STATUSWATCHER_H
+#include <QObject>
+#include <QByteArray>
+#include <QVector>
+#include <QSocketNotifier>
+#include <sys/inotify.h>
+
+#define STATUS_FILE_DIR         "/tmp"
+#define STATUS_WATCHER_EVENTS   (IN_CLOSE_WRITE | IN_MOVED_TO)
+#define STATUS_WATCHER_BUFFER   4096
+
+/*
+    inotify watch on status file directory. Producer scripts either
+    rewrite a file in place (IN_CLOSE_WRITE) or rename a temporary
+    over it (IN_MOVED_TO), watching the directory catches both and
+    also files created after startup. Files updated in place without
+    close need IN_MODIFY in events. fileChanged() is emitted once per
+    registered file per batch of events.
+*/
+class StatusWatcher : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit StatusWatcher(const QString &directory, QObject *parent = nullptr,
+                           quint32 events = STATUS_WATCHER_EVENTS);
+    ~StatusWatcher();
+    bool isActive() const;
+    int watch(const QByteArray &fileName);
+
+signals:
+    void fileChanged(int id);
+
+private slots:
+    void readEvents();
+
+private:
+    int m_fd=-1;
+    QSocketNotifier *m_notifier=nullptr;
+    QVector<QByteArray> m_fileNames;    // index is watch id
+};
+
+#endif // STATUSWATCHER_H
@@ -0,0 +1,386 @@
+/*
+    small Pinephone QML interface for Out-Of-Band communication.
+
+    Copyright (C) 2023 Resilience Theatre
+
+    This program is free software; you can redistribute it and/or
+    modify it under the terms of the GNU General Public License
+    as published by the Free Software Foundation; either version 2
+    of the License, or (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/*
+    Headless engine benchmark against FakeDaemon. Measures telemetry
+    frame cost (FIFO read, parse, dispatch, handler), call setup
+    latency, received messages per second, heap allocations per
+    received message and per FifoReader line, compares them to limits in baseline.ini and
+    exits non-zero on regression:
+
+        bench [baseline.ini]
+
+    With --startup, application binary is started in the same isolated
+    root and fake daemon, QTUI_BENCH_STARTUP of its main() measures
+    cold start and bench exits with its status (make bench_startup):
+
+        bench --startup <application> [baseline.ini]
+*/
+#include "engineclass.h"
+#include "fakedaemon.h"
+#include "fiforeader.h"
+#include <QGuiApplication>
+#include <QTemporaryDir>
+#include <QSignalSpy>
+#include <QElapsedTimer>
+#include <QSettings>
+#include <QProcess>
+#include <QEventLoop>
+#include <QTimer>
+#include <QDebug>
+#include <atomic>
+#include <cstdlib>
+#include <errno.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#define BENCH_PEERS             8
+#define BENCH_TELEMETRY_FRAMES  100000
+#define BENCH_CALL_ROUNDS       20
+#define BENCH_MESSAGES          20000
+#define BENCH_READER_FRAMES     100000
+#define BENCH_TIMEOUT           10000   // ms, any single wait
+#define BENCH_STARTUP_WAIT      60000   // ms, application has its own startup timeout
+#define BENCH_BASELINE_FILE     "baseline.ini"
+
+/*
+    Every heap allocation of process, engine runs in same thread as
+    daemon. malloc() is interposed (glibc) so Qt containers, which do
+    not use operator new, are counted too.
+*/
+static std::atomic<quint64> g_allocations{0};
+
+extern "C" {
+void *__libc_malloc(size_t size);
+void *__libc_calloc(size_t count, size_t size);
+void *__libc_realloc(void *pointer, size_t size);
+void __libc_free(void *pointer);
+
+void *malloc(size_t size)
+{
+    g_allocations.fetch_add(1, std::memory_order_relaxed);
+    return __libc_malloc(size);
+}
+
+void *calloc(size_t count, size_t size)
+{
+    g_allocations.fetch_add(1, std::memory_order_relaxed);
+    return __libc_calloc(count, size);
+}
+
+void *realloc(void *pointer, size_t size)
+{
+    g_allocations.fetch_add(1, std::memory_order_relaxed);
+    return __libc_realloc(pointer, size);
+}
+
+void free(void *pointer)
+{
+    __libc_free(pointer);
+}
+}
+
+struct BenchResult
+{
+    double telemetryNsPerFrame=-1;
+    double callSetupMs=-1;
+    double messagesPerSecond=-1;
+    double allocationsPerMessage=-1;
+    double readerAllocationsPerFrame=-1;
+};
+
+/* Wait until daemon sees command, false on timeout */
+static bool waitCommand(FakeDaemon &daemon, const QByteArray &command)
+{
+    QElapsedTimer clock;
+    clock.start();
+    bool seen = false;
+    QMetaObject::Connection connection = QObject::connect(&daemon, &FakeDaemon::commandReceived,
+                                                          [&seen, command](const QByteArray &line) {
+        if ( line.endsWith(command) )
+            seen = true;
+    });
+    while ( !seen && clock.elapsed() < BENCH_TIMEOUT )
+        QCoreApplication::processEvents(QEventLoop::WaitForMoreEvents, 100);
+    QObject::disconnect(connection);
+    return seen;
+}
+
+/* Contact button to OTP connected, peer 0 is node 1 in engine */
+static bool connectPeer(engineClass &engine)
+{
+    QSignalSpy connected(&engine, &engineClass::goSecureButton_activeChanged);
+    engine.connectButton(1);
+    while ( !engine.getGoSecureButton_active() ) {
+        if ( !connected.wait(BENCH_TIMEOUT) )
+            return false;
+    }
+    return true;
+}
+
+static bool disconnectPeer(engineClass &engine, FakeDaemon &daemon)
+{
+    engine.disconnectButton();
+    return waitCommand(daemon, "disconnect_audio");
+}
+
+static double benchCallSetup(engineClass &engine, FakeDaemon &daemon)
+{
+    qint64 totalNsecs = 0;
+    for (int x=0; x < BENCH_CALL_ROUNDS; x++) {
+        QElapsedTimer clock;
+        clock.start();
+        if ( !connectPeer(engine) ) {
+            qWarning() << "bench: call setup timed out";
+            return -1;
+        }
+        totalNsecs += clock.nsecsElapsed();
+        if ( !disconnectPeer(engine, daemon) ) {
+            qWarning() << "bench: disconnect timed out";
+            return -1;
+        }
+    }
+    return double(totalNsecs) / BENCH_CALL_ROUNDS / 1e6;
+}
+
+/*
+    Messages are shown only in call, flood peer 0 and count rows
+    inserted. Daemon fills message FIFO first, time and allocations
+    are taken only while engine drains it.
+*/
+static bool benchMessages(engineClass &engine, FakeDaemon &daemon, BenchResult &result)
+{
+    if ( !connectPeer(engine) )
+        return false;
+    MessageModel *model = engine.getMessageModel();
+    int received = 0;
+    QMetaObject::Connection connection = QObject::connect(model, &QAbstractItemModel::rowsInserted,
+                                                          [&received](const QModelIndex &, int first, int last) {
+        received += last - first + 1;
+    });
+    QElapsedTimer timeout;
+    timeout.start();
+    qint64 nsecs = 0;
+    quint64 allocations = 0;
+    int sent = 0;
+    while ( received < BENCH_MESSAGES && timeout.elapsed() < BENCH_TIMEOUT ) {
+        sent += daemon.sendMessages(0, "bench message text", BENCH_MESSAGES - sent);
+        quint64 allocationsBefore = g_allocations.load();
+        QElapsedTimer clock;
+        clock.start();
+        while ( received < sent && timeout.elapsed() < BENCH_TIMEOUT )
+            QCoreApplication::processEvents(QEventLoop::AllEvents, 10);
+        nsecs += clock.nsecsElapsed();
+        allocations += g_allocations.load() - allocationsBefore;
+    }
+    QObject::disconnect(connection);
+    disconnectPeer(engine, daemon);
+    if ( received < BENCH_MESSAGES ) {
+        qWarning() << "bench: received" << received << "of" << BENCH_MESSAGES << "messages";
+        return false;
+    }
+    result.messagesPerSecond = BENCH_MESSAGES * 1e9 / double(nsecs);
+    result.allocationsPerMessage = double(allocations) / BENCH_MESSAGES;
+    return true;
+}
+
+/*
+    Status replies through engine telemetry FIFO reader, fifoChanged()
+    parse, dispatch table and handlers. Daemon fills FIFO, only engine
+    draining it is timed.
+*/
+static double benchTelemetry(FakeDaemon &daemon)
+{
+    static const char *lines[] = {
+        "10.0.1.1,offline",
+        "10.9.9.9,available",       // not a peer, lookup only
+        "10.0.1.2,prepare_ready",   // no handler
+        "telemetryclient_is_alive"
+    };
+    const int lineCount = int(sizeof(lines) / sizeof(lines[0]));
+    QElapsedTimer timeout;
+    timeout.start();
+    qint64 nsecs = 0;
+    int sent = 0;
+    while ( sent < BENCH_TELEMETRY_FRAMES && timeout.elapsed() < BENCH_TIMEOUT ) {
+        int batch = 0;
+        while ( sent + batch < BENCH_TELEMETRY_FRAMES
+                && daemon.sendLine(FIFO_CHANNEL_TELEMETRY, lines[(sent + batch) % lineCount]) )
+            batch++;
+        QElapsedTimer clock;
+        clock.start();
+        while ( daemon.pendingBytes() > 0 && timeout.elapsed() < BENCH_TIMEOUT )
+            QCoreApplication::processEvents(QEventLoop::AllEvents, 10);
+        nsecs += clock.nsecsElapsed();
+        sent += batch;
+    }
+    if ( sent < BENCH_TELEMETRY_FRAMES || daemon.pendingBytes() > 0 ) {
+        qWarning() << "bench: engine read" << sent << "of" << BENCH_TELEMETRY_FRAMES << "telemetry frames";
+        return -1;
+    }
+    return double(nsecs) / BENCH_TELEMETRY_FRAMES;
+}
+
+/*
+    FifoReader alone on a FIFO of its own, receiver does nothing. Line
+    splitting and delivery must not allocate per line, only buffer
+    growth and read notifications are left.
+*/
+static double benchReader(const QString &root)
+{
+    QByteArray path = QFile::encodeName(root + "/bench_reader_fifo");
+    if ( mkfifo(path.constData(), 0600) != 0 ) {
+        qErrnoWarning(errno, "bench: cannot create %s", path.constData());
+        return -1;
+    }
+    FifoReader reader(QFile::decodeName(path));
+    int fd = open(path.constData(), O_WRONLY | O_NONBLOCK | O_CLOEXEC);
+    if ( fd < 0 ) {
+        qErrnoWarning(errno, "bench: cannot open %s", path.constData());
+        return -1;
+    }
+    int received = 0;
+    QObject::connect(&reader, &FifoReader::lineReceived, [&received](const QByteArray &) {
+        received++;
+    });
+    static const char line[] = "10.0.1.1,reader bench line\n";
+    const ssize_t lineSize = ssize_t(sizeof(line) - 1);
+    QElapsedTimer timeout;
+    timeout.start();
+    quint64 allocations = 0;
+    int sent = 0;
+    while ( received < BENCH_READER_FRAMES && timeout.elapsed() < BENCH_TIMEOUT ) {
+        while ( sent < BENCH_READER_FRAMES && write(fd, line, lineSize) == lineSize )
+            sent++;
+        quint64 allocationsBefore = g_allocations.load();
+        while ( received < sent && timeout.elapsed() < BENCH_TIMEOUT )
+            QCoreApplication::processEvents(QEventLoop::AllEvents, 10);
+        allocations += g_allocations.load() - allocationsBefore;
+    }
+    close(fd);
+    if ( received < BENCH_READER_FRAMES ) {
+        qWarning() << "bench: reader received" << received << "of" << BENCH_READER_FRAMES << "lines";
+        return -1;
+    }
+    return double(allocations) / BENCH_READER_FRAMES;
+}
+
+/* One line per metric, false if any is over its limit */
+static bool checkBaseline(const BenchResult &result, const QString &baselineFile)
+{
+    QSettings baseline(baselineFile, QSettings::IniFormat);
+    struct Metric { const char *name; double value; const char *limitKey; bool upperLimit; };
+    const Metric metrics[] = {
+        { "telemetry_ns_per_frame",       result.telemetryNsPerFrame,           "limits/telemetry_ns_per_frame_max",          true },
+        { "call_setup_ms",                result.callSetupMs,                   "limits/call_setup_ms_max",                   true },
+        { "messages_per_second",          result.messagesPerSecond,             "limits/messages_per_second_min",             false },
+        { "allocations_per_message",      result.allocationsPerMessage,         "limits/allocations_per_message_max",         true },
+        { "reader_allocations_per_frame", result.readerAllocationsPerFrame,     "limits/reader_allocations_per_frame_max",    true }
+    };
+    bool pass = true;
+    for (const Metric &metric : metrics) {
+        bool ok = metric.value >= 0;
+        QVariant limit = baseline.value(metric.limitKey);
+        if ( ok && limit.isValid() )
+            ok = metric.upperLimit ? metric.value <= limit.toDouble() : metric.value >= limit.toDouble();
+        qInfo().noquote() << QString("%1 %2 limit %3 %4").arg(metric.name, -30)
+                             .arg(metric.value, 0, 'f', 2)
+                             .arg(limit.isValid() ? limit.toString() : "-")
+                             .arg(ok ? "ok" : "REGRESSION");
+        pass &= ok;
+    }
+    return pass;
+}
+
+/* Application in isolated root, daemon answers its startup commands from this event loop */
+static int benchStartup(const QString &application, const QString &baselineFile)
+{
+    QTemporaryDir root;
+    if ( !root.isValid() )
+        return 2;
+    FakeDaemon::isolateEngine(root.path());
+    FakeDaemon daemon(root.path(), BENCH_PEERS);
+    if ( !daemon.isReady() )
+        return 2;
+
+    QProcessEnvironment environment = QProcessEnvironment::systemEnvironment();
+    environment.insert(BENCH_STARTUP_ENV, baselineFile);
+    environment.insert("QT_QPA_PLATFORM", "offscreen");
+    environment.insert("QT_QUICK_BACKEND", "software");
+    QProcess process;
+    process.setProcessEnvironment(environment);
+    process.setProcessChannelMode(QProcess::ForwardedChannels);
+    process.start(application, QStringList());
+    if ( !process.waitForStarted() ) {
+        qWarning() << "bench: cannot start" << application << process.errorString();
+        return 2;
+    }
+    QEventLoop loop;
+    QObject::connect(&process, QOverload<int, QProcess::ExitStatus>::of(&QProcess::finished), &loop, &QEventLoop::quit);
+    QTimer::singleShot(BENCH_STARTUP_WAIT, &loop, &QEventLoop::quit);
+    loop.exec();
+    if ( process.state() != QProcess::NotRunning ) {
+        qWarning() << "bench: startup of" << application << "did not finish";
+        process.kill();
+        process.waitForFinished();
+        return 1;
+    }
+    return process.exitStatus() == QProcess::NormalExit ? process.exitCode() : 1;
+}
+
+int main(int argc, char *argv[])
+{
+    if ( qEnvironmentVariableIsEmpty("QT_QPA_PLATFORM") )
+        qputenv("QT_QPA_PLATFORM", "offscreen");
+    QGuiApplication app(argc, argv);
+    QStringList arguments = app.arguments();
+    if ( arguments.value(1) == "--startup" ) {
+        if ( arguments.size() < 3 ) {
+            qWarning() << "usage: bench --startup <application> [baseline.ini]";
+            return 2;
+        }
+        return benchStartup(arguments.at(2), arguments.value(3, BENCH_BASELINE_FILE));
+    }
+    QString baselineFile = arguments.value(1, BENCH_BASELINE_FILE);
+
+    QTemporaryDir root;
+    if ( !root.isValid() )
+        return 2;
+    FakeDaemon::isolateEngine(root.path());
+    FakeDaemon daemon(root.path(), BENCH_PEERS);
+    if ( !daemon.isReady() )
+        return 2;
+
+    BenchResult result;
+    result.readerAllocationsPerFrame = benchReader(root.path());
+
+    engineClass engine;
+    engine.setVaultMode(false);
+    QSignalSpy started(&engine, &engineClass::startupFinished);
+    if ( !started.wait(BENCH_TIMEOUT) ) {
+        qWarning() << "bench: engine startup timed out";
+        return 1;
+    }
+    result.callSetupMs = benchCallSetup(engine, daemon);
+    benchMessages(engine, daemon, result);
+    /* Last, offline replies leave peer labels red */
+    result.telemetryNsPerFrame = benchTelemetry(daemon);
+    return checkBaseline(result, baselineFile) ? 0 : 1;
+}
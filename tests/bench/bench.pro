@@ -0,0 +1,27 @@
+# Headless engine benchmark with simulated telemetry daemon.
+# make check runs the bench, regression against baseline.ini fails it.
+
+TEMPLATE = app
+TARGET = bench
+QT += testlib
+CONFIG += console
+CONFIG -= app_bundle
+
+DEFINES += APP_VERSION=\\\"bench\\\"
+
+include(../../engine.pri)
+
+SOURCES += \
+    bench.cpp \
+    fakedaemon.cpp
+
+HEADERS += \
+    fakedaemon.h
+
+DISTFILES += \
+    baseline.ini
+
+# make check: run against baseline, non-zero exit on regression
+check.commands = QT_QPA_PLATFORM=offscreen ./$${TARGET} $$PWD/baseline.ini
+check.depends = $${TARGET}
+QMAKE_EXTRA_TARGETS += check
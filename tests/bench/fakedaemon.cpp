@@ -0,0 +1,241 @@
+/*
+    small Pinephone QML interface for Out-Of-Band communication.
+
+    Copyright (C) 2023 Resilience Theatre
+
+    This program is free software; you can redistribute it and/or
+    modify it under the terms of the GNU General Public License
+    as published by the Free Software Foundation; either version 2
+    of the License, or (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "fakedaemon.h"
+#include "engineclass.h"
+#include "fiforeader.h"
+#include "fifoprotocol.h"
+#include <QDebug>
+#include <QDir>
+#include <QSettings>
+#include <fcntl.h>
+#include <unistd.h>
+#include <errno.h>
+#include <sys/stat.h>
+#include <sys/ioctl.h>
+
+FakeDaemon::FakeDaemon(const QString &root, int peerCount, QObject *parent)
+    : QObject{parent}, m_root(root), m_online(peerCount, true)
+{
+    QDir().mkpath(root + "/tmp");
+    QDir().mkpath(root + "/opt/tunnel");
+    writeSettings();
+    if ( !createFifo(TELEMETRY_FIFO_IN) || !createFifo(TELEMETRY_FIFO_OUT) || !createFifo(MESSAGE_RECEIVE_FIFO) )
+        return;
+    m_commandReader = new FifoReader(root + TELEMETRY_FIFO_IN, this);
+    connect(m_commandReader, &FifoReader::lineReceived, this, &FakeDaemon::telemetryCommand);
+    m_statusFd = openFifo(TELEMETRY_FIFO_OUT);
+    m_messageFd = openFifo(MESSAGE_RECEIVE_FIFO);
+    m_ready = m_statusFd >= 0 && m_messageFd >= 0;
+}
+
+FakeDaemon::~FakeDaemon()
+{
+    if ( m_statusFd >= 0 )
+        ::close(m_statusFd);
+    if ( m_messageFd >= 0 )
+        ::close(m_messageFd);
+}
+
+/* Environment of engine, read in engineClass constructor */
+void FakeDaemon::isolateEngine(const QString &root)
+{
+    qputenv(FILE_ROOT_ENV, QFile::encodeName(root));
+    qputenv(HARDWARE_ROOT_ENV, QFile::encodeName(root + "/sys"));
+    qputenv(MIXER_CARD_ENV, MIXER_CARD_NONE);
+    qputenv(IWD_BUS_ENV, IWD_BUS_NONE);
+    qputenv(LATENCY_PROBE_ENV, "off");
+    qputenv(EXTERNAL_COMMANDS_ENV, "off");
+}
+
+bool FakeDaemon::isReady() const
+{
+    return m_ready;
+}
+
+int FakeDaemon::peerCount() const
+{
+    return m_online.size();
+}
+
+QString FakeDaemon::peerIp(int peer) const
+{
+    return FAKE_DAEMON_PEER_NET + QString::number(peer + 1);
+}
+
+void FakeDaemon::setPeerOnline(int peer, bool online)
+{
+    if ( peer >= 0 && peer < m_online.size() )
+        m_online[peer] = online;
+}
+
+/*
+    Write up to count "ip,text" lines from peer, only as many whole
+    lines as fit in FIFO so engine never sees a split line. Returns
+    lines written, caller keeps event loop running between calls.
+*/
+int FakeDaemon::sendMessages(int peer, const QByteArray &text, int count)
+{
+    QByteArray line = peerIp(peer).toLatin1() + "," + text + "\n";
+    int fit = qMin(count, freeBytes(m_messageFd) / line.size());
+    if ( fit <= 0 )
+        return 0;
+    QByteArray batch;
+    batch.reserve(line.size() * fit);
+    for (int x=0; x < fit; x++)
+        batch += line;
+    qint64 written = ::write(m_messageFd, batch.constData(), size_t(batch.size()));
+    if ( written < 0 ) {
+        if ( errno != EAGAIN )
+            qErrnoWarning(errno, "Cannot write message FIFO");
+        return 0;
+    }
+    return int(written / line.size());
+}
+
+quint64 FakeDaemon::commandsReceived() const
+{
+    return m_commands;
+}
+
+/* Off for replay, recorded traffic already holds daemon replies */
+void FakeDaemon::setAutoReply(bool enabled)
+{
+    m_autoReply = enabled;
+}
+
+/* Replace generated node settings with a copy of a device sinm.ini */
+bool FakeDaemon::useSettings(const QString &file)
+{
+    QString target = m_root + SETTINGS_INI_FILE;
+    QFile::remove(target);
+    if ( !QFile::copy(file, target) ) {
+        qWarning() << "Fake daemon: cannot copy settings" << file;
+        return false;
+    }
+    return true;
+}
+
+/* Write one whole line to FIFO engine reads, false when it does not fit yet */
+bool FakeDaemon::sendLine(FifoChannel channel, const QByteArray &line)
+{
+    int fd = channel == FIFO_CHANNEL_MESSAGE ? m_messageFd : m_statusFd;
+    QByteArray frame = line + "\n";
+    if ( freeBytes(fd) < frame.size() )
+        return false;
+    qint64 written = ::write(fd, frame.constData(), size_t(frame.size()));
+    if ( written < 0 && errno != EAGAIN )
+        qErrnoWarning(errno, "Cannot write FIFO");
+    return written == frame.size();
+}
+
+/* Bytes written but not yet read by engine on both FIFOs */
+int FakeDaemon::pendingBytes() const
+{
+    int total = 0;
+    for (int fd : { m_statusFd, m_messageFd }) {
+        int queued = 0;
+        if ( fd >= 0 && ioctl(fd, FIONREAD, &queued) == 0 )
+            total += queued;
+    }
+    return total;
+}
+
+void FakeDaemon::telemetryCommand(const QByteArray &line)
+{
+    m_commands++;
+    emit commandReceived(line);
+    if ( !m_autoReply )
+        return;
+    FifoFrame frame;
+    if ( parseFifoFrame(std::string_view(line.constData(), line.size()), frame) != FIFO_FRAME_OK ) {
+        qWarning() << "Fake daemon: malformed command" << line;
+        return;
+    }
+    QByteArray peer(frame.peer.data(), int(frame.peer.size()));
+    QByteArray command(frame.command.data(), int(frame.command.size()));
+    if ( command == "daemon_ping" ) {
+        reply("telemetryclient_is_alive");
+        return;
+    }
+    if ( command == "status" ) {
+        int index = m_online.size();
+        for (int x=0; x < m_online.size(); x++) {
+            if ( peerIp(x).toLatin1() == peer )
+                index = x;
+        }
+        bool online = index < m_online.size() && m_online.at(index);
+        reply(peer + (online ? ",available" : ",offline"));
+        return;
+    }
+    reply(peer + "," + command + "_ready");
+}
+
+void FakeDaemon::reply(const QByteArray &line)
+{
+    if ( !sendLine(FIFO_CHANNEL_TELEMETRY, line) )
+        qWarning() << "Fake daemon: status FIFO full, reply dropped" << line;
+}
+
+bool FakeDaemon::createFifo(const char *path)
+{
+    QByteArray fifo = QFile::encodeName(m_root + path);
+    if ( mkfifo(fifo.constData(), 0600) < 0 && errno != EEXIST ) {
+        qErrnoWarning(errno, "Cannot create FIFO %s", fifo.constData());
+        return false;
+    }
+    return true;
+}
+
+/* Read end kept by us too, writes never fail with ENXIO before engine opens it */
+int FakeDaemon::openFifo(const char *path)
+{
+    QByteArray fifo = QFile::encodeName(m_root + path);
+    int fd = ::open(fifo.constData(), O_RDWR | O_NONBLOCK | O_CLOEXEC);
+    if ( fd < 0 )
+        qErrnoWarning(errno, "Cannot open %s", fifo.constData());
+    return fd;
+}
+
+int FakeDaemon::freeBytes(int fd) const
+{
+    int capacity = fcntl(fd, F_GETPIPE_SZ);
+    int queued = 0;
+    if ( capacity < 0 || ioctl(fd, FIONREAD, &queued) < 0 )
+        return 0;
+    return capacity - queued;
+}
+
+/* Own node is index 0, peers follow, same layout as sinm.ini on device */
+void FakeDaemon::writeSettings()
+{
+    QSettings settings(m_root + SETTINGS_INI_FILE, QSettings::IniFormat);
+    settings.setValue("my_id", FAKE_DAEMON_OWN_ID);
+    settings.setValue("my_ip", FAKE_DAEMON_OWN_IP);
+    settings.setValue("my_name", "bench");
+    settings.setValue("node_name_0", "bench");
+    settings.setValue("node_ip_0", FAKE_DAEMON_OWN_IP);
+    settings.setValue("node_id_0", FAKE_DAEMON_OWN_ID);
+    for (int x=0; x < m_online.size(); x++) {
+        settings.setValue("node_name_" + QString::number(x + 1), "peer" + QString::number(x));
+        settings.setValue("node_ip_" + QString::number(x + 1), peerIp(x));
+        settings.setValue("node_id_" + QString::number(x + 1), QString::number(x + 1).rightJustified(2, '0'));
+    }
+    settings.sync();
+}
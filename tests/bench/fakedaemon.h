@@ -0,0 +1,88 @@
+/*  Small Pine phone QML interface for Out-Of-Band communication.
+
+    Copyright (C) 2023 Resilience Theatre
+
+    This program is free software; you can redistribute it and/or
+    modify it under the terms of the GNU General Public License
+    as published by the Free Software Foundation; either version 2
+    of the License, or (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; If not, see <http://www.gnu.org/licenses/>.
+
+*/
+#ifndef FAKEDAEMON_H
+#define FAKEDAEMON_H
+#include <QObject>
+#include <QVector>
+#include <QByteArray>
+#include "fiforecorder.h"
+
+#define FAKE_DAEMON_OWN_ID      "00"
+#define FAKE_DAEMON_OWN_IP      "10.0.0.1"
+#define FAKE_DAEMON_PEER_NET    "10.0.1."   // peer n is .n+1
+
+class FifoReader;
+
+/*
+    Telemetry daemon stand-in for tests/bench. Creates the three FIFOs
+    and node settings under a file root (QTUI_FILE_ROOT of engine),
+    reads "ip,command" lines engine writes and answers every command
+    the way telemetryclient does: status with available or offline,
+    anything else with "<ip>,<command>_ready". Peer messages are
+    written straight to message FIFO with write(), so a flood costs
+    no allocations in this process. tests/replay turns auto replies
+    off and feeds both FIFOs from a recording with sendLine().
+
+    isolateEngine() is called before engine is created: engine files
+    go under the same root, and mixer, iwd, ICMP probes and external
+    commands are off, so host state is not touched.
+*/
+class FakeDaemon : public QObject
+{
+    Q_OBJECT
+
+public:
+    FakeDaemon(const QString &root, int peerCount, QObject *parent = nullptr);
+    ~FakeDaemon();
+    static void isolateEngine(const QString &root);
+    bool isReady() const;
+    int peerCount() const;
+    QString peerIp(int peer) const;
+    void setPeerOnline(int peer, bool online);
+    int sendMessages(int peer, const QByteArray &text, int count);
+    quint64 commandsReceived() const;
+    void setAutoReply(bool enabled);
+    bool useSettings(const QString &file);
+    bool sendLine(FifoChannel channel, const QByteArray &line);
+    int pendingBytes() const;
+
+signals:
+    void commandReceived(const QByteArray &line);
+
+private slots:
+    void telemetryCommand(const QByteArray &line);
+
+private:
+    bool createFifo(const char *path);
+    int openFifo(const char *path);
+    int freeBytes(int fd) const;
+    void reply(const QByteArray &line);
+    void writeSettings();
+
+    QString m_root;
+    QVector<bool> m_online;
+    FifoReader *m_commandReader=nullptr;
+    int m_statusFd=-1;
+    int m_messageFd=-1;
+    bool m_ready=false;
+    bool m_autoReply=true;
+    quint64 m_commands=0;
+};
+
+#endif // FAKEDAEMON_H
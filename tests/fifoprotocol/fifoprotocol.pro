@@ -0,0 +1,20 @@
+# FIFO frame parser and message FIFO command matching.
+
+TEMPLATE = app
+TARGET = fifoprotocoltest
+QT = core testlib
+CONFIG += console c++17
+CONFIG -= app_bundle
+
+INCLUDEPATH += ../..
+
+SOURCES += \
+    fifoprotocoltest.cpp
+
+HEADERS += \
+    ../../fifoprotocol.h
+
+# make check: non-zero exit on failure
+check.commands = ./$${TARGET}
+check.depends = $${TARGET}
+QMAKE_EXTRA_TARGETS += check
@@ -0,0 +1,117 @@
+/*
+    small Pinephone QML interface for Out-Of-Band communication.
+
+    Copyright (C) 2023 Resilience Theatre
+
+    This program is free software; you can redistribute it and/or
+    modify it under the terms of the GNU General Public License
+    as published by the Free Software Foundation; either version 2
+    of the License, or (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/*
+    FIFO frame tokenizing and message FIFO command matching. Chat
+    text that starts with or resembles a command word must stay text.
+*/
+#include "fifoprotocol.h"
+#include <QtTest>
+
+Q_DECLARE_METATYPE(FifoMessageCommand)
+
+class FifoProtocolTest : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void parseFrame_data();
+    void parseFrame();
+    void parseErrors();
+    void messageCommand_data();
+    void messageCommand();
+};
+
+static QByteArray bytes(std::string_view view)
+{
+    return QByteArray(view.data(), int(view.size()));
+}
+
+void FifoProtocolTest::parseFrame_data()
+{
+    QTest::addColumn<QByteArray>("line");
+    QTest::addColumn<QByteArray>("peer");
+    QTest::addColumn<QByteArray>("command");
+    QTest::addColumn<QByteArray>("args");
+
+    QTest::newRow("status") << QByteArray("10.0.1.1,available\n") << QByteArray("10.0.1.1")
+                            << QByteArray("available") << QByteArray();
+    QTest::newRow("arguments") << QByteArray("10.0.0.2,client_connected;02;10.0.0.2;bob") << QByteArray("10.0.0.2")
+                               << QByteArray("client_connected;02;10.0.0.2;bob") << QByteArray("02;10.0.0.2;bob");
+    QTest::newRow("next field") << QByteArray("10.0.1.1,Ledredon,extra\r\n") << QByteArray("10.0.1.1")
+                                << QByteArray("Ledredon") << QByteArray();
+    QTest::newRow("chat") << QByteArray("10.0.1.1,ring;are you there") << QByteArray("10.0.1.1")
+                          << QByteArray("ring;are you there") << QByteArray("are you there");
+}
+
+void FifoProtocolTest::parseFrame()
+{
+    QFETCH(QByteArray, line);
+    QFETCH(QByteArray, peer);
+    QFETCH(QByteArray, command);
+    QFETCH(QByteArray, args);
+    FifoFrame frame;
+    QCOMPARE(parseFifoFrame(std::string_view(line.constData(), line.size()), frame), FIFO_FRAME_OK);
+    QCOMPARE(bytes(frame.peer), peer);
+    QCOMPARE(bytes(frame.command), command);
+    QCOMPARE(bytes(frame.args), args);
+}
+
+void FifoProtocolTest::parseErrors()
+{
+    FifoFrame frame;
+    QCOMPARE(parseFifoFrame("\r\n", frame), FIFO_FRAME_EMPTY);
+    QCOMPARE(parseFifoFrame("telemetryclient_is_alive", frame), FIFO_FRAME_NO_SEPARATOR);
+    QCOMPARE(parseFifoFrame(",ring", frame), FIFO_FRAME_NO_PEER);
+    QCOMPARE(parseFifoFrame("10.0.1.1,", frame), FIFO_FRAME_NO_COMMAND);
+}
+
+void FifoProtocolTest::messageCommand_data()
+{
+    QTest::addColumn<QByteArray>("field");
+    QTest::addColumn<FifoMessageCommand>("expected");
+
+    QTest::newRow("ring") << QByteArray("ring") << FIFO_MESSAGE_RING;
+    QTest::newRow("Ping") << QByteArray("Ping") << FIFO_MESSAGE_PING;
+    QTest::newRow("Ledredon") << QByteArray("Ledredon") << FIFO_MESSAGE_LED;
+    QTest::newRow("Ledgreenoff") << QByteArray("Ledgreenoff") << FIFO_MESSAGE_LED;
+    QTest::newRow("SonarPing") << QByteArray("SonarPing") << FIFO_MESSAGE_SONAR_PING;
+    QTest::newRow("remote_hangup") << QByteArray("remote_hangup") << FIFO_MESSAGE_REMOTE_HANGUP;
+    QTest::newRow("client_connected") << QByteArray("client_connected;02;10.0.0.2;bob") << FIFO_MESSAGE_CLIENT_CONNECTED;
+    QTest::newRow("Client_Connected") << QByteArray("Client_Connected;02;10.0.0.2;bob") << FIFO_MESSAGE_CLIENT_CONNECTED;
+    QTest::newRow("macsec_keyed") << QByteArray("eth1 macsec_keyed") << FIFO_MESSAGE_MACSEC_KEYED;
+    QTest::newRow("hsm_insert") << QByteArray("hsm_insert;slot0") << FIFO_MESSAGE_HSM_INSERT;
+
+    QTest::newRow("chat ring;") << QByteArray("ring;call me back") << FIFO_MESSAGE_TEXT;
+    QTest::newRow("chat Ping;") << QByteArray("Ping;pong?") << FIFO_MESSAGE_TEXT;
+    QTest::newRow("chat Ping ") << QByteArray("Ping me later") << FIFO_MESSAGE_TEXT;
+    QTest::newRow("chat Ledredon ") << QByteArray("Ledredon is broken") << FIFO_MESSAGE_TEXT;
+    QTest::newRow("chat ring case") << QByteArray("Ring") << FIFO_MESSAGE_TEXT;
+    QTest::newRow("chat plain") << QByteArray("hello there") << FIFO_MESSAGE_TEXT;
+}
+
+void FifoProtocolTest::messageCommand()
+{
+    QFETCH(QByteArray, field);
+    QFETCH(FifoMessageCommand, expected);
+    QCOMPARE(fifoMessageCommand(std::string_view(field.constData(), field.size())), expected);
+}
+
+QTEST_APPLESS_MAIN(FifoProtocolTest)
+#include "fifoprotocoltest.moc"
@@ -0,0 +1,25 @@
+# IwdClient against a mock iwd on a private dbus-daemon.
+
+TEMPLATE = app
+TARGET = iwdtest
+QT = core dbus testlib
+CONFIG += console c++17
+CONFIG -= app_bundle
+
+INCLUDEPATH += ../..
+
+SOURCES += \
+    iwdtest.cpp \
+    mockiwd.cpp \
+    ../../iwdclient.cpp \
+    ../../wifinetworkmodel.cpp
+
+HEADERS += \
+    mockiwd.h \
+    ../../iwdclient.h \
+    ../../wifinetworkmodel.h
+
+# make check: non-zero exit on failure, skipped without dbus-daemon
+check.commands = ./$${TARGET}
+check.depends = $${TARGET}
+QMAKE_EXTRA_TARGETS += check
@@ -0,0 +1,186 @@
+/*
+    small Pinephone QML interface for Out-Of-Band communication.
+
+    Copyright (C) 2023 Resilience Theatre
+
+    This program is free software; you can redistribute it and/or
+    modify it under the terms of the GNU General Public License
+    as published by the Free Software Foundation; either version 2
+    of the License, or (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/*
+    IwdClient and WifiNetworkModel against MockIwd on a private
+    dbus-daemon, service and client on separate bus connections.
+    Skipped when dbus-daemon is not installed.
+*/
+#include "iwdclient.h"
+#include "wifinetworkmodel.h"
+#include "mockiwd.h"
+#include <QtTest>
+#include <QProcess>
+#include <QDBusConnection>
+
+#define IWD_TEST_TIMEOUT        5000
+
+class IwdTest : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void cleanupTestCase();
+    void init();
+    void cleanup();
+    void loadsManagedObjects();
+    void scanStreamsNetworks();
+    void connectAnswersAgentPassphrase();
+    void connectWrongPassphraseFails();
+    void disconnectClearsConnectedNetwork();
+    void serviceExitResetsModel();
+
+private:
+    QProcess m_daemon;
+    QString m_address;
+    MockIwd *m_mock=nullptr;
+    WifiNetworkModel *m_model=nullptr;
+    IwdClient *m_client=nullptr;
+};
+
+void IwdTest::initTestCase()
+{
+    m_daemon.start("dbus-daemon", { "--session", "--nofork", "--print-address" });
+    if ( !m_daemon.waitForStarted() )
+        QSKIP("dbus-daemon not available");
+    QTRY_VERIFY_WITH_TIMEOUT(m_daemon.canReadLine(), IWD_TEST_TIMEOUT);
+    m_address = QString::fromLatin1(m_daemon.readLine().trimmed());
+    QVERIFY(!m_address.isEmpty());
+}
+
+void IwdTest::cleanupTestCase()
+{
+    m_daemon.kill();
+    m_daemon.waitForFinished();
+}
+
+/* Fresh connections per test, nothing of previous test is left on bus */
+void IwdTest::init()
+{
+    static int round = 0;
+    round++;
+    QDBusConnection serviceBus = QDBusConnection::connectToBus(m_address, "mockiwd" + QString::number(round));
+    QDBusConnection clientBus = QDBusConnection::connectToBus(m_address, "client" + QString::number(round));
+    QVERIFY(serviceBus.isConnected());
+    QVERIFY(clientBus.isConnected());
+    m_mock = new MockIwd(serviceBus);
+    m_mock->addNetwork("office", "secret", -5500);
+    m_mock->addNetwork("cafe", QString(), -7500);
+    m_mock->addNetwork("hidden", "hidden-pass", -6000, true);
+    QVERIFY(m_mock->start());
+    m_model = new WifiNetworkModel;
+    m_client = new IwdClient(m_model, clientBus);
+    /* Initial load ends with GetOrderedNetworks reply */
+    QSignalSpy loaded(m_client, &IwdClient::scanFinished);
+    QTRY_COMPARE_WITH_TIMEOUT(loaded.count(), 1, IWD_TEST_TIMEOUT);
+    QVERIFY(m_client->isAvailable());
+    QTRY_VERIFY_WITH_TIMEOUT(m_mock->hasAgent(), IWD_TEST_TIMEOUT);
+}
+
+void IwdTest::cleanup()
+{
+    delete m_client;
+    delete m_model;
+    delete m_mock;
+    m_client = nullptr;
+    m_model = nullptr;
+    m_mock = nullptr;
+}
+
+void IwdTest::loadsManagedObjects()
+{
+    QCOMPARE(m_model->count(), 2);
+    int office = m_model->indexOfSsid("office");
+    QVERIFY(office >= 0);
+    QCOMPARE(m_model->network(office).security, QString("psk"));
+    /* -55 dBm is 90 %, from GetOrderedNetworks */
+    QCOMPARE(m_model->network(office).strength, 90);
+    QCOMPARE(m_client->state(), QString("disconnected"));
+    QCOMPARE(m_model->indexOfSsid("hidden"), -1);
+}
+
+void IwdTest::scanStreamsNetworks()
+{
+    QSignalSpy scanning(m_client, &IwdClient::scanningChanged);
+    QSignalSpy finished(m_client, &IwdClient::scanFinished);
+    QVERIFY(m_client->scan());
+    QTRY_COMPARE_WITH_TIMEOUT(finished.count(), 1, IWD_TEST_TIMEOUT);
+    QCOMPARE(m_mock->scanCount(), 1);
+    QCOMPARE(scanning.count(), 2);
+    QCOMPARE(scanning.at(0).at(0).toBool(), true);
+    QCOMPARE(scanning.at(1).at(0).toBool(), false);
+    QCOMPARE(m_model->count(), 3);
+    QCOMPARE(finished.at(0).at(0).toInt(), 3);
+    int hidden = m_model->indexOfSsid("hidden");
+    QVERIFY(hidden >= 0);
+    QCOMPARE(m_model->network(hidden).strength, 80);
+    QVERIFY(!m_client->isScanning());
+}
+
+void IwdTest::connectAnswersAgentPassphrase()
+{
+    QSignalSpy failed(m_client, &IwdClient::connectFailed);
+    QVERIFY(m_client->connectNetwork("office", "secret"));
+    QTRY_COMPARE_WITH_TIMEOUT(m_client->state(), QString("connected"), IWD_TEST_TIMEOUT);
+    QCOMPARE(m_client->connectedSsid(), QString("office"));
+    QVERIFY(m_model->network(m_model->indexOfSsid("office")).connected);
+    QCOMPARE(failed.count(), 0);
+    /* Passphrase is forgotten once Connect returned */
+    QTRY_VERIFY_WITH_TIMEOUT(m_client->passphraseFor(m_model->network(m_model->indexOfSsid("office")).id).isEmpty(),
+                             IWD_TEST_TIMEOUT);
+}
+
+void IwdTest::connectWrongPassphraseFails()
+{
+    QSignalSpy failed(m_client, &IwdClient::connectFailed);
+    QVERIFY(m_client->connectNetwork("office", "wrong"));
+    QTRY_COMPARE_WITH_TIMEOUT(failed.count(), 1, IWD_TEST_TIMEOUT);
+    QCOMPARE(m_client->state(), QString("disconnected"));
+    QVERIFY(m_client->connectedSsid().isEmpty());
+    QVERIFY(!m_client->connectNetwork("nowhere", "x"));
+    QCOMPARE(failed.count(), 2);
+}
+
+void IwdTest::disconnectClearsConnectedNetwork()
+{
+    QVERIFY(m_client->connectNetwork("cafe", QString()));
+    QTRY_COMPARE_WITH_TIMEOUT(m_client->connectedSsid(), QString("cafe"), IWD_TEST_TIMEOUT);
+    m_mock->disconnectStation();
+    QTRY_COMPARE_WITH_TIMEOUT(m_client->state(), QString("disconnected"), IWD_TEST_TIMEOUT);
+    QVERIFY(m_client->connectedSsid().isEmpty());
+    QVERIFY(!m_model->network(m_model->indexOfSsid("cafe")).connected);
+}
+
+void IwdTest::serviceExitResetsModel()
+{
+    QSignalSpy available(m_client, &IwdClient::availableChanged);
+    m_mock->stop();
+    QTRY_COMPARE_WITH_TIMEOUT(available.count(), 1, IWD_TEST_TIMEOUT);
+    QCOMPARE(available.at(0).at(0).toBool(), false);
+    QCOMPARE(m_model->count(), 0);
+    QVERIFY(!m_client->scan());
+    /* iwd restart is picked up again */
+    QVERIFY(m_mock->start());
+    QTRY_VERIFY_WITH_TIMEOUT(m_client->isAvailable(), IWD_TEST_TIMEOUT);
+    QTRY_COMPARE_WITH_TIMEOUT(m_model->count(), 2, IWD_TEST_TIMEOUT);
+}
+
+QTEST_GUILESS_MAIN(IwdTest)
+#include "iwdtest.moc"
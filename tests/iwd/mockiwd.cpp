@@ -0,0 +1,261 @@
+/*
+    small Pinephone QML interface for Out-Of-Band communication.
+
+    Copyright (C) 2023 Resilience Theatre
+
+    This program is free software; you can redistribute it and/or
+    modify it under the terms of the GNU General Public License
+    as published by the Free Software Foundation; either version 2
+    of the License, or (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "mockiwd.h"
+#include "iwdclient.h"
+#include <QDBusMetaType>
+#include <QDBusPendingCallWatcher>
+#include <QDBusPendingReply>
+#include <QTimer>
+#include <algorithm>
+
+#define IWD_STATION_INTERFACE   "net.connman.iwd.Station"
+#define IWD_NETWORK_INTERFACE   "net.connman.iwd.Network"
+#define IWD_DEVICE_INTERFACE    "net.connman.iwd.Device"
+#define IWD_AGENT_MANAGER       "net.connman.iwd.AgentManager"
+#define IWD_AGENT_INTERFACE     "net.connman.iwd.Agent"
+#define DBUS_OBJECT_MANAGER     "org.freedesktop.DBus.ObjectManager"
+#define DBUS_PROPERTIES         "org.freedesktop.DBus.Properties"
+
+MockIwd::MockIwd(const QDBusConnection &bus, QObject *parent)
+    : QDBusVirtualObject{parent}, m_bus(bus)
+{
+    qDBusRegisterMetaType<IwdInterfaceMap>();
+    qDBusRegisterMetaType<IwdObjectMap>();
+    qDBusRegisterMetaType<IwdOrderedNetwork>();
+    qDBusRegisterMetaType<IwdOrderedNetworkList>();
+}
+
+MockIwd::~MockIwd()
+{
+    stop();
+}
+
+bool MockIwd::start()
+{
+    if ( !m_bus.registerVirtualObject("/", this, QDBusConnection::SubPath) )
+        return false;
+    m_registered = true;
+    return m_bus.registerService(IWD_SERVICE);
+}
+
+/* Service leaves bus, like iwd exiting */
+void MockIwd::stop()
+{
+    if ( !m_registered )
+        return;
+    m_bus.unregisterService(IWD_SERVICE);
+    m_bus.unregisterObject("/", QDBusConnection::UnregisterTree);
+    m_registered = false;
+    m_agentService.clear();
+    m_agentPath.clear();
+}
+
+/* Network object path is hex encoded ssid plus security, as in iwd */
+void MockIwd::addNetwork(const QString &ssid, const QString &passphrase, qint16 signal, bool hidden)
+{
+    Network network;
+    network.path = QString(MOCK_IWD_STATION_PATH) + "/" + QString::fromLatin1(ssid.toUtf8().toHex())
+                   + (passphrase.isEmpty() ? "_open" : "_psk");
+    network.ssid = ssid;
+    network.passphrase = passphrase;
+    network.signal = signal;
+    network.hidden = hidden;
+    m_networks.append(network);
+}
+
+void MockIwd::disconnectStation()
+{
+    int index = networkIndex(m_connectedNetwork);
+    if ( index >= 0 )
+        propertiesChanged(m_connectedNetwork, IWD_NETWORK_INTERFACE, {{ "Connected", false }});
+    m_connectedNetwork.clear();
+    m_state = "disconnected";
+    propertiesChanged(MOCK_IWD_STATION_PATH, IWD_STATION_INTERFACE, {{ "State", m_state }}, { "ConnectedNetwork" });
+}
+
+bool MockIwd::hasAgent() const
+{
+    return !m_agentPath.isEmpty();
+}
+
+int MockIwd::scanCount() const
+{
+    return m_scans;
+}
+
+QString MockIwd::introspect(const QString &path) const
+{
+    Q_UNUSED(path);
+    return QString();
+}
+
+bool MockIwd::handleMessage(const QDBusMessage &message, const QDBusConnection &connection)
+{
+    Q_UNUSED(connection);
+    const QString interface = message.interface();
+    const QString member = message.member();
+    if ( interface == DBUS_OBJECT_MANAGER && member == "GetManagedObjects" ) {
+        IwdObjectMap objects;
+        objects[QDBusObjectPath(MOCK_IWD_STATION_PATH)][IWD_STATION_INTERFACE] = stationProperties();
+        objects[QDBusObjectPath(MOCK_IWD_STATION_PATH)][IWD_DEVICE_INTERFACE] = QVariantMap{{ "Name", "wlan0" }};
+        for (const Network &network : qAsConst(m_networks)) {
+            if ( !network.hidden )
+                objects[QDBusObjectPath(network.path)][IWD_NETWORK_INTERFACE] = networkProperties(network);
+        }
+        m_bus.send(message.createReply(QVariant::fromValue(objects)));
+        return true;
+    }
+    if ( interface == IWD_AGENT_MANAGER && member == "RegisterAgent" ) {
+        m_agentService = message.service();
+        m_agentPath = qvariant_cast<QDBusObjectPath>(message.arguments().value(0)).path();
+        reply(message);
+        return true;
+    }
+    if ( interface == IWD_STATION_INTERFACE && member == "Scan" ) {
+        if ( m_scanning ) {
+            m_bus.send(message.createErrorReply("net.connman.iwd.Busy", "Scan in progress"));
+            return true;
+        }
+        m_scans++;
+        m_scanning = true;
+        reply(message);
+        propertiesChanged(MOCK_IWD_STATION_PATH, IWD_STATION_INTERFACE, {{ "Scanning", true }});
+        QTimer::singleShot(MOCK_IWD_SCAN_DELAY, this, &MockIwd::finishScan);
+        return true;
+    }
+    if ( interface == IWD_STATION_INTERFACE && member == "GetOrderedNetworks" ) {
+        IwdOrderedNetworkList list;
+        for (const Network &network : qAsConst(m_networks)) {
+            if ( network.hidden )
+                continue;
+            IwdOrderedNetwork entry;
+            entry.path = QDBusObjectPath(network.path);
+            entry.signal = network.signal;
+            list.append(entry);
+        }
+        std::sort(list.begin(), list.end(), [](const IwdOrderedNetwork &a, const IwdOrderedNetwork &b) {
+            return a.signal > b.signal;
+        });
+        m_bus.send(message.createReply(QVariant::fromValue(list)));
+        return true;
+    }
+    if ( interface == IWD_NETWORK_INTERFACE && member == "Connect" ) {
+        int index = networkIndex(message.path());
+        if ( index < 0 || m_networks.at(index).hidden ) {
+            m_bus.send(message.createErrorReply("net.connman.iwd.NotFound", "No such network"));
+            return true;
+        }
+        connectNetwork(message, index);
+        return true;
+    }
+    return false;
+}
+
+int MockIwd::networkIndex(const QString &path) const
+{
+    for (int x=0; x < m_networks.size(); x++) {
+        if ( m_networks.at(x).path == path )
+            return x;
+    }
+    return -1;
+}
+
+QVariantMap MockIwd::stationProperties() const
+{
+    QVariantMap properties{{ "State", m_state }, { "Scanning", m_scanning }};
+    if ( !m_connectedNetwork.isEmpty() )
+        properties.insert("ConnectedNetwork", QVariant::fromValue(QDBusObjectPath(m_connectedNetwork)));
+    return properties;
+}
+
+QVariantMap MockIwd::networkProperties(const Network &network) const
+{
+    return QVariantMap{
+        { "Name", network.ssid },
+        { "Type", network.passphrase.isEmpty() ? "open" : "psk" },
+        { "Connected", network.path == m_connectedNetwork },
+        { "Device", QVariant::fromValue(QDBusObjectPath(MOCK_IWD_STATION_PATH)) }
+    };
+}
+
+void MockIwd::propertiesChanged(const QString &path, const QString &interface,
+                                const QVariantMap &changed, const QStringList &invalidated)
+{
+    QDBusMessage signal = QDBusMessage::createSignal(path, DBUS_PROPERTIES, "PropertiesChanged");
+    signal << interface << changed << invalidated;
+    m_bus.send(signal);
+}
+
+/* Hidden networks are found by scan, announced before Scanning goes false */
+void MockIwd::finishScan()
+{
+    for (Network &network : m_networks) {
+        if ( !network.hidden )
+            continue;
+        network.hidden = false;
+        IwdInterfaceMap interfaces;
+        interfaces[IWD_NETWORK_INTERFACE] = networkProperties(network);
+        QDBusMessage signal = QDBusMessage::createSignal("/", DBUS_OBJECT_MANAGER, "InterfacesAdded");
+        signal << QVariant::fromValue(QDBusObjectPath(network.path)) << QVariant::fromValue(interfaces);
+        m_bus.send(signal);
+    }
+    m_scanning = false;
+    propertiesChanged(MOCK_IWD_STATION_PATH, IWD_STATION_INTERFACE, {{ "Scanning", false }});
+}
+
+/* Connect replies only after agent answered passphrase request */
+void MockIwd::connectNetwork(const QDBusMessage &message, int index)
+{
+    const Network network = m_networks.at(index);
+    if ( !network.passphrase.isEmpty() && m_agentPath.isEmpty() ) {
+        m_bus.send(message.createErrorReply("net.connman.iwd.NoAgent", "No agent registered"));
+        return;
+    }
+    auto connected = [this, message, network]() {
+        m_connectedNetwork = network.path;
+        m_state = "connected";
+        propertiesChanged(network.path, IWD_NETWORK_INTERFACE, {{ "Connected", true }});
+        propertiesChanged(MOCK_IWD_STATION_PATH, IWD_STATION_INTERFACE,
+                          {{ "State", m_state }, { "ConnectedNetwork", QVariant::fromValue(QDBusObjectPath(network.path)) }});
+        reply(message);
+    };
+    if ( network.passphrase.isEmpty() ) {
+        connected();
+        return;
+    }
+    QDBusMessage request = QDBusMessage::createMethodCall(m_agentService, m_agentPath, IWD_AGENT_INTERFACE, "RequestPassphrase");
+    request << QVariant::fromValue(QDBusObjectPath(network.path));
+    QDBusPendingCallWatcher *watcher = new QDBusPendingCallWatcher(m_bus.asyncCall(request), this);
+    connect(watcher, &QDBusPendingCallWatcher::finished, this, [this, message, network, connected](QDBusPendingCallWatcher *watcher) {
+        QDBusPendingReply<QString> passphrase = *watcher;
+        watcher->deleteLater();
+        if ( passphrase.isError() )
+            m_bus.send(message.createErrorReply("net.connman.iwd.Aborted", passphrase.error().message()));
+        else if ( passphrase.value() != network.passphrase )
+            m_bus.send(message.createErrorReply("net.connman.iwd.Failed", "Operation failed"));
+        else
+            connected();
+    });
+}
+
+void MockIwd::reply(const QDBusMessage &message)
+{
+    m_bus.send(message.createReply());
+}
@@ -0,0 +1,83 @@
+/*  Small Pine phone QML interface for Out-Of-Band communication.
+
+    Copyright (C) 2023 Resilience Theatre
+
+    This program is free software; you can redistribute it and/or
+    modify it under the terms of the GNU General Public License
+    as published by the Free Software Foundation; either version 2
+    of the License, or (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; If not, see <http://www.gnu.org/licenses/>.
+
+*/
+#ifndef MOCKIWD_H
+#define MOCKIWD_H
+#include <QDBusConnection>
+#include <QDBusVirtualObject>
+#include <QDBusMessage>
+#include <QVariantMap>
+#include <QVector>
+
+#define MOCK_IWD_STATION_PATH   "/net/connman/iwd/0/3"
+#define MOCK_IWD_SCAN_DELAY     20      // ms, Scanning true until then
+
+/*
+    Minimal iwd for tests/iwd: one station, networks added by test.
+    Answers ObjectManager, AgentManager, Station and Network calls
+    of IwdClient and sends InterfacesAdded and PropertiesChanged
+    like iwd does. Network.Connect() asks registered agent for
+    passphrase before replying. Hidden networks appear on Scan().
+*/
+class MockIwd : public QDBusVirtualObject
+{
+    Q_OBJECT
+
+public:
+    explicit MockIwd(const QDBusConnection &bus, QObject *parent = nullptr);
+    ~MockIwd();
+    bool start();
+    void stop();
+    void addNetwork(const QString &ssid, const QString &passphrase, qint16 signal, bool hidden = false);
+    void disconnectStation();
+    bool hasAgent() const;
+    int scanCount() const;
+
+    QString introspect(const QString &path) const override;
+    bool handleMessage(const QDBusMessage &message, const QDBusConnection &connection) override;
+
+private:
+    struct Network
+    {
+        QString path;
+        QString ssid;
+        QString passphrase;
+        qint16 signal=0;
+        bool hidden=false;
+    };
+    int networkIndex(const QString &path) const;
+    QVariantMap stationProperties() const;
+    QVariantMap networkProperties(const Network &network) const;
+    void propertiesChanged(const QString &path, const QString &interface,
+                           const QVariantMap &changed, const QStringList &invalidated = QStringList());
+    void finishScan();
+    void connectNetwork(const QDBusMessage &message, int index);
+    void reply(const QDBusMessage &message);
+
+    QDBusConnection m_bus;
+    QVector<Network> m_networks;
+    QString m_state="disconnected";
+    QString m_connectedNetwork;
+    bool m_scanning=false;
+    int m_scans=0;
+    QString m_agentService;
+    QString m_agentPath;
+    bool m_registered=false;
+};
+
+#endif // MOCKIWD_H
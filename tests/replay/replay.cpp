@@ -0,0 +1,198 @@
+/*
+    small Pinephone QML interface for Out-Of-Band communication.
+
+    Copyright (C) 2023 Resilience Theatre
+
+    This program is free software; you can redistribute it and/or
+    modify it under the terms of the GNU General Public License
+    as published by the Free Software Foundation; either version 2
+    of the License, or (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/*
+    Feeds a recording made with QTUI_FIFO_RECORD=<file> back into a
+    headless engine through FakeDaemon FIFOs. Frame is written when
+    wall clock reaches its recorded time divided by speed, or as fast
+    as FIFOs take them with "max":
+
+        replay <recording> [speed|max] [sinm.ini|-] [expect.ini]
+
+    Engine runs in this thread, so lag of a frame behind its schedule
+    is time engine spent on earlier frames. Engine timers run in real
+    time too, so runs are not deterministic: results are compared to
+    limits of expect.ini and exit status is non-zero when any is not
+    met.
+*/
+#include "engineclass.h"
+#include "fakedaemon.h"
+#include "fiforecorder.h"
+#include <QGuiApplication>
+#include <QTemporaryDir>
+#include <QSignalSpy>
+#include <QElapsedTimer>
+#include <QSettings>
+#include <QDebug>
+#include <algorithm>
+
+#define REPLAY_PEERS            8
+#define REPLAY_DEFAULT_SPEED    1.0
+#define REPLAY_TIMEOUT          10000   // ms, startup and drain
+
+static double percentile(QVector<qint64> &samples, double fraction)
+{
+    if ( samples.isEmpty() )
+        return 0;
+    int index = qMin(samples.size() - 1, int(samples.size() * fraction));
+    std::nth_element(samples.begin(), samples.begin() + index, samples.end());
+    return samples.at(index) / 1e6;
+}
+
+struct ReplayResult
+{
+    quint64 frames=0;
+    double framesPerSecond=-1;
+    double lagP99Ms=-1;
+    double lagMaxMs=-1;
+};
+
+/* One line per expectation, false if any is not met. Metrics not measured (-1) are skipped */
+static bool checkExpectation(const ReplayResult &result, const QString &expectFile)
+{
+    QSettings expect(expectFile, QSettings::IniFormat);
+    struct Metric { const char *name; double value; const char *limitKey; int compare; };
+    const Metric metrics[] = {
+        { "frames",             double(result.frames),      "expect/frames",                    0 },
+        { "frames_per_second",  result.framesPerSecond,     "expect/frames_per_second_min",     -1 },
+        { "lag_p99_ms",         result.lagP99Ms,            "expect/lag_p99_ms_max",            1 },
+        { "lag_max_ms",         result.lagMaxMs,            "expect/lag_max_ms_max",            1 }
+    };
+    bool pass = true;
+    for (const Metric &metric : metrics) {
+        QVariant limit = expect.value(metric.limitKey);
+        if ( !limit.isValid() || metric.value < 0 )
+            continue;
+        bool ok = metric.compare > 0 ? metric.value <= limit.toDouble()
+                : metric.compare < 0 ? metric.value >= limit.toDouble()
+                : metric.value == limit.toDouble();
+        qInfo().noquote() << QString("%1 %2 expect %3 %4").arg(metric.name, -20)
+                             .arg(metric.value, 0, 'f', 3)
+                             .arg(limit.toString())
+                             .arg(ok ? "ok" : "FAIL");
+        pass &= ok;
+    }
+    return pass;
+}
+
+/* Wait until engine has read everything written, false on timeout */
+static bool drain(FakeDaemon &daemon)
+{
+    QElapsedTimer clock;
+    clock.start();
+    while ( daemon.pendingBytes() > 0 && clock.elapsed() < REPLAY_TIMEOUT )
+        QCoreApplication::processEvents(QEventLoop::AllEvents, 10);
+    QCoreApplication::processEvents();
+    return daemon.pendingBytes() == 0;
+}
+
+int main(int argc, char *argv[])
+{
+    if ( qEnvironmentVariableIsEmpty("QT_QPA_PLATFORM") )
+        qputenv("QT_QPA_PLATFORM", "offscreen");
+    QGuiApplication app(argc, argv);
+    QStringList arguments = app.arguments();
+    if ( arguments.size() < 2 ) {
+        qWarning() << "usage: replay <recording> [speed|max] [sinm.ini|-] [expect.ini]";
+        return 2;
+    }
+    /* Speed 0 is max, no schedule */
+    QString speedArgument = arguments.value(2, QString::number(REPLAY_DEFAULT_SPEED));
+    double speed = speedArgument == "max" ? 0 : speedArgument.toDouble();
+    if ( speedArgument != "max" && speed <= 0 ) {
+        qWarning() << "replay: invalid speed" << speedArgument;
+        return 2;
+    }
+    FifoRecording recording(arguments.at(1));
+    if ( !recording.isValid() )
+        return 2;
+
+    QTemporaryDir root;
+    if ( !root.isValid() )
+        return 2;
+    FakeDaemon::isolateEngine(root.path());
+    qunsetenv(FIFO_RECORD_ENV);
+    FakeDaemon daemon(root.path(), REPLAY_PEERS);
+    if ( !daemon.isReady() )
+        return 2;
+    QString settingsFile = arguments.value(3, "-");
+    if ( settingsFile != "-" && !daemon.useSettings(settingsFile) )
+        return 2;
+    QString expectFile = arguments.value(4);
+    if ( !expectFile.isEmpty() && !QFile::exists(expectFile) ) {
+        qWarning() << "replay: no expectation file" << expectFile;
+        return 2;
+    }
+    daemon.setAutoReply(false);
+
+    engineClass engine;
+    engine.setVaultMode(false);
+    QSignalSpy started(&engine, &engineClass::startupFinished);
+    if ( !started.wait(REPLAY_TIMEOUT) ) {
+        qWarning() << "replay: engine startup timed out";
+        return 1;
+    }
+    /* Daemon ping and init commands of startup are answered by recording */
+    QCoreApplication::processEvents();
+
+    ReplayResult result;
+    QVector<qint64> lag;
+    quint64 bytes = 0;
+    FifoRecord record;
+    QElapsedTimer clock;
+    clock.start();
+    while ( recording.next(record) ) {
+        qint64 due = speed > 0 ? qint64(record.nsecs / speed) : 0;
+        qint64 wait;
+        while ( ( wait = due - clock.nsecsElapsed() ) > 0 )
+            QCoreApplication::processEvents(QEventLoop::WaitForMoreEvents, int(qMax<qint64>(1, wait / 1000000)));
+        if ( speed > 0 )
+            lag.append(clock.nsecsElapsed() - due);
+        while ( !daemon.sendLine(record.channel, record.line) )
+            QCoreApplication::processEvents(QEventLoop::AllEvents, 1);
+        QCoreApplication::processEvents();
+        result.frames++;
+        bytes += quint64(record.line.size()) + 1;
+    }
+    bool drained = drain(daemon);
+    qint64 nsecs = clock.nsecsElapsed();
+
+    double framesPerSecond = nsecs > 0 ? result.frames * 1e9 / double(nsecs) : 0;
+    /* Scheduled replay runs at recording rate, throughput is checked only with max */
+    if ( speed <= 0 )
+        result.framesPerSecond = framesPerSecond;
+    qInfo().noquote() << QString("frames %1 bytes %2 speed %3").arg(result.frames).arg(bytes).arg(speedArgument);
+    qInfo().noquote() << QString("wall_ms %1 frames_per_second %2")
+                         .arg(nsecs / 1e6, 0, 'f', 1)
+                         .arg(framesPerSecond, 0, 'f', 0);
+    if ( speed > 0 ) {
+        double p50 = percentile(lag, 0.50);
+        result.lagP99Ms = percentile(lag, 0.99);
+        result.lagMaxMs = percentile(lag, 1.0);
+        qInfo().noquote() << QString("lag_ms p50 %1 p99 %2 max %3")
+                             .arg(p50, 0, 'f', 3).arg(result.lagP99Ms, 0, 'f', 3).arg(result.lagMaxMs, 0, 'f', 3);
+    }
+    if ( !drained ) {
+        qWarning() << "replay: engine did not read" << daemon.pendingBytes() << "bytes";
+        return 1;
+    }
+    if ( !expectFile.isEmpty() && !checkExpectation(result, expectFile) )
+        return 1;
+    return 0;
+}
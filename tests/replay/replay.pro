@@ -0,0 +1,24 @@
+# Replays a FIFO recording (QTUI_FIFO_RECORD) into headless engine
+# and reports throughput and schedule lag, non-zero exit when limits
+# of an expectation file (expect.ini) are not met.
+
+TEMPLATE = app
+TARGET = replay
+CONFIG += console
+CONFIG -= app_bundle
+
+DEFINES += APP_VERSION=\\\"replay\\\"
+
+include(../../engine.pri)
+
+INCLUDEPATH += ../bench
+
+SOURCES += \
+    replay.cpp \
+    ../bench/fakedaemon.cpp
+
+HEADERS += \
+    ../bench/fakedaemon.h
+
+DISTFILES += \
+    expect.ini
@@ -0,0 +1,9 @@
+# make check from application project builds and runs these on host.
+
+TEMPLATE = subdirs
+
+SUBDIRS += \
+    bench \
+    fifoprotocol \
+    iwd \
+    replay
@@ -0,0 +1,167 @@
+/*
+    small Pinephone QML interface for Out-Of-Band communication.
+
+    Copyright (C) 2023 Resilience Theatre
+
+    This program is free software; you can redistribute it and/or
+    modify it under the terms of the GNU General Public License
+    as published by the Free Software Foundation; either version 2
+    of the License, or (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "tickscheduler.h"
+#include <QDebug>
+
+TickScheduler::TickScheduler(QObject *parent)
+    : QObject{parent}
+{
+    m_clock.start();
+    m_timer = new QTimer(this);
+    m_timer->setSingleShot(true);
+    m_timer->setTimerType(Qt::CoarseTimer);
+    connect(m_timer, &QTimer::timeout, this, &TickScheduler::wakeup);
+}
+
+int TickScheduler::addJob(const QString &name, std::function<void()> job, const Intervals &intervals)
+{
+    Job entry;
+    entry.stats.name = name;
+    entry.run = job;
+    entry.intervals = intervals;
+    int interval = intervals[m_state];
+    if ( interval > 0 )
+        entry.due = m_clock.elapsed() + interval;
+    m_jobs.append(entry);
+    reschedule();
+    return m_jobs.size() - 1;
+}
+
+/* Runs only when asked with runJobIn() */
+int TickScheduler::addDeadlineJob(const QString &name, std::function<void()> job)
+{
+    return addJob(name, job, Intervals{});
+}
+
+void TickScheduler::runJobIn(int id, qint64 msec)
+{
+    if ( id < 0 || id >= m_jobs.size() )
+        return;
+    m_jobs[id].due = m_clock.elapsed() + qMax<qint64>(0, msec);
+    reschedule();
+}
+
+void TickScheduler::cancelJob(int id)
+{
+    if ( id < 0 || id >= m_jobs.size() )
+        return;
+    m_jobs[id].due = -1;
+    reschedule();
+}
+
+/* Periodic jobs move to interval of new state, deadlines are kept */
+void TickScheduler::setPowerState(PowerState state)
+{
+    if ( state == m_state )
+        return;
+    PowerState previous = m_state;
+    m_state = state;
+    qint64 now = m_clock.elapsed();
+    for (Job &job : m_jobs) {
+        int previousInterval = job.intervals[previous];
+        int interval = job.intervals[state];
+        if ( previousInterval == 0 && interval == 0 )
+            continue;
+        if ( interval == 0 )
+            job.due = -1;
+        else if ( job.due < 0 )
+            job.due = now + interval;
+        else
+            job.due = qMin(job.due, now + interval);
+    }
+    reschedule();
+}
+
+TickScheduler::PowerState TickScheduler::powerState() const
+{
+    return m_state;
+}
+
+int TickScheduler::jobCount() const
+{
+    return m_jobs.size();
+}
+
+const TickScheduler::JobStats &TickScheduler::stats(int id) const
+{
+    return m_jobs.at(id).stats;
+}
+
+quint64 TickScheduler::wakeups() const
+{
+    return m_wakeups;
+}
+
+void TickScheduler::logStats() const
+{
+    qDebug() << "Tick scheduler wakeups:" << m_wakeups << "state:" << m_state;
+    for (const Job &job : m_jobs) {
+        qint64 average = job.stats.runs ? job.stats.totalNsecs / qint64(job.stats.runs) : 0;
+        qDebug() << "  job" << job.stats.name << "runs:" << job.stats.runs
+                 << "avg us:" << average / 1000 << "max us:" << job.stats.maxNsecs / 1000;
+    }
+}
+
+void TickScheduler::wakeup()
+{
+    m_wakeups++;
+    m_inWakeup = true;
+    qint64 now = m_clock.elapsed();
+    for (int id=0; id < m_jobs.size(); id++) {
+        Job &job = m_jobs[id];
+        if ( job.due < 0 )
+            continue;
+        int interval = job.intervals[m_state];
+        /* Periodic jobs may run a bit early to share this wakeup, deadlines never */
+        qint64 slack = interval > 0 ? qMin<qint64>(interval / 4, TICK_COALESCE_WINDOW) : 0;
+        if ( job.due > now + slack )
+            continue;
+        job.due = interval > 0 ? now + interval : -1;
+        /* Copy, job may add jobs and move m_jobs storage */
+        std::function<void()> run = job.run;
+        QElapsedTimer duration;
+        duration.start();
+        run();
+        qint64 nsecs = duration.nsecsElapsed();
+        JobStats &stats = m_jobs[id].stats;
+        stats.runs++;
+        stats.totalNsecs += nsecs;
+        stats.maxNsecs = qMax(stats.maxNsecs, nsecs);
+    }
+    m_inWakeup = false;
+    reschedule();
+}
+
+/* Arm the single timer for earliest due job */
+void TickScheduler::reschedule()
+{
+    if ( m_inWakeup )
+        return;
+    qint64 next = -1;
+    for (const Job &job : m_jobs) {
+        if ( job.due >= 0 && (next < 0 || job.due < next) )
+            next = job.due;
+    }
+    if ( next < 0 ) {
+        m_timer->stop();
+        return;
+    }
+    m_timer->start(int(qMax<qint64>(0, next - m_clock.elapsed())));
+}
@@ -0,0 +1,92 @@
+/*  Small Pine phone QML interface for Out-Of-Band communication.
+
+    Copyright (C) 2023 Resilience Theatre
+
+    This program is free software; you can redistribute it and/or
+    modify it under the terms of the GNU General Public License
+    as published by the Free Software Foundation; either version 2
+    of the License, or (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; If not, see <http://www.gnu.org/licenses/>.
+
+*/
+#ifndef TICKSCHEDULER_H
+#define TICKSCHEDULER_H
+#include <QObject>
+#include <QTimer>
+#include <QElapsedTimer>
+#include <QVector>
+#include <array>
+#include <functional>
+
+#define TICK_COALESCE_WINDOW    1000    // ms, periodic jobs due this soon run in same wakeup
+
+/*
+    Owner of all periodic work. Periodic jobs have one interval per
+    power state (0 = not run in that state), deadline jobs run once
+    at time given with runJobIn(). A single coarse timer is armed for
+    the earliest due job and every job due within the coalesce window
+    runs in that wakeup.
+*/
+class TickScheduler : public QObject
+{
+    Q_OBJECT
+
+public:
+    enum PowerState {
+        POWER_LOCKED,       // screen off, deep sleep
+        POWER_IDLE,
+        POWER_IN_CALL,
+        POWER_SETTINGS,
+        POWER_STATE_COUNT
+    };
+    typedef std::array<int, POWER_STATE_COUNT> Intervals;
+
+    struct JobStats
+    {
+        QString name;
+        quint64 runs=0;
+        qint64 totalNsecs=0;
+        qint64 maxNsecs=0;
+    };
+
+    explicit TickScheduler(QObject *parent = nullptr);
+    int addJob(const QString &name, std::function<void()> job, const Intervals &intervals);
+    int addDeadlineJob(const QString &name, std::function<void()> job);
+    void runJobIn(int id, qint64 msec);
+    void cancelJob(int id);
+    void setPowerState(PowerState state);
+    PowerState powerState() const;
+    int jobCount() const;
+    const JobStats &stats(int id) const;
+    quint64 wakeups() const;
+    void logStats() const;
+
+private slots:
+    void wakeup();
+
+private:
+    struct Job
+    {
+        JobStats stats;
+        std::function<void()> run;
+        Intervals intervals{};
+        qint64 due=-1;      // ms on m_clock, -1 when not scheduled
+    };
+    void reschedule();
+
+    QVector<Job> m_jobs;
+    QTimer *m_timer;
+    QElapsedTimer m_clock;
+    PowerState m_state=POWER_IDLE;
+    quint64 m_wakeups=0;
+    bool m_inWakeup=false;
+};
+
+#endif // TICKSCHEDULER_H
@@ -0,0 +1,198 @@
+/*
+    small Pinephone QML interface for Out-Of-Band communication.
+
+    Copyright (C) 2023 Resilience Theatre
+
+    This program is free software; you can redistribute it and/or
+    modify it under the terms of the GNU General Public License
+    as published by the Free Software Foundation; either version 2
+    of the License, or (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "trace.h"
+
+#ifdef QTUI_TRACING
+
+#include <QFile>
+#include <QSet>
+#include <QVector>
+#include <QMutex>
+#include <QDebug>
+#include <QCoreApplication>
+#include <atomic>
+#include <pthread.h>
+#include <signal.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <errno.h>
+#include <sys/syscall.h>
+
+struct TraceEvent
+{
+    const char *name;
+    qint64 start;
+    qint64 duration;
+};
+
+/* Single writer (owner thread), dump reads without stopping it */
+struct TraceRing
+{
+    TraceEvent events[TRACE_RING_SIZE];
+    std::atomic<quint64> head{0};
+    long tid=0;
+    char threadName[16]={};
+};
+
+static std::atomic<TraceRing *> g_rings[TRACE_MAX_THREADS];
+static std::atomic<int> g_ringCount{0};
+static int g_signalPipe[2] = { -1, -1 };
+
+/* Rings are never freed, events of finished threads stay dumpable */
+static TraceRing *threadRing()
+{
+    thread_local TraceRing *ring = [] () -> TraceRing * {
+        int slot = g_ringCount.fetch_add(1);
+        if ( slot >= TRACE_MAX_THREADS )
+            return nullptr;
+        TraceRing *created = new TraceRing;
+        created->tid = syscall(SYS_gettid);
+        pthread_getname_np(pthread_self(), created->threadName, sizeof(created->threadName));
+        g_rings[slot].store(created, std::memory_order_release);
+        return created;
+    }();
+    return ring;
+}
+
+void Trace::record(const char *name, qint64 start, qint64 duration)
+{
+    TraceRing *ring = threadRing();
+    if ( !ring )
+        return;
+    quint64 head = ring->head.load(std::memory_order_relaxed);
+    ring->events[head & (TRACE_RING_SIZE - 1)] = { name, start, duration };
+    ring->head.store(head + 1, std::memory_order_release);
+}
+
+const char *Trace::intern(const QString &name)
+{
+    static QMutex mutex;
+    static QSet<QByteArray> names;
+    QMutexLocker locker(&mutex);
+    QByteArray utf8 = name.toUtf8();
+    auto it = names.constFind(utf8);
+    if ( it == names.constEnd() )
+        it = names.insert(utf8);
+    return it->constData();
+}
+
+static void appendJsonString(QByteArray &json, const char *text)
+{
+    json += '"';
+    for (const char *c = text; *c; c++) {
+        if ( *c == '"' || *c == '\\' )
+            json += '\\';
+        if ( uchar(*c) >= 0x20 )
+            json += *c;
+    }
+    json += '"';
+}
+
+/*
+    Events a writer overwrote while being copied are dropped, only
+    indexes still inside ring after copy are kept.
+*/
+bool Trace::writeChromeTrace(const QString &path)
+{
+    QByteArray json = "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[";
+    QByteArray pid = QByteArray::number(QCoreApplication::applicationPid());
+    bool first = true;
+    int rings = qMin(g_ringCount.load(), TRACE_MAX_THREADS);
+    for (int x=0; x < rings; x++) {
+        TraceRing *ring = g_rings[x].load(std::memory_order_acquire);
+        if ( !ring )
+            continue;
+        QByteArray tid = QByteArray::number(qlonglong(ring->tid));
+        json += QByteArray(first ? "" : ",") + "{\"ph\":\"M\",\"name\":\"thread_name\",\"pid\":" + pid
+                + ",\"tid\":" + tid + ",\"args\":{\"name\":";
+        appendJsonString(json, ring->threadName);
+        json += "}}";
+        first = false;
+        quint64 head = ring->head.load(std::memory_order_acquire);
+        quint64 tail = head > TRACE_RING_SIZE ? head - TRACE_RING_SIZE : 0;
+        QVector<TraceEvent> events;
+        events.reserve(int(head - tail));
+        for (quint64 index = tail; index < head; index++)
+            events.append(ring->events[index & (TRACE_RING_SIZE - 1)]);
+        quint64 after = ring->head.load(std::memory_order_acquire);
+        quint64 valid = after > TRACE_RING_SIZE ? after - TRACE_RING_SIZE : 0;
+        for (int e = valid > tail ? int(valid - tail) : 0; e < events.size(); e++) {
+            const TraceEvent &event = events.at(e);
+            json += ",{\"name\":";
+            appendJsonString(json, event.name);
+            json += ",\"pid\":" + pid + ",\"tid\":" + tid + ",\"ts\":" + QByteArray::number(event.start / 1e3, 'f', 3);
+            if ( event.duration < 0 )
+                json += ",\"ph\":\"i\",\"s\":\"t\"}";
+            else
+                json += ",\"ph\":\"X\",\"dur\":" + QByteArray::number(event.duration / 1e3, 'f', 3) + "}";
+        }
+    }
+    json += "]}\n";
+    QFile file(path);
+    if ( !file.open(QIODevice::WriteOnly | QIODevice::Truncate) || file.write(json) != json.size() ) {
+        qWarning() << "Cannot write trace" << path << file.errorString();
+        return false;
+    }
+    qDebug() << "Trace written to" << path;
+    return true;
+}
+
+static void traceSignalHandler(int)
+{
+    int savedErrno = errno;
+    char wake = 1;
+    ssize_t written = ::write(g_signalPipe[1], &wake, 1);  // full pipe, dump already pending
+    Q_UNUSED(written);
+    errno = savedErrno;
+}
+
+TraceDumper::TraceDumper(const QString &path) : m_path(path)
+{
+    if ( pipe2(g_signalPipe, O_CLOEXEC | O_NONBLOCK) < 0 ) {
+        qErrnoWarning(errno, "Cannot create trace signal pipe");
+        return;
+    }
+    m_notifier = new QSocketNotifier(g_signalPipe[0], QSocketNotifier::Read);
+    QObject::connect(m_notifier, QOverload<QSocketDescriptor, QSocketNotifier::Type>::of(&QSocketNotifier::activated),
+                     m_notifier, [this] {
+        char wake[16];
+        while ( ::read(g_signalPipe[0], wake, sizeof(wake)) > 0 ) {}
+        Trace::writeChromeTrace(m_path);
+    });
+    struct sigaction action = {};
+    action.sa_handler = traceSignalHandler;
+    action.sa_flags = SA_RESTART;
+    sigemptyset(&action.sa_mask);
+    if ( sigaction(SIGUSR1, &action, nullptr) < 0 )
+        qErrnoWarning(errno, "Cannot install trace signal handler");
+}
+
+TraceDumper::~TraceDumper()
+{
+    signal(SIGUSR1, SIG_DFL);
+    delete m_notifier;
+    if ( g_signalPipe[0] >= 0 ) {
+        ::close(g_signalPipe[0]);
+        ::close(g_signalPipe[1]);
+        g_signalPipe[0] = g_signalPipe[1] = -1;
+    }
+}
+
+#endif // QTUI_TRACING
@@ -0,0 +1,101 @@
+/*  Small Pine phone QML interface for Out-Of-Band communication.
+
+    Copyright (C) 2023 Resilience Theatre
+
+    This program is free software; you can redistribute it and/or
+    modify it under the terms of the GNU General Public License
+    as published by the Free Software Foundation; either version 2
+    of the License, or (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; If not, see <http://www.gnu.org/licenses/>.
+
+*/
+#ifndef TRACE_H
+#define TRACE_H
+#include <QtGlobal>
+
+/*
+    Hot path tracing, compiled in with qmake CONFIG+=tracing
+    (QTUI_TRACING). Spans go to a per-thread ring buffer without
+    locks or allocation, newest TRACE_RING_SIZE events are kept.
+    kill -USR1 <pid> writes Chrome trace JSON to TRACE_FILE_ENV or
+    TRACE_DEFAULT_FILE, open it in chrome://tracing or Perfetto UI.
+
+        TRACE_SCOPE("engine::fifoChanged");
+
+    Names must outlive the process (literals or Trace::intern()).
+    Without QTUI_TRACING all macros expand to nothing.
+*/
+
+#ifdef QTUI_TRACING
+
+#include <QString>
+#include <QSocketNotifier>
+#include <chrono>
+
+#define TRACE_RING_SIZE         16384   // events per thread, power of two
+#define TRACE_MAX_THREADS       32
+#define TRACE_FILE_ENV          "QTUI_TRACE_FILE"
+#define TRACE_DEFAULT_FILE      "/tmp/qtui-trace.json"
+
+namespace Trace
+{
+    inline qint64 now()
+    {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+                    std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+    /* duration -1 is instant event */
+    void record(const char *name, qint64 start, qint64 duration);
+    const char *intern(const QString &name);
+    bool writeChromeTrace(const QString &path);
+}
+
+class TraceSpan
+{
+public:
+    explicit TraceSpan(const char *name) : m_name(name), m_start(Trace::now()) {}
+    ~TraceSpan() { Trace::record(m_name, m_start, Trace::now() - m_start); }
+    TraceSpan(const TraceSpan &) = delete;
+    TraceSpan &operator=(const TraceSpan &) = delete;
+
+private:
+    const char *m_name;
+    qint64 m_start;
+};
+
+/* SIGUSR1 writes trace file, signal handler only wakes event loop */
+class TraceDumper
+{
+public:
+    explicit TraceDumper(const QString &path);
+    ~TraceDumper();
+
+private:
+    QString m_path;
+    QSocketNotifier *m_notifier=nullptr;
+};
+
+#define TRACE_CONCAT_(a, b)         a##b
+#define TRACE_CONCAT(a, b)          TRACE_CONCAT_(a, b)
+#define TRACE_SCOPE(name)           TraceSpan TRACE_CONCAT(traceSpan, __LINE__)(name)
+#define TRACE_INSTANT(name)         Trace::record(name, Trace::now(), -1)
+#define TRACE_NOW()                 Trace::now()
+#define TRACE_COMPLETE(name, start) Trace::record(name, start, Trace::now() - (start))
+
+#else
+
+#define TRACE_SCOPE(name)
+#define TRACE_INSTANT(name)
+#define TRACE_NOW()                 qint64(0)
+#define TRACE_COMPLETE(name, start)
+
+#endif // QTUI_TRACING
+
+#endif // TRACE_H
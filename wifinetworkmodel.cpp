@@ -0,0 +1,184 @@
+/*
+    small Pinephone QML interface for Out-Of-Band communication.
+
+    Copyright (C) 2023 Resilience Theatre
+
+    This program is free software; you can redistribute it and/or
+    modify it under the terms of the GNU General Public License
+    as published by the Free Software Foundation; either version 2
+    of the License, or (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "wifinetworkmodel.h"
+
+WifiNetworkModel::WifiNetworkModel(QObject *parent)
+    : QAbstractListModel{parent}
+{
+}
+
+int WifiNetworkModel::rowCount(const QModelIndex &parent) const
+{
+    if ( parent.isValid() )
+        return 0;
+    return m_networks.size();
+}
+
+QVariant WifiNetworkModel::data(const QModelIndex &index, int role) const
+{
+    if ( !index.isValid() || index.row() >= m_networks.size() )
+        return QVariant();
+    const Network &network = m_networks.at(index.row());
+    switch ( role ) {
+    case Qt::DisplayRole:
+    case SsidRole:
+        return network.ssid;
+    case StrengthRole:
+        return network.strength;
+    case SecurityRole:
+        return network.security;
+    case ConnectedRole:
+        return network.connected;
+    case KnownRole:
+        return network.known;
+    }
+    return QVariant();
+}
+
+QHash<int, QByteArray> WifiNetworkModel::roleNames() const
+{
+    QHash<int, QByteArray> roles;
+    roles[SsidRole] = "ssid";
+    roles[StrengthRole] = "strength";
+    roles[SecurityRole] = "security";
+    roles[ConnectedRole] = "connected";
+    roles[KnownRole] = "known";
+    return roles;
+}
+
+int WifiNetworkModel::count() const
+{
+    return m_networks.size();
+}
+
+int WifiNetworkModel::indexOf(const QString &id) const
+{
+    for (int x=0; x < m_networks.size(); x++) {
+        if ( m_networks.at(x).id == id )
+            return x;
+    }
+    return -1;
+}
+
+int WifiNetworkModel::indexOfSsid(const QString &ssid) const
+{
+    for (int x=0; x < m_networks.size(); x++) {
+        if ( m_networks.at(x).ssid == ssid )
+            return x;
+    }
+    return -1;
+}
+
+const WifiNetworkModel::Network &WifiNetworkModel::network(int row) const
+{
+    return m_networks.at(row);
+}
+
+/* Insert new network at end or update changed roles of existing row */
+void WifiNetworkModel::update(const Network &network)
+{
+    int row = indexOf(network.id);
+    if ( row < 0 ) {
+        beginInsertRows(QModelIndex(), m_networks.size(), m_networks.size());
+        m_networks.append(network);
+        endInsertRows();
+        emit countChanged();
+        return;
+    }
+    QVector<int> roles;
+    Network &current = m_networks[row];
+    if ( current.ssid != network.ssid )
+        roles << SsidRole;
+    if ( current.strength != network.strength && network.strength >= 0 )
+        roles << StrengthRole;
+    if ( current.security != network.security )
+        roles << SecurityRole;
+    if ( current.connected != network.connected )
+        roles << ConnectedRole;
+    if ( current.known != network.known )
+        roles << KnownRole;
+    int strength = network.strength >= 0 ? network.strength : current.strength;
+    current = network;
+    current.strength = strength;
+    if ( !roles.isEmpty() )
+        notify(row, roles);
+}
+
+void WifiNetworkModel::setStrength(const QString &id, int strength)
+{
+    int row = indexOf(id);
+    if ( row < 0 || m_networks.at(row).strength == strength )
+        return;
+    m_networks[row].strength = strength;
+    notify(row, {StrengthRole});
+}
+
+void WifiNetworkModel::setConnected(const QString &id, bool connected)
+{
+    int row = indexOf(id);
+    if ( row < 0 || m_networks.at(row).connected == connected )
+        return;
+    m_networks[row].connected = connected;
+    notify(row, {ConnectedRole});
+}
+
+void WifiNetworkModel::remove(const QString &id)
+{
+    int row = indexOf(id);
+    if ( row < 0 )
+        return;
+    beginRemoveRows(QModelIndex(), row, row);
+    m_networks.remove(row);
+    endRemoveRows();
+    emit countChanged();
+}
+
+/* Script backend: only names are known, id is the SSID */
+void WifiNetworkModel::setSsidList(const QStringList &ssids)
+{
+    for (int x=m_networks.size() - 1; x >= 0; x--) {
+        if ( !ssids.contains(m_networks.at(x).id) )
+            remove(m_networks.at(x).id);
+    }
+    for (const QString &ssid : ssids) {
+        if ( ssid.isEmpty() || indexOf(ssid) >= 0 )
+            continue;
+        Network network;
+        network.id = ssid;
+        network.ssid = ssid;
+        update(network);
+    }
+}
+
+void WifiNetworkModel::clear()
+{
+    if ( m_networks.isEmpty() )
+        return;
+    beginResetModel();
+    m_networks.clear();
+    endResetModel();
+    emit countChanged();
+}
+
+void WifiNetworkModel::notify(int row, const QVector<int> &roles)
+{
+    QModelIndex changed = index(row);
+    emit dataChanged(changed, changed, roles);
+}
@@ -0,0 +1,79 @@
+/*  Small Pine phone QML interface for Out-Of-Band communication.
+
+    Copyright (C) 2023 Resilience Theatre
+
+    This program is free software; you can redistribute it and/or
+    modify it under the terms of the GNU General Public License
+    as published by the Free Software Foundation; either version 2
+    of the License, or (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; If not, see <http://www.gnu.org/licenses/>.
+
+*/
+#ifndef WIFINETWORKMODEL_H
+#define WIFINETWORKMODEL_H
+#include <QAbstractListModel>
+#include <QVector>
+
+/*
+    Wi-Fi networks seen by last scans. Rows are keyed by network
+    id (iwd object path), updates touch only changed roles and rows
+    are inserted or removed one by one, so an open ComboBox keeps
+    its selection while results stream in.
+*/
+class WifiNetworkModel : public QAbstractListModel
+{
+    Q_OBJECT
+    Q_PROPERTY(int count READ count NOTIFY countChanged)
+
+public:
+    enum WifiNetworkRoles {
+        SsidRole = Qt::UserRole + 1,
+        StrengthRole,
+        SecurityRole,
+        ConnectedRole,
+        KnownRole
+    };
+
+    struct Network
+    {
+        QString id;
+        QString ssid;
+        int strength=-1;        // 0-100 %, -1 unknown
+        QString security;       // open, psk, 8021x, wep
+        bool connected=false;
+        bool known=false;
+    };
+
+    explicit WifiNetworkModel(QObject *parent = nullptr);
+    int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
+    QHash<int, QByteArray> roleNames() const override;
+
+    int count() const;
+    int indexOf(const QString &id) const;
+    int indexOfSsid(const QString &ssid) const;
+    const Network &network(int row) const;
+    void update(const Network &network);
+    void setStrength(const QString &id, int strength);
+    void setConnected(const QString &id, bool connected);
+    void remove(const QString &id);
+    void setSsidList(const QStringList &ssids);
+    void clear();
+
+signals:
+    void countChanged();
+
+private:
+    void notify(int row, const QVector<int> &roles);
+
+    QVector<Network> m_networks;
+};
+
+#endif // WIFINETWORKMODEL_H